@@ -79,6 +79,8 @@ my @ssh = ('ssh');
 
 my $term_init = 1;
 
+my $padding = 1;
+
 my $localhost = undef;
 
 my $ssh_pty = 1;
@@ -122,6 +124,9 @@ qq{Usage: $0 [options] [--] [user@]host [command...]
 
         --no-init            do not send terminal initialization string
 
+        --no-padding         do not pad datagrams to size buckets
+                                (saves bytes on trusted or metered links)
+
         --local              run mosh-server locally without using ssh
 
         --experimental-remote-ip=(local|remote|proxy)  select the method for
@@ -166,6 +171,7 @@ GetOptions( 'client=s' => \$client,
 	    'ssh=s' => sub { @ssh = shellwords($_[1]); },
 	    'ssh-pty!' => \$ssh_pty,
 	    'init!' => \$term_init,
+	    'padding!' => \$padding,
 	    'local' => \$localhost,
 	    'help' => \$help,
 	    'version' => \$version,
@@ -376,6 +382,11 @@ if ( $pid == 0 ) { # child
   }
   my @server = ( 'new' );
 
+  if ( !$padding ) {
+    # env assignment prefix survives both the local and the ssh shell
+    $server = 'MOSH_NO_PADDING=1 ' . $server;
+  }
+
   push @server, ( '-c', $colors );
 
   push @server, @bind_arguments;
@@ -412,6 +423,7 @@ if ( $pid == 0 ) { # child
 } else { # parent
   my ( $sship, $port, $key );
   my $bad_udp_port_warning = 0;
+  my $have_connect = 0;
   LINE: while ( <$pipe> ) {
     chomp;
     if ( m{^MOSH IP } ) {
@@ -428,6 +440,7 @@ if ( $pid == 0 ) { # child
       }
     } elsif ( m{^MOSH CONNECT } ) {
       if ( ( $port, $key ) = m{^MOSH CONNECT (\d+?) ([A-Za-z0-9/+]{22})\s*$} ) {
+	$have_connect = 1;
 	last LINE;
       } else {
 	die "Bad MOSH CONNECT string: $_\n";
@@ -439,8 +452,16 @@ if ( $pid == 0 ) { # child
       print "$_\n";
     }
   }
-  close $pipe;
-  waitpid $pid, 0;
+  if ( $have_connect ) {
+    # We have everything we need; don't serialize the client launch
+    # behind ssh's connection teardown.  The pipe closes on exec, and
+    # ignoring SIGCHLD lets the kernel reap ssh so the client does
+    # not inherit a zombie.
+    $SIG{ 'CHLD' } = 'IGNORE';
+  } else {
+    close $pipe;
+    waitpid $pid, 0;
+  }
 
   if ( not defined $ip ) {
     if ( defined $sship ) {
@@ -462,6 +483,7 @@ if ( $pid == 0 ) { # child
   $ENV{ 'MOSH_KEY' } = $key;
   $ENV{ 'MOSH_PREDICTION_DISPLAY' } = $predict;
   $ENV{ 'MOSH_NO_TERM_INIT' } = '1' if !$term_init;
+  $ENV{ 'MOSH_NO_PADDING' } = '1' if !$padding;
   exec {$client} ("$client", "-# @cmdline |", $ip, $port);
 }
 
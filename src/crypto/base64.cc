@@ -118,3 +118,198 @@ void base64_encode( const uint8_t *raw, const size_t raw_len,
   b64[2] = '=';
   b64[3] = '=';
 }
+
+size_t base64_encoded_length( size_t raw_len )
+{
+  return ( ( raw_len + 2 ) / 3 ) * 4;
+}
+
+/* Encode a group of 1-3 raw bytes into 4 output characters,
+   padding as necessary. */
+static void encode_group( const uint8_t *raw, size_t n, char *b64 )
+{
+  uint32_t bytes = raw[0] << 16;
+  if ( n > 1 ) {
+    bytes |= raw[1] << 8;
+  }
+  if ( n > 2 ) {
+    bytes |= raw[2];
+  }
+
+  b64[0] = table[(bytes >> 18) & 0x3f];
+  b64[1] = table[(bytes >> 12) & 0x3f];
+  b64[2] = ( n > 1 ) ? table[(bytes >> 6) & 0x3f] : '=';
+  b64[3] = ( n > 2 ) ? table[(bytes) & 0x3f] : '=';
+}
+
+/* Decode one four-character group.  Returns the number of raw bytes
+   written (1-3), or 0 on invalid input.  Sets *padded if the group
+   carried padding (and so must be the last one).  Rejects
+   non-canonical encodings whose discarded bits are nonzero. */
+static size_t decode_group( const char *b64, uint8_t *raw, bool *padded )
+{
+  unsigned char sixbit[4];
+  size_t n = 3;
+
+  sixbit[0] = base64_char_to_sixbit( b64[0] );
+  sixbit[1] = base64_char_to_sixbit( b64[1] );
+  if ( sixbit[0] > 0x3f || sixbit[1] > 0x3f ) {
+    return 0;
+  }
+
+  if ( b64[2] == '=' ) {
+    if ( b64[3] != '=' || ( sixbit[1] & 0x0f ) ) {
+      return 0;
+    }
+    sixbit[2] = sixbit[3] = 0;
+    n = 1;
+  } else {
+    sixbit[2] = base64_char_to_sixbit( b64[2] );
+    if ( sixbit[2] > 0x3f ) {
+      return 0;
+    }
+    if ( b64[3] == '=' ) {
+      if ( sixbit[2] & 0x03 ) {
+	return 0;
+      }
+      sixbit[3] = 0;
+      n = 2;
+    } else {
+      sixbit[3] = base64_char_to_sixbit( b64[3] );
+      if ( sixbit[3] > 0x3f ) {
+	return 0;
+      }
+    }
+  }
+
+  uint32_t bytes = ( sixbit[0] << 18 ) | ( sixbit[1] << 12 )
+    | ( sixbit[2] << 6 ) | sixbit[3];
+  raw[0] = bytes >> 16;
+  if ( n > 1 ) {
+    raw[1] = bytes >> 8;
+  }
+  if ( n > 2 ) {
+    raw[2] = bytes;
+  }
+
+  *padded = ( n < 3 );
+  return n;
+}
+
+void base64_encode_bulk( const uint8_t *raw, const size_t raw_len,
+			 char *b64, const size_t b64_len )
+{
+  fatal_assert( b64_len >= base64_encoded_length( raw_len ) );
+
+  size_t remaining = raw_len;
+  while ( remaining >= 3 ) {
+    encode_group( raw, 3, b64 );
+    raw += 3;
+    b64 += 4;
+    remaining -= 3;
+  }
+
+  if ( remaining ) {
+    encode_group( raw, remaining, b64 );
+  }
+}
+
+bool base64_decode_bulk( const char *b64, const size_t b64_len,
+			 uint8_t *raw, size_t *raw_len )
+{
+  if ( b64_len % 4 ) {
+    return false;
+  }
+
+  const size_t capacity = *raw_len;
+  size_t written = 0;
+
+  for ( size_t offset = 0; offset < b64_len; offset += 4 ) {
+    uint8_t group[3];
+    bool padded = false;
+    size_t n = decode_group( b64 + offset, group, &padded );
+    if ( n == 0
+	 || ( padded && ( offset + 4 != b64_len ) ) /* padding only at the end */
+	 || ( written + n > capacity ) ) {
+      return false;
+    }
+    memcpy( raw + written, group, n );
+    written += n;
+  }
+
+  *raw_len = written;
+  return true;
+}
+
+void Base64Encoder::encode( const uint8_t *raw, size_t raw_len, std::string &b64_out )
+{
+  char group[4];
+
+  /* complete a pending group first */
+  while ( pending_len && raw_len ) {
+    pending[ pending_len++ ] = *raw++;
+    raw_len--;
+    if ( pending_len == 3 ) {
+      encode_group( pending, 3, group );
+      b64_out.append( group, 4 );
+      pending_len = 0;
+    }
+  }
+
+  while ( raw_len >= 3 ) {
+    encode_group( raw, 3, group );
+    b64_out.append( group, 4 );
+    raw += 3;
+    raw_len -= 3;
+  }
+
+  while ( raw_len ) {
+    pending[ pending_len++ ] = *raw++;
+    raw_len--;
+  }
+}
+
+void Base64Encoder::finish( std::string &b64_out )
+{
+  if ( pending_len ) {
+    char group[4];
+    encode_group( pending, pending_len, group );
+    b64_out.append( group, 4 );
+    pending_len = 0;
+  }
+}
+
+bool Base64Decoder::decode( const char *b64, size_t b64_len, std::string &raw_out )
+{
+  if ( failed ) {
+    return false;
+  }
+
+  while ( b64_len ) {
+    if ( saw_padding ) { /* nothing may follow the padding */
+      failed = true;
+      return false;
+    }
+
+    pending[ pending_len++ ] = *b64++;
+    b64_len--;
+
+    if ( pending_len == 4 ) {
+      uint8_t group[3];
+      size_t n = decode_group( pending, group, &saw_padding );
+      if ( n == 0 ) {
+	failed = true;
+	return false;
+      }
+      raw_out.append( (const char *)group, n );
+      pending_len = 0;
+    }
+  }
+
+  return true;
+}
+
+bool Base64Decoder::finish( void )
+{
+  return !failed && ( pending_len == 0 );
+}
@@ -31,9 +31,52 @@
 */
 
 #include <stdint.h>
+#include <stddef.h>
+#include <string>
 
+/* Fixed-size variants for Mosh keys; lengths are checked strictly. */
 bool base64_decode( const char *b64, const size_t b64_len,
 		    uint8_t *raw, size_t *raw_len );
 
 void base64_encode( const uint8_t *raw, const size_t raw_len,
 		    char *b64, const size_t b64_len );
+
+/* Bulk variants for arbitrary lengths (state export, packet logging).
+   Validation stays strict: only canonical encodings are accepted. */
+size_t base64_encoded_length( size_t raw_len );
+
+void base64_encode_bulk( const uint8_t *raw, const size_t raw_len,
+			 char *b64, const size_t b64_len );
+
+/* On success, *raw_len holds the number of bytes written (the caller
+   passes the capacity in).  Returns false on any non-canonical input
+   or if the output would not fit. */
+bool base64_decode_bulk( const char *b64, const size_t b64_len,
+			 uint8_t *raw, size_t *raw_len );
+
+/* Streaming interfaces: feed data in arbitrary-sized pieces. */
+class Base64Encoder {
+private:
+  uint8_t pending[ 3 ];
+  size_t pending_len;
+
+public:
+  Base64Encoder() : pending(), pending_len( 0 ) {}
+
+  void encode( const uint8_t *raw, size_t raw_len, std::string &b64_out );
+  void finish( std::string &b64_out ); /* emit the final group and padding */
+};
+
+class Base64Decoder {
+private:
+  char pending[ 4 ];
+  size_t pending_len;
+  bool saw_padding;
+  bool failed;
+
+public:
+  Base64Decoder() : pending(), pending_len( 0 ), saw_padding( false ), failed( false ) {}
+
+  bool decode( const char *b64, size_t b64_len, std::string &raw_out );
+  bool finish( void ); /* true iff the stream ended on a group boundary */
+};
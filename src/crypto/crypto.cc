@@ -41,6 +41,8 @@
 #include "byteorder.h"
 #include "crypto.h"
 #include "base64.h"
+#include "allocstats.h"
+#include "latencystats.h"
 #include "fatal_assert.h"
 #include "prng.h"
 
@@ -61,16 +63,24 @@ long int myatoi( const char *str )
   return ret;
 }
 
+static uint64_t unique_counter = 0;
+
 uint64_t Crypto::unique( void )
 {
-  static uint64_t counter = 0;
-  uint64_t rv = counter++;
-  if ( counter == 0 ) {
+  uint64_t rv = unique_counter++;
+  if ( unique_counter == 0 ) {
     throw CryptoException( "Counter wrapped", true );
   }
   return rv;
 }
 
+void Crypto::set_unique_minimum( uint64_t minimum )
+{
+  if ( unique_counter < minimum ) {
+    unique_counter = minimum;
+  }
+}
+
 AlignedBuffer::AlignedBuffer( size_t len, const char *data )
   : m_len( len ), m_allocated( NULL ), m_data( NULL )
 {
@@ -156,20 +166,83 @@ string Base64Key::printable_key( void ) const
 }
 
 Session::Session( Base64Key s_key )
-  : key( s_key ), ctx_buf( ae_ctx_sizeof() ),
-    ctx( (ae_ctx *)ctx_buf.data() ), blocks_encrypted( 0 ),
+  : key( s_key ),
+    master_ctx_buf( ae_ctx_sizeof() ),
+    master_ctx( (ae_ctx *)master_ctx_buf.data() ),
+    ctx_buf( ae_ctx_sizeof() ),
+    ctx( (ae_ctx *)ctx_buf.data() ),
+    ctx_epoch( 0 ),
+    ctx2_buf( ae_ctx_sizeof() ),
+    ctx2( (ae_ctx *)ctx2_buf.data() ),
+    ctx2_epoch( 0 ),
+    ctx2_valid( false ),
+    blocks_encrypted( 0 ),
+    send_epoch( 0 ),
     plaintext_buffer( RECEIVE_MTU ),
     ciphertext_buffer( RECEIVE_MTU ),
-    nonce_buffer( Nonce::NONCE_LEN )
+    nonce_buffer( Nonce::NONCE_LEN ),
+    wire_buffer()
 {
-  if ( AE_SUCCESS != ae_init( ctx, key.data(), 16, 12, 16 ) ) {
+  if ( AE_SUCCESS != ae_init( master_ctx, key.data(), 16, 12, 16 ) ) {
     throw CryptoException( "Could not initialize AES-OCB context." );
   }
+  init_epoch( 0, ctx );
 }
 
 Session::~Session()
 {
+  fatal_assert( ae_clear( master_ctx ) == AE_SUCCESS );
   fatal_assert( ae_clear( ctx ) == AE_SUCCESS );
+  if ( ctx2_valid ) {
+    fatal_assert( ae_clear( ctx2 ) == AE_SUCCESS );
+  }
+}
+
+/* An epoch's key is the master OCB encryption of a zero block under a
+   nonce carrying the epoch number -- a single-block PRF that both
+   sides compute identically.  Uses the session scratch buffers, so
+   call before they hold anything. */
+void Session::init_epoch( uint64_t epoch, ae_ctx *target )
+{
+  Nonce nonce( epoch );
+  memcpy( nonce_buffer.data(), nonce.data(), Nonce::NONCE_LEN );
+  memset( plaintext_buffer.data(), 0, 16 );
+
+  if ( 32 != ae_encrypt( master_ctx, nonce_buffer.data(),
+			 plaintext_buffer.data(), 16,
+			 NULL, 0,
+			 ciphertext_buffer.data(), NULL, AE_FINALIZE ) ) {
+    throw CryptoException( "Could not derive epoch key." );
+  }
+
+  if ( AE_SUCCESS != ae_init( target, ciphertext_buffer.data(), 16, 12, 16 ) ) {
+    throw CryptoException( "Could not initialize AES-OCB context." );
+  }
+}
+
+ae_ctx *Session::ctx_for_epoch( uint64_t epoch )
+{
+  if ( epoch == ctx_epoch ) {
+    return ctx;
+  }
+  if ( ctx2_valid && ( epoch == ctx2_epoch ) ) {
+    return ctx2;
+  }
+
+  /* Derive into the slot holding the older epoch, which keeps the
+     newest key and its neighbor live through the handover window.
+     (A forged sequence number can evict a live slot; the next
+     genuine packet just re-derives it.) */
+  if ( !ctx2_valid || ( ctx2_epoch < ctx_epoch ) ) {
+    init_epoch( epoch, ctx2 );
+    ctx2_epoch = epoch;
+    ctx2_valid = true;
+    return ctx2;
+  }
+
+  init_epoch( epoch, ctx );
+  ctx_epoch = epoch;
+  return ctx;
 }
 
 Nonce::Nonce( uint64_t val )
@@ -199,16 +272,44 @@ Nonce::Nonce( const char *s_bytes, size_t len )
 
 const string Session::encrypt( const Message & plaintext )
 {
-  const size_t pt_len = plaintext.text.size();
+  Span span( plaintext.text.data(), plaintext.text.size() );
+  return encrypt( plaintext.nonce, &span, 1 );
+}
+
+const string & Session::encrypt( const Nonce & nonce, const Span *spans, size_t num_spans )
+{
+  const LatencyStats::StageTimer timer( LatencyStats::STAGE_ENCRYPT );
+  const AllocStats::ScopeTag tag( AllocStats::SUBSYS_CRYPTO );
+
+  /* select the epoch key before the scratch buffers are filled;
+     deriving a fresh one would scribble on them */
+  const uint64_t epoch = epoch_of( nonce.val() );
+  ae_ctx *ectx = ctx_for_epoch( epoch );
+  if ( epoch != send_epoch ) {
+    /* the OCB block budget is per key; a new epoch starts a new count */
+    send_epoch = epoch;
+    blocks_encrypted = 0;
+  }
+
+  size_t pt_len = 0;
+  for ( size_t i = 0; i < num_spans; i++ ) {
+    pt_len += spans[ i ].len;
+  }
   const int ciphertext_len = pt_len + 16;
 
   assert( (size_t)ciphertext_len <= ciphertext_buffer.len() );
   assert( pt_len <= plaintext_buffer.len() );
 
-  memcpy( plaintext_buffer.data(), plaintext.text.data(), pt_len );
-  memcpy( nonce_buffer.data(), plaintext.nonce.data(), Nonce::NONCE_LEN );
+  /* gather the plaintext pieces; callers avoid concatenating them
+     into an intermediate string */
+  size_t offset = 0;
+  for ( size_t i = 0; i < num_spans; i++ ) {
+    memcpy( plaintext_buffer.data() + offset, spans[ i ].data, spans[ i ].len );
+    offset += spans[ i ].len;
+  }
+  memcpy( nonce_buffer.data(), nonce.data(), Nonce::NONCE_LEN );
 
-  if ( ciphertext_len != ae_encrypt( ctx,                                     /* ctx */
+  if ( ciphertext_len != ae_encrypt( ectx,                                    /* ctx */
 				     nonce_buffer.data(),                     /* nonce */
 				     plaintext_buffer.data(),                 /* pt */
 				     pt_len,                                  /* pt_len */
@@ -234,21 +335,32 @@ const string Session::encrypt( const Message & plaintext )
 
      -- http://tools.ietf.org/html/draft-krovetz-ocb-03
 
-     We deem it unlikely that a legitimate user will send 4 PB through a Mosh
-     session.  If it happens, we simply kill the session.  The server and
-     client use the same key, so we actually need to die after 2^47 blocks.
+     Epoch rekeying keeps each key far below this bound: an epoch spans
+     2^EPOCH_SHIFT sequence numbers, and each datagram is at most
+     RECEIVE_MTU bytes, so a session rolls to a fresh key long before
+     the budget matters and can run indefinitely.  The check stays as a
+     backstop (the server and client share each epoch key, hence 2^47).
   */
   if ( blocks_encrypted >> 47 ) {
     throw CryptoException( "Encrypted 2^47 blocks.", true );
   }
 
-  string text( ciphertext_buffer.data(), ciphertext_len );
+  /* frame the result in the session's reusable buffer */
+  wire_buffer.clear();
+  wire_buffer.reserve( 8 + ciphertext_len );
+  wire_buffer.append( nonce.data() + 4, 8 );
+  wire_buffer.append( ciphertext_buffer.data(), ciphertext_len );
 
-  return plaintext.nonce.cc_str() + text;
+  return wire_buffer;
 }
 
-const Message Session::decrypt( const char *str, size_t len )
+/* Decrypt and authenticate into plaintext_buffer; returns the
+   plaintext length. */
+size_t Session::decrypt_core( const char *str, size_t len )
 {
+  const LatencyStats::StageTimer timer( LatencyStats::STAGE_DECRYPT );
+  const AllocStats::ScopeTag tag( AllocStats::SUBSYS_CRYPTO );
+
   if ( len < 24 ) {
     throw CryptoException( "Ciphertext must contain nonce and tag." );
   }
@@ -261,14 +373,26 @@ const Message Session::decrypt( const char *str, size_t len )
     exit( 1 );
   }
 
-  assert( (size_t)body_len <= ciphertext_buffer.len() );
-  assert( (size_t)pt_len <= plaintext_buffer.len() );
+  /* A larger-than-MTU ciphertext cannot be genuine -- the sender never
+     produces one -- and would overrun the fixed scratch buffers below.
+     Reachable by a hostile datagram in UDP_GRO builds, where the
+     receive buffer is sized for a coalesced burst rather than for one
+     datagram; drop it like any other forgery, before any copy. */
+  if ( ( (size_t)body_len > ciphertext_buffer.len() )
+       || ( (size_t)pt_len > plaintext_buffer.len() ) ) {
+    throw CryptoException( "Ciphertext too long." );
+  }
 
   Nonce nonce( str, 8 );
+
+  /* the sender's nonce names its epoch; derive (if necessary) before
+     filling the scratch buffers */
+  ae_ctx *dctx = ctx_for_epoch( epoch_of( nonce.val() ) );
+
   memcpy( ciphertext_buffer.data(), str + 8, body_len );
   memcpy( nonce_buffer.data(), nonce.data(), Nonce::NONCE_LEN );
 
-  if ( pt_len != ae_decrypt( ctx,                      /* ctx */
+  if ( pt_len != ae_decrypt( dctx,                     /* ctx */
 			     nonce_buffer.data(),      /* nonce */
 			     ciphertext_buffer.data(), /* ct */
 			     body_len,                 /* ct_len */
@@ -280,9 +404,23 @@ const Message Session::decrypt( const char *str, size_t len )
     throw CryptoException( "Packet failed integrity check." );
   }
 
-  const Message ret( nonce, string( plaintext_buffer.data(), pt_len ) );
+  return pt_len;
+}
 
-  return ret;
+const Message Session::decrypt( const char *str, size_t len )
+{
+  size_t pt_len = decrypt_core( str, len );
+
+  return Message( Nonce( str, 8 ), string( plaintext_buffer.data(), pt_len ) );
+}
+
+const Span Session::decrypt_view( const char *str, size_t len, uint64_t &nonce_val )
+{
+  size_t pt_len = decrypt_core( str, len );
+
+  nonce_val = Nonce( str, 8 ).val();
+
+  return Span( plaintext_buffer.data(), pt_len );
 }
 
 static rlim_t saved_core_rlimit;
@@ -65,6 +65,10 @@ namespace Crypto {
    */
   uint64_t unique( void );
 
+  /* Fast-forward the sequence counter, so a restored session never
+     reuses a nonce issued by its previous incarnation. */
+  void set_unique_minimum( uint64_t minimum );
+
   /* 16-byte-aligned buffer, with length. */
   class AlignedBuffer {
   private:
@@ -116,6 +120,17 @@ namespace Crypto {
     uint64_t val( void ) const;
   };
   
+  /* a (pointer, length) view of plaintext that lives elsewhere;
+     encrypt() gathers spans straight into its aligned buffer */
+  class Span {
+  public:
+    const char *data;
+    size_t len;
+
+    Span( const char *s_data, size_t s_len )
+      : data( s_data ), len( s_len ) {}
+  };
+
   class Message {
   public:
     const Nonce nonce;
@@ -134,16 +149,52 @@ namespace Crypto {
   class Session {
   private:
     Base64Key key;
+
+    /* In-band rekeying: the master key never encrypts data itself;
+       it only derives epoch keys.  The sequence number's high bits
+       (below the direction bit) name the epoch, so every side rolls
+       to the next derived key every 2^EPOCH_SHIFT datagrams and the
+       receiver follows from the nonce alone -- no signaling, no
+       round trips, no dropped packets. */
+    static const int EPOCH_SHIFT = 28;
+    static uint64_t epoch_of( uint64_t nonce_val )
+    {
+      return ( nonce_val & ( uint64_t( -1 ) >> 1 ) ) >> EPOCH_SHIFT;
+    }
+
+    AlignedBuffer master_ctx_buf;
+    ae_ctx *master_ctx; /* derives epoch keys; never touches data */
+
+    /* Two live epoch contexts, so the current epoch and its neighbor
+       both decrypt during the handover window. */
     AlignedBuffer ctx_buf;
     ae_ctx *ctx;
-    uint64_t blocks_encrypted;
+    uint64_t ctx_epoch;
+    AlignedBuffer ctx2_buf;
+    ae_ctx *ctx2;
+    uint64_t ctx2_epoch;
+    bool ctx2_valid;
+
+    uint64_t blocks_encrypted; /* under the current send epoch */
+    uint64_t send_epoch;
 
     AlignedBuffer plaintext_buffer;
     AlignedBuffer ciphertext_buffer;
     AlignedBuffer nonce_buffer;
-    
+
+    /* reused for the framed (nonce + ciphertext) result of encrypt();
+       its capacity persists, so steady-state sends don't allocate */
+    string wire_buffer;
+
+    void init_epoch( uint64_t epoch, ae_ctx *target );
+    ae_ctx *ctx_for_epoch( uint64_t epoch );
+
+    size_t decrypt_core( const char *str, size_t len );
+
   public:
-    static const int RECEIVE_MTU = 2048;
+    /* Sized for jumbo-frame datagrams, which path MTU probing may
+       discover; also bounds the encryption scratch buffers. */
+    static const int RECEIVE_MTU = 9216;
     /* Overhead (not counting the nonce, which is handled by network transport) */
     static const int ADDED_BYTES = 16 /* final OCB block */;
 
@@ -151,10 +202,17 @@ namespace Crypto {
     ~Session();
     
     const string encrypt( const Message & plaintext );
+    /* Returns a view of the session's wire buffer, valid until the
+       next encrypt() call. */
+    const string & encrypt( const Nonce & nonce, const Span *spans, size_t num_spans );
     const Message decrypt( const char *str, size_t len );
     const Message decrypt( const string & ciphertext ) {
       return decrypt( ciphertext.data(), ciphertext.size() );
     }
+    /* Decrypt into the session's scratch buffer and return a view of
+       the plaintext, valid until the next encrypt() or decrypt().
+       Saves the owning-string copy on the per-datagram path. */
+    const Span decrypt_view( const char *str, size_t len, uint64_t &nonce_val );
     
     Session( const Session & );
     Session & operator=( const Session & );
@@ -432,6 +432,8 @@ static void encrypt(const unsigned char *in, unsigned char *out, KEY *key) {
 	fatal_assert(total_len == BLOCK_SIZE);
 }
 
+#if 0
+/* unused */
 static void decrypt(const unsigned char *in, unsigned char *out, KEY *key) {
 	// See notes in encrypt about EncryptInit and EncryptFinal; the same
 	// notes apply to DecryptInit and DecryptFinal here.
@@ -451,25 +453,61 @@ static void decrypt(const unsigned char *in, unsigned char *out, KEY *key) {
 	total_len += len;
 	fatal_assert(total_len == BLOCK_SIZE);
 }
+#endif
 
 /* How to ECB encrypt an array of blocks, in place                         */
 static void ecb_encrypt_blks(block *blks, unsigned nblks, KEY *key) {
-	while (nblks) {
-		--nblks;
-		encrypt(reinterpret_cast<unsigned char *>(blks+nblks), reinterpret_cast<unsigned char *>(blks+nblks), key);
+	// Hand the whole batch to OpenSSL in one EVP call. Its ECB code
+	// keeps several independent blocks in the hardware AES pipeline
+	// (dispatching on CPU capabilities at runtime), which a
+	// block-at-a-time loop can never do--and it skips the per-block
+	// EVP setup and finalization overhead besides.
+	if (EVP_EncryptInit_ex(key, /*type=*/NULL, /*impl=*/NULL, /*key=*/NULL, /*iv=*/NULL) != 1) {
+		throw Crypto::CryptoException("Could not start AES encryption operation.");
+	}
+
+	unsigned char *data = reinterpret_cast<unsigned char *>(blks);
+	const int data_len = nblks * BLOCK_SIZE;
+
+	int len;
+	if (EVP_EncryptUpdate(key, data, &len, data, data_len) != 1) {
+		throw Crypto::CryptoException("Could not AES-encrypt blocks.");
 	}
+
+	int total_len = len;
+	if (EVP_EncryptFinal_ex(key, data + total_len, &len) != 1) {
+		throw Crypto::CryptoException("Could not finish AES encryption operation.");
+	}
+	total_len += len;
+	fatal_assert(total_len == data_len);
 }
 
 static void ecb_decrypt_blks(block *blks, unsigned nblks, KEY *key) {
-	while (nblks) {
-		--nblks;
-		decrypt(reinterpret_cast<unsigned char *>(blks+nblks), reinterpret_cast<unsigned char *>(blks+nblks), key);
+	// See notes in ecb_encrypt_blks; the same notes apply here.
+	if (EVP_DecryptInit_ex(key, /*type=*/NULL, /*impl=*/NULL, /*key=*/NULL, /*iv=*/NULL) != 1) {
+		throw Crypto::CryptoException("Could not start AES decryption operation.");
 	}
+
+	unsigned char *data = reinterpret_cast<unsigned char *>(blks);
+	const int data_len = nblks * BLOCK_SIZE;
+
+	int len;
+	if (EVP_DecryptUpdate(key, data, &len, data, data_len) != 1) {
+		throw Crypto::CryptoException("Could not AES-decrypt blocks.");
+	}
+
+	int total_len = len;
+	if (EVP_DecryptFinal_ex(key, data + total_len, &len) != 1) {
+		throw Crypto::CryptoException("Could not finish AES decryption operation.");
+	}
+	total_len += len;
+	fatal_assert(total_len == data_len);
 }
 
 }  // namespace ocb_aes
 
-#define BPI 4  /* Number of blocks in buffer per ECB call */
+#define BPI 8  /* Number of blocks in buffer per ECB call; eight keeps a
+                  hardware AES pipeline full */
 
 /*-------------------*/
 #elif USE_APPLE_COMMON_CRYPTO_AES
@@ -684,6 +722,18 @@ int ae_clear (ae_ctx *ctx) /* Zero ae_ctx and undo initialization          */
 
 int ae_ctx_sizeof(void) { return (int) sizeof(ae_ctx); }
 
+const char *ae_implementation(void) {
+#if USE_OPENSSL_AES
+	return "internal-ocb/openssl-aes";
+#elif USE_APPLE_COMMON_CRYPTO_AES
+	return "internal-ocb/apple-common-crypto-aes";
+#elif USE_NETTLE_AES
+	return "internal-ocb/nettle-aes";
+#else
+	return "internal-ocb";
+#endif
+}
+
 /* ----------------------------------------------------------------------- */
 
 int ae_init(ae_ctx *ctx, const void *key, int key_len, int nonce_len, int tag_len)
@@ -22,6 +22,10 @@ int ae_ctx_sizeof() {
   return sizeof(_ae_ctx);
 }
 
+const char *ae_implementation() {
+  return "openssl-ocb";
+}
+
 // If direction is 1, initializes encryption. If 0, initializes
 // decryption. See the documentation of EVP_CipherInit_ex
 static int ae_evp_cipher_init(EVP_CIPHER_CTX **in_ctx, int direction,
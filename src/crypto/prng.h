@@ -35,13 +35,16 @@
 
 #include <string>
 #include <stdint.h>
+#include <string.h>
 #include <fstream>
 
 #include "crypto.h"
 
 /* Read random bytes from /dev/urandom.
 
-   We rely on stdio buffering for efficiency. */
+   The device is consulted a page at a time and small requests are
+   served from the buffer, so per-packet chaff and nonce generation
+   don't each cost a syscall. */
 
 static const char rdev[] = "/dev/urandom";
 
@@ -49,24 +52,47 @@ using namespace Crypto;
 
 class PRNG {
  private:
+  static const size_t BUFFER_SIZE = 4096;
+
   std::ifstream randfile;
+  char buffer[ BUFFER_SIZE ];
+  size_t next; /* index of first unused byte in buffer */
+
+  void refill( void ) {
+    randfile.read( buffer, BUFFER_SIZE );
+    if ( !randfile ) {
+      throw CryptoException( "Could not read from " + std::string( rdev ) );
+    }
+    next = 0;
+  }
 
   /* unimplemented to satisfy -Weffc++ */
   PRNG( const PRNG & );
   PRNG & operator=( const PRNG & );
 
  public:
-  PRNG() : randfile( rdev, std::ifstream::in | std::ifstream::binary ) {}
+  PRNG() : randfile( rdev, std::ifstream::in | std::ifstream::binary ),
+	   buffer(), next( BUFFER_SIZE ) {}
 
   void fill( void *dest, size_t size ) {
     if ( 0 == size ) {
       return;
     }
 
-    randfile.read( static_cast<char *>( dest ), size );
-    if ( !randfile ) {
-      throw CryptoException( "Could not read from " + std::string( rdev ) );
+    if ( size > BUFFER_SIZE ) { /* bypass the buffer for bulk requests */
+      randfile.read( static_cast<char *>( dest ), size );
+      if ( !randfile ) {
+	throw CryptoException( "Could not read from " + std::string( rdev ) );
+      }
+      return;
     }
+
+    if ( size > BUFFER_SIZE - next ) {
+      refill(); /* the unused tail is discarded */
+    }
+
+    memcpy( dest, buffer + next, size );
+    next += size;
   }
 
   uint8_t uint8() {
@@ -58,11 +58,121 @@
 #include "terminaloverlay.h"
 #include "locale_utils.h"
 #include "fatal_assert.h"
+#include "latencystats.h"
 
 const int ITERATIONS = 100000;
+const size_t CORPUS_SIZE = 4 * 1024 * 1024;
 
 using namespace Terminal;
 
+/* Synthetic stand-ins for captured terminal streams, shaped like the
+   traffic mosh actually sees: full-screen editor redraws, pane
+   updates, scrolling build output, and multibyte-heavy logs. */
+
+static string vim_corpus( size_t target, int height )
+{
+  /* full-screen redraw per frame: cursor addressing, erase-to-end,
+     256-color syntax highlighting */
+  string s;
+  s.reserve( target + 4096 );
+  char line[ 256 ];
+  int top = 1;
+  while ( s.size() < target ) {
+    for ( int row = 0; row < height; row++ ) {
+      snprintf( line, sizeof line,
+		"\033[%d;1H\033[K\033[38;5;241m%4d\033[0m  \033[38;5;75mstatic\033[0m \033[38;5;179mint\033[0m count_%d = %d; \033[38;5;28m/* per-row state */\033[0m",
+		row + 1, top + row, row, top * ( row + 1 ) );
+      s += line;
+    }
+    top++;
+  }
+  return s;
+}
+
+static string tmux_corpus( size_t target, int width, int height )
+{
+  /* interleaved partial updates to two panes split by a vertical
+     line-drawing rule */
+  string s;
+  s.reserve( target + 4096 );
+  char span[ 256 ];
+  const int split = width / 2;
+  unsigned int n = 0;
+  while ( s.size() < target ) {
+    const int row = 1 + (int)( n % height );
+    snprintf( span, sizeof span,
+	      "\033[%d;1H\033[38;5;114mpane0 line %u: status ok\033[0m\033[%d;%dH\342\224\202\033[%d;%dH\033[7mpane1 %08x\033[0m",
+	      row, n, row, split, row, split + 2, n * 2654435761u );
+    s += span;
+    n++;
+  }
+  return s;
+}
+
+static string build_corpus( size_t target )
+{
+  /* plain scrolling compiler output with occasional color */
+  string s;
+  s.reserve( target + 4096 );
+  char line[ 256 ];
+  unsigned int n = 0;
+  while ( s.size() < target ) {
+    if ( n % 20 == 19 ) {
+      snprintf( line, sizeof line,
+		"\033[1;33mwarning\033[0m: unused variable `tmp_%u` in src/module_%u.cc:%u\r\n",
+		n, n % 37, 10 + n % 900 );
+    } else {
+      snprintf( line, sizeof line,
+		"   Compiling package-%u v1.%u.%u (/home/user/project/crates/package-%u)\r\n",
+		n % 61, n % 9, n % 23, n % 61 );
+    }
+    s += line;
+    n++;
+  }
+  return s;
+}
+
+static string utf8_corpus( size_t target )
+{
+  /* wide CJK, combining accents, and box drawing mixed with ASCII */
+  string s;
+  s.reserve( target + 4096 );
+  char line[ 512 ];
+  unsigned int n = 0;
+  while ( s.size() < target ) {
+    snprintf( line, sizeof line,
+	      "\342\224\214 \346\227\245\345\277\227 %u \342\224\220 r\303\251sum\303\251 cafe\314\201 \345\206\205\345\256\271\346\233\264\346\226\260\346\210\220\345\212\237 \342\224\224\342\224\200\342\224\200\342\224\230 status=\345\256\214\346\210\220\r\n",
+	      n );
+    s += line;
+    n++;
+  }
+  return s;
+}
+
+static void run_corpus( const char *name, const string &stream, int width, int height )
+{
+  Complete terminal( width, height );
+  Complete reference( width, height );
+  const size_t chunk = 16384; /* a few datagrams' worth per diff */
+
+  const uint64_t start_ns = LatencyStats::now_ns();
+  for ( size_t offset = 0; offset < stream.size(); offset += chunk ) {
+    terminal.act( stream.substr( offset, chunk ) );
+    const string diff( terminal.diff_from( reference ) );
+    if ( diff.size() > INT_MAX ) {
+      exit( 1 );
+    }
+    reference = terminal;
+  }
+  const uint64_t elapsed_ns = LatencyStats::now_ns() - start_ns;
+
+  const double secs = elapsed_ns / 1.e9;
+  printf( "%-10s %6.1f MB in %6.3f s = %7.1f MB/s, %6.1f ns/byte\n",
+	  name, stream.size() / 1048576., secs,
+	  stream.size() / 1048576. / secs,
+	  (double)elapsed_ns / stream.size() );
+}
+
 int main( int argc, char **argv )
 {
   try {
@@ -95,6 +205,14 @@ int main( int argc, char **argv )
     set_native_locale();
     fatal_assert( is_utf8_locale() );
 
+    /* emulation throughput: realistic byte streams through the full
+       parser + framebuffer + diff pipeline */
+    printf( "emulation throughput (%dx%d):\n", width, height );
+    run_corpus( "vim-scroll", vim_corpus( CORPUS_SIZE, height ), width, height );
+    run_corpus( "tmux-panes", tmux_corpus( CORPUS_SIZE, width, height ), width, height );
+    run_corpus( "build-log", build_corpus( CORPUS_SIZE ), width, height );
+    run_corpus( "utf8-log", utf8_corpus( CORPUS_SIZE ), width, height );
+
     for ( int i = 0; i < iterations; i++ ) {
       /* type a character */
       overlays.get_prediction_engine().new_user_byte( i + 'x', *local_framebuffer );
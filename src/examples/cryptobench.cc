@@ -0,0 +1,135 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+/* Micro-benchmark for the datagram crypto path: Session::encrypt() and
+   decrypt() across typical payload sizes (keystroke packets through
+   full fragments), plus Base64Key decode.  Output is tab-separated,
+   one measurement per line, so runs can be diffed mechanically across
+   releases and across AE backends (rebuild with a different
+   --with-crypto-library to compare). */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <exception>
+#include <string>
+
+#include "ae.h"
+#include "crypto.h"
+#include "fatal_assert.h"
+
+using namespace Crypto;
+using std::string;
+
+static double now_ns( void )
+{
+  struct timespec ts;
+  fatal_assert( clock_gettime( CLOCK_MONOTONIC, &ts ) == 0 );
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void report( const char *op, size_t bytes, long iterations, double total_ns )
+{
+  const double ns_per_op = total_ns / iterations;
+  const double mb_per_s = ( bytes && total_ns > 0 )
+    ? ( double( bytes ) * iterations ) / ( total_ns / 1e9 ) / 1e6
+    : 0.0;
+  printf( "%s\t%s\t%u\t%ld\t%.1f\t%.1f\n",
+	  ae_implementation(), op, (unsigned int)bytes, iterations,
+	  ns_per_op, mb_per_s );
+}
+
+int main( int argc, char **argv )
+{
+  long iterations = 100000;
+  if ( argc > 1 ) {
+    iterations = atol( argv[ 1 ] );
+    if ( iterations < 1 || iterations > 1000000000 ) {
+      fprintf( stderr, "bogus iteration count\n" );
+      exit( 1 );
+    }
+  }
+
+  try {
+    Base64Key key;
+    Session encryption_session( key );
+    Session decryption_session( key );
+
+    /* a 64-byte keystroke packet up through a full fragment */
+    const size_t payload_sizes[] = { 64, 128, 256, 512, 1024, 1400 };
+    const size_t num_sizes = sizeof( payload_sizes ) / sizeof( payload_sizes[ 0 ] );
+
+    /* keep the optimizer from discarding the crypto results */
+    size_t sink = 0;
+
+    uint64_t nonce_int = 1;
+
+    printf( "# backend\top\tbytes\titerations\tns_per_op\tMB_per_s\n" );
+
+    for ( size_t s = 0; s < num_sizes; s++ ) {
+      const size_t size = payload_sizes[ s ];
+      const string payload( size, 'x' );
+
+      double start = now_ns();
+      for ( long i = 0; i < iterations; i++ ) {
+	sink += encryption_session.encrypt( Message( Nonce( nonce_int++ ), payload ) ).size();
+      }
+      report( "encrypt", size, iterations, now_ns() - start );
+
+      const string ciphertext = encryption_session.encrypt( Message( Nonce( nonce_int++ ), payload ) );
+
+      start = now_ns();
+      for ( long i = 0; i < iterations; i++ ) {
+	sink += decryption_session.decrypt( ciphertext ).text.size();
+      }
+      report( "decrypt", size, iterations, now_ns() - start );
+    }
+
+    const string printable = key.printable_key();
+
+    double start = now_ns();
+    for ( long i = 0; i < iterations; i++ ) {
+      Base64Key decoded( printable );
+      sink += decoded.data()[ 0 ];
+    }
+    report( "base64key-decode", printable.size(), iterations, now_ns() - start );
+
+    printf( "# sink: %u\n", (unsigned int)sink );
+  } catch ( const std::exception &e ) {
+    fprintf( stderr, "error: %s\n", e.what() );
+    exit( 1 );
+  }
+
+  return 0;
+}
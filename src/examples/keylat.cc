@@ -0,0 +1,432 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+/* keylat: end-to-end keystroke latency benchmark.
+
+   Starts a real mosh-server (running `cat >/dev/null`, so the only
+   echo is the server pty's line discipline), runs a real mosh-client
+   inside a pty, types into the client, and times each keystroke until
+   the echoed character appears in the client's paint stream (escape
+   sequences are filtered out so a CSI final byte can't fake a match).
+   Predictive local echo is disabled for the measurement.
+
+     keylat [-n COUNT] [-i GAP_MS]
+	    [--delay=MS] [--jitter=MS] [--loss=PCT] [--rate=KBPS] [--seed=N]
+
+   Reports p50/p99/p99.9 keystroke-to-paint latency.  The link options
+   interpose the netsim relay from this directory, so transport
+   changes can be graded under reproducible degraded-network
+   conditions instead of with a photodiode on a monitor. */
+
+#include "config.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <libgen.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+#if HAVE_PTY_H
+#include <pty.h>
+#elif HAVE_UTIL_H
+#include <util.h>
+#endif
+
+#if FORKPTY_IN_LIBUTIL
+#include <libutil.h>
+#endif
+
+#include "fatal_assert.h"
+#include "pty_compat.h"
+
+static uint64_t now_us( void )
+{
+  struct timeval tv;
+  gettimeofday( &tv, NULL );
+  return uint64_t( tv.tv_sec ) * 1000000 + tv.tv_usec;
+}
+
+/* Strips terminal escape sequences from a byte stream so only
+   genuinely painted characters are compared against the expected
+   keystroke echo. */
+class EscapeFilter {
+private:
+  enum State { NORMAL, ESC, CSI, STRING, STRING_ESC } state;
+
+public:
+  EscapeFilter() : state( NORMAL ) {}
+
+  /* feed one byte; returns true if it is a painted literal */
+  bool feed( unsigned char c )
+  {
+    switch ( state ) {
+    case NORMAL:
+      if ( c == 0x1b ) {
+	state = ESC;
+	return false;
+      }
+      return ( c >= 0x20 ) && ( c != 0x7f );
+    case ESC:
+      if ( c == '[' ) {
+	state = CSI;
+      } else if ( ( c == ']' ) || ( c == 'P' ) || ( c == '^' ) || ( c == '_' ) ) {
+	state = STRING; /* OSC/DCS/PM/APC, terminated by BEL or ST */
+      } else {
+	state = NORMAL; /* two-byte escape */
+      }
+      return false;
+    case CSI:
+      if ( ( c >= 0x40 ) && ( c <= 0x7e ) ) {
+	state = NORMAL; /* final byte */
+      }
+      return false;
+    case STRING:
+      if ( c == 0x07 ) {
+	state = NORMAL;
+      } else if ( c == 0x1b ) {
+	state = STRING_ESC;
+      }
+      return false;
+    case STRING_ESC:
+      state = ( c == '\\' ) ? NORMAL : STRING;
+      return false;
+    }
+    return false;
+  }
+};
+
+/* read whatever is pending on fd within timeout_ms; -1 on EOF */
+static ssize_t read_some( int fd, char *buf, size_t len, int timeout_ms )
+{
+  struct pollfd pfd;
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+  int rc = poll( &pfd, 1, timeout_ms );
+  if ( rc <= 0 ) {
+    return 0; /* timeout (or EINTR: caller retries) */
+  }
+  ssize_t n = read( fd, buf, len );
+  if ( ( n == 0 ) || ( ( n < 0 ) && ( errno == EIO ) ) ) {
+    return -1; /* pty EOF */
+  }
+  return ( n < 0 ) ? 0 : n;
+}
+
+/* consume output until the stream has been quiet for quiet_ms */
+static void quiesce( int fd, EscapeFilter &filter, int quiet_ms )
+{
+  char buf[ 4096 ];
+  for ( ;; ) {
+    ssize_t n = read_some( fd, buf, sizeof( buf ), quiet_ms );
+    if ( n <= 0 ) {
+      return;
+    }
+    for ( ssize_t i = 0; i < n; i++ ) {
+      filter.feed( buf[ i ] );
+    }
+  }
+}
+
+static double percentile( const std::vector<double> &sorted, double frac )
+{
+  size_t idx = size_t( frac * sorted.size() );
+  if ( idx >= sorted.size() ) {
+    idx = sorted.size() - 1;
+  }
+  return sorted[ idx ];
+}
+
+static pid_t spawn( char *const argv[], int *out_fd )
+{
+  int pipefd[ 2 ] = { -1, -1 };
+  if ( out_fd && ( pipe( pipefd ) < 0 ) ) {
+    perror( "pipe" );
+    exit( 1 );
+  }
+  pid_t pid = fork();
+  if ( pid < 0 ) {
+    perror( "fork" );
+    exit( 1 );
+  }
+  if ( pid == 0 ) {
+    if ( out_fd ) {
+      dup2( pipefd[ 1 ], STDOUT_FILENO );
+      close( pipefd[ 0 ] );
+      close( pipefd[ 1 ] );
+    }
+    execvp( argv[ 0 ], argv );
+    perror( "execvp" );
+    exit( 1 );
+  }
+  if ( out_fd ) {
+    close( pipefd[ 1 ] );
+    *out_fd = pipefd[ 0 ];
+  }
+  return pid;
+}
+
+/* a free local UDP port for the netsim relay */
+static int free_udp_port( void )
+{
+  int sock = socket( AF_INET, SOCK_DGRAM, 0 );
+  fatal_assert( sock >= 0 );
+  struct sockaddr_in addr;
+  memset( &addr, 0, sizeof( addr ) );
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  fatal_assert( 0 == bind( sock, (struct sockaddr *)&addr, sizeof( addr ) ) );
+  socklen_t len = sizeof( addr );
+  fatal_assert( 0 == getsockname( sock, (struct sockaddr *)&addr, &len ) );
+  close( sock );
+  return ntohs( addr.sin_port );
+}
+
+static void usage( const char *argv0 )
+{
+  fprintf( stderr,
+	   "Usage: %s [-n COUNT] [-i GAP_MS] [--delay=MS] [--jitter=MS]\n"
+	   "          [--loss=PCT] [--rate=KBPS] [--seed=N]\n", argv0 );
+  exit( 1 );
+}
+
+int main( int argc, char *argv[] )
+{
+  int count = 500;
+  int gap_ms = 25;
+  std::vector<std::string> netsim_args;
+
+  for ( int i = 1; i < argc; i++ ) {
+    if ( !strcmp( argv[ i ], "-n" ) && ( i + 1 < argc ) ) {
+      count = atoi( argv[ ++i ] );
+    } else if ( !strcmp( argv[ i ], "-i" ) && ( i + 1 < argc ) ) {
+      gap_ms = atoi( argv[ ++i ] );
+    } else if ( !strncmp( argv[ i ], "--", 2 ) ) {
+      netsim_args.push_back( argv[ i ] );
+    } else {
+      usage( argv[ 0 ] );
+    }
+  }
+  if ( ( count <= 0 ) || ( gap_ms < 0 ) ) {
+    usage( argv[ 0 ] );
+  }
+
+  /* locate the frontends (and netsim) relative to this binary */
+  char self[ 4096 ];
+  strncpy( self, argv[ 0 ], sizeof( self ) - 1 );
+  self[ sizeof( self ) - 1 ] = '\0';
+  const std::string bindir = dirname( self );
+  const std::string server_path =
+    getenv( "MOSH_SERVER" ) ? getenv( "MOSH_SERVER" ) : bindir + "/../frontend/mosh-server";
+  const std::string client_path =
+    getenv( "MOSH_CLIENT" ) ? getenv( "MOSH_CLIENT" ) : bindir + "/../frontend/mosh-client";
+
+  setenv( "LC_ALL", "C.UTF-8", 1 );
+  /* an abandoned server (e.g. benchmark interrupted) goes away on its own */
+  setenv( "MOSH_SERVER_NETWORK_TMOUT", "30", 1 );
+
+  /* start the server; the only session output is the pty echo of what
+     we type, so every keystroke produces exactly one paint */
+  char *server_argv[ 16 ];
+  int server_argc = 0;
+  server_argv[ server_argc++ ] = (char *)server_path.c_str();
+  server_argv[ server_argc++ ] = (char *)"new";
+  server_argv[ server_argc++ ] = (char *)"-i";
+  server_argv[ server_argc++ ] = (char *)"127.0.0.1";
+  server_argv[ server_argc++ ] = (char *)"--";
+  server_argv[ server_argc++ ] = (char *)"sh";
+  server_argv[ server_argc++ ] = (char *)"-c";
+  server_argv[ server_argc++ ] = (char *)"exec cat >/dev/null";
+  server_argv[ server_argc ] = NULL;
+
+  int server_out = -1;
+  pid_t server_pid = spawn( server_argv, &server_out );
+
+  char connect_line[ 1024 ];
+  std::string server_banner;
+  for ( ;; ) {
+    ssize_t n = read( server_out, connect_line, sizeof( connect_line ) );
+    if ( n <= 0 ) {
+      break;
+    }
+    server_banner.append( connect_line, n );
+    if ( server_banner.find( '\n' ) != std::string::npos
+	 && server_banner.find( "MOSH CONNECT" ) != std::string::npos ) {
+      break;
+    }
+  }
+  int server_port = 0;
+  char key[ 64 ] = { 0 };
+  const size_t connect_pos = server_banner.find( "MOSH CONNECT" );
+  if ( ( connect_pos == std::string::npos )
+       || ( 2 != sscanf( server_banner.c_str() + connect_pos,
+			 "MOSH CONNECT %d %63s", &server_port, key ) ) ) {
+    fprintf( stderr, "Could not start %s.\n", server_path.c_str() );
+    exit( 1 );
+  }
+  close( server_out );
+  waitpid( server_pid, NULL, 0 ); /* the server has detached */
+
+  /* interpose the netsim relay if link options were given */
+  int client_port = server_port;
+  pid_t netsim_pid = -1;
+  if ( !netsim_args.empty() ) {
+    client_port = free_udp_port();
+    const std::string netsim_path = bindir + "/netsim";
+    char listen_str[ 16 ], target_str[ 16 ];
+    snprintf( listen_str, sizeof( listen_str ), "%d", client_port );
+    snprintf( target_str, sizeof( target_str ), "%d", server_port );
+    std::vector<char *> nargv;
+    nargv.push_back( (char *)netsim_path.c_str() );
+    for ( size_t i = 0; i < netsim_args.size(); i++ ) {
+      nargv.push_back( (char *)netsim_args[ i ].c_str() );
+    }
+    nargv.push_back( listen_str );
+    nargv.push_back( (char *)"127.0.0.1" );
+    nargv.push_back( target_str );
+    nargv.push_back( NULL );
+    netsim_pid = spawn( &nargv[ 0 ], NULL );
+  }
+
+  /* run the client in a pty, without predictive echo: we are timing
+     the real network round trip to a painted character */
+  struct winsize window_size;
+  memset( &window_size, 0, sizeof( window_size ) );
+  window_size.ws_col = 80;
+  window_size.ws_row = 24;
+
+  int master = -1;
+  pid_t client_pid = forkpty( &master, NULL, NULL, &window_size );
+  if ( client_pid < 0 ) {
+    perror( "forkpty" );
+    exit( 1 );
+  }
+  if ( client_pid == 0 ) {
+    setenv( "MOSH_KEY", key, 1 );
+    setenv( "MOSH_PREDICTION_DISPLAY", "never", 1 );
+    setenv( "TERM", "xterm-256color", 1 );
+    char port_str[ 16 ];
+    snprintf( port_str, sizeof( port_str ), "%d", client_port );
+    execlp( client_path.c_str(), client_path.c_str(),
+	    "127.0.0.1", port_str, (char *)NULL );
+    perror( "execlp" );
+    exit( 1 );
+  }
+
+  EscapeFilter filter;
+  quiesce( master, filter, 1000 ); /* connection setup and first paint */
+
+  std::vector<double> samples;
+  samples.reserve( count );
+  char buf[ 4096 ];
+
+  for ( int i = 0; i < count; i++ ) {
+    const char expected = 'a' + ( i % 26 );
+
+    if ( ( i > 0 ) && ( i % 26 == 0 ) ) {
+      /* flush the canonical-mode line; untimed */
+      fatal_assert( 1 == write( master, "\r", 1 ) );
+      quiesce( master, filter, 100 );
+    }
+
+    if ( gap_ms ) {
+      usleep( 1000 * gap_ms );
+      quiesce( master, filter, 0 ); /* drop stale paints before timing */
+    }
+
+    const uint64_t start = now_us();
+    fatal_assert( 1 == write( master, &expected, 1 ) );
+
+    bool matched = false;
+    while ( !matched ) {
+      if ( now_us() - start > 10 * 1000 * 1000 ) {
+	fprintf( stderr, "Timed out waiting for echo of keystroke %d.\n", i );
+	exit( 1 );
+      }
+      ssize_t n = read_some( master, buf, sizeof( buf ), 100 );
+      if ( n < 0 ) {
+	fprintf( stderr, "Client exited during measurement.\n" );
+	exit( 1 );
+      }
+      for ( ssize_t j = 0; j < n; j++ ) {
+	if ( filter.feed( buf[ j ] ) && ( buf[ j ] == expected ) ) {
+	  matched = true; /* keep consuming the rest of the burst next round */
+	}
+      }
+    }
+    samples.push_back( ( now_us() - start ) / 1000.0 );
+  }
+
+  /* end of input shuts down cat, the server, and then the client */
+  char eof_char = 0x04;
+  (void)!write( master, "\r", 1 );
+  (void)!write( master, &eof_char, 1 );
+  quiesce( master, filter, 1000 );
+  close( master );
+  kill( client_pid, SIGKILL ); /* in case shutdown stalled */
+  waitpid( client_pid, NULL, 0 );
+  if ( netsim_pid > 0 ) {
+    kill( netsim_pid, SIGKILL );
+    waitpid( netsim_pid, NULL, 0 );
+  }
+
+  std::sort( samples.begin(), samples.end() );
+  double sum = 0;
+  for ( size_t i = 0; i < samples.size(); i++ ) {
+    sum += samples[ i ];
+  }
+
+  printf( "keystroke-to-paint latency, %d keystrokes, %d ms apart", count, gap_ms );
+  for ( size_t i = 0; i < netsim_args.size(); i++ ) {
+    printf( "%s %s", i ? "" : ", link:", netsim_args[ i ].c_str() );
+  }
+  printf( "\n" );
+  printf( "  min %8.2f ms\n", samples.front() );
+  printf( "  p50 %8.2f ms\n", percentile( samples, 0.50 ) );
+  printf( "  p99 %8.2f ms\n", percentile( samples, 0.99 ) );
+  printf( "  p99.9 %6.2f ms\n", percentile( samples, 0.999 ) );
+  printf( "  max %8.2f ms\n", samples.back() );
+  printf( "  mean %7.2f ms\n", sum / samples.size() );
+
+  return 0;
+}
@@ -0,0 +1,279 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+/* netsim: a UDP relay that degrades the link on purpose.
+
+   Put it between a mosh (or ntester) client and server to benchmark
+   transport changes under reproducible conditions instead of on a
+   live cell link:
+
+     netsim [--delay=MS] [--jitter=MS] [--loss=PCT] [--rate=KBPS]
+	    [--seed=N] LISTEN_PORT TARGET_IP TARGET_PORT
+
+   The client connects to LISTEN_PORT; datagrams are forwarded to the
+   target and back with the configured one-way delay, uniform jitter
+   (which also reorders packets when it exceeds the packet spacing),
+   random loss, and a serialization-rate cap.  All randomness comes
+   from a seeded generator, so a run is repeatable end to end up to
+   scheduler timing. */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <map>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+#include "fatal_assert.h"
+#include "select.h"
+#include "timestamp.h"
+
+using std::multimap;
+using std::pair;
+using std::string;
+
+/* deterministic: same seed, same drops and delays */
+class SimPRNG {
+private:
+  uint64_t state;
+
+public:
+  SimPRNG( uint64_t seed ) : state( seed ? seed : 1 ) {}
+  uint32_t next( void )
+  {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return uint32_t( state >> 33 );
+  }
+  /* uniform in [0, bound) */
+  uint32_t uniform( uint32_t bound ) { return bound ? ( next() % bound ) : 0; }
+};
+
+struct LinkParams {
+  unsigned int delay_ms;
+  unsigned int jitter_ms;
+  double loss_fraction;
+  unsigned int rate_kbps; /* 0 = unlimited */
+
+  LinkParams() : delay_ms( 0 ), jitter_ms( 0 ), loss_fraction( 0 ), rate_kbps( 0 ) {}
+};
+
+/* One direction of the link: its own serialization clock, so the cap
+   applies per direction like a real duplex link. */
+class Direction {
+private:
+  int out_fd;
+  uint64_t link_free_at;
+  multimap< uint64_t, string > in_flight; /* delivery time => payload */
+
+public:
+  Direction( int s_out_fd ) : out_fd( s_out_fd ), link_free_at( 0 ), in_flight() {}
+
+  void admit( const string &payload, const LinkParams &params, SimPRNG &prng )
+  {
+    if ( prng.uniform( 1000000 ) < uint32_t( params.loss_fraction * 1000000 ) ) {
+      return; /* dropped */
+    }
+
+    uint64_t now = frozen_timestamp();
+
+    /* serialization delay from the rate cap */
+    uint64_t ready = now;
+    if ( params.rate_kbps ) {
+      const uint64_t ser_ms = ( payload.size() * 8 ) / params.rate_kbps;
+      if ( link_free_at < now ) {
+	link_free_at = now;
+      }
+      link_free_at += ser_ms;
+      ready = link_free_at;
+    }
+
+    const uint64_t due = ready + params.delay_ms + prng.uniform( params.jitter_ms + 1 );
+    in_flight.insert( std::make_pair( due, payload ) );
+  }
+
+  /* ms until the next delivery, or -1 for none pending */
+  int wait_time( void ) const
+  {
+    if ( in_flight.empty() ) {
+      return -1;
+    }
+    const uint64_t now = frozen_timestamp();
+    const uint64_t due = in_flight.begin()->first;
+    return ( due > now ) ? int( due - now ) : 0;
+  }
+
+  void deliver_due( const struct sockaddr *dest, socklen_t dest_len )
+  {
+    const uint64_t now = frozen_timestamp();
+    while ( ( !in_flight.empty() ) && ( in_flight.begin()->first <= now ) ) {
+      const string &payload = in_flight.begin()->second;
+      if ( dest_len ) {
+	sendto( out_fd, payload.data(), payload.size(), MSG_DONTWAIT,
+		dest, dest_len );
+      }
+      in_flight.erase( in_flight.begin() );
+    }
+  }
+};
+
+static void usage( const char *argv0 )
+{
+  fprintf( stderr, "Usage: %s [--delay=MS] [--jitter=MS] [--loss=PCT] [--rate=KBPS] [--seed=N] LISTEN_PORT TARGET_IP TARGET_PORT\n", argv0 );
+  exit( 1 );
+}
+
+int main( int argc, char *argv[] )
+{
+  LinkParams params;
+  uint64_t seed = 1;
+
+  int arg = 1;
+  while ( ( arg < argc ) && ( strncmp( argv[ arg ], "--", 2 ) == 0 ) ) {
+    if ( sscanf( argv[ arg ], "--delay=%u", &params.delay_ms ) == 1 ) {
+    } else if ( sscanf( argv[ arg ], "--jitter=%u", &params.jitter_ms ) == 1 ) {
+    } else if ( sscanf( argv[ arg ], "--rate=%u", &params.rate_kbps ) == 1 ) {
+    } else {
+      double pct;
+      unsigned long long s;
+      if ( sscanf( argv[ arg ], "--loss=%lf", &pct ) == 1 ) {
+	params.loss_fraction = pct / 100.0;
+      } else if ( sscanf( argv[ arg ], "--seed=%llu", &s ) == 1 ) {
+	seed = s;
+      } else {
+	usage( argv[ 0 ] );
+      }
+    }
+    arg++;
+  }
+
+  if ( argc - arg != 3 ) {
+    usage( argv[ 0 ] );
+  }
+
+  const int listen_port = atoi( argv[ arg ] );
+  const char *target_ip = argv[ arg + 1 ];
+  const int target_port = atoi( argv[ arg + 2 ] );
+
+  /* socket facing the client */
+  int client_fd = socket( AF_INET, SOCK_DGRAM, 0 );
+  fatal_assert( client_fd >= 0 );
+  struct sockaddr_in listen_addr;
+  memset( &listen_addr, 0, sizeof listen_addr );
+  listen_addr.sin_family = AF_INET;
+  listen_addr.sin_port = htons( listen_port );
+  listen_addr.sin_addr.s_addr = htonl( INADDR_ANY );
+  if ( bind( client_fd, (struct sockaddr *)&listen_addr, sizeof listen_addr ) < 0 ) {
+    perror( "bind" );
+    exit( 1 );
+  }
+
+  /* socket facing the server */
+  int server_fd = socket( AF_INET, SOCK_DGRAM, 0 );
+  fatal_assert( server_fd >= 0 );
+  struct sockaddr_in target_addr;
+  memset( &target_addr, 0, sizeof target_addr );
+  target_addr.sin_family = AF_INET;
+  target_addr.sin_port = htons( target_port );
+  if ( inet_pton( AF_INET, target_ip, &target_addr.sin_addr ) != 1 ) {
+    fprintf( stderr, "Bad target IP %s\n", target_ip );
+    exit( 1 );
+  }
+
+  /* learned from the first datagram; clients hop ports */
+  struct sockaddr_in client_addr;
+  socklen_t client_addr_len = 0;
+  memset( &client_addr, 0, sizeof client_addr );
+
+  SimPRNG prng( seed );
+  Direction to_server( server_fd ), to_client( client_fd );
+
+  fprintf( stderr, "netsim: %d <-> %s:%d, delay=%ums jitter=%ums loss=%.2f%% rate=%ukbps seed=%llu\n",
+	   listen_port, target_ip, target_port,
+	   params.delay_ms, params.jitter_ms, params.loss_fraction * 100,
+	   params.rate_kbps, (unsigned long long)seed );
+
+  Select &sel = Select::get_instance();
+  char buf[ 65536 ];
+
+  while ( true ) {
+    int wait = -1;
+    const int w1 = to_server.wait_time(), w2 = to_client.wait_time();
+    if ( w1 >= 0 ) {
+      wait = w1;
+    }
+    if ( ( w2 >= 0 ) && ( ( wait < 0 ) || ( w2 < wait ) ) ) {
+      wait = w2;
+    }
+
+    sel.clear_fds();
+    sel.add_fd( client_fd );
+    sel.add_fd( server_fd );
+    if ( sel.select( wait ) < 0 ) {
+      perror( "select" );
+      exit( 1 );
+    }
+
+    if ( sel.read( client_fd ) ) {
+      struct sockaddr_in from;
+      socklen_t from_len = sizeof from;
+      ssize_t len;
+      while ( ( len = recvfrom( client_fd, buf, sizeof buf, MSG_DONTWAIT,
+				(struct sockaddr *)&from, &from_len ) ) > 0 ) {
+	client_addr = from;
+	client_addr_len = from_len;
+	to_server.admit( string( buf, len ), params, prng );
+	from_len = sizeof from;
+      }
+      if ( ( len < 0 ) && ( errno != EAGAIN ) && ( errno != EWOULDBLOCK ) ) {
+	perror( "recvfrom" );
+      }
+    }
+
+    if ( sel.read( server_fd ) ) {
+      ssize_t len;
+      while ( ( len = recv( server_fd, buf, sizeof buf, MSG_DONTWAIT ) ) > 0 ) {
+	to_client.admit( string( buf, len ), params, prng );
+      }
+      if ( ( len < 0 ) && ( errno != EAGAIN ) && ( errno != EWOULDBLOCK ) ) {
+	perror( "recv" );
+      }
+    }
+
+    to_server.deliver_due( (struct sockaddr *)&target_addr, sizeof target_addr );
+    to_client.deliver_due( (struct sockaddr *)&client_addr, client_addr_len );
+  }
+}
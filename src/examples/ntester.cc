@@ -30,8 +30,13 @@
     also delete it here.
 */
 
+#include <list>
+#include <stdlib.h>
+#include <string.h>
 #include <termios.h>
 #include <unistd.h>
+#include <utility>
+#include <vector>
 
 #include "user.h"
 #include "fatal_assert.h"
@@ -42,12 +47,78 @@
 
 using namespace Network;
 
+/* Scripted workloads for reproducible transport benchmarks (run the
+   connection through netsim to degrade the link).  Each entry is a
+   keystroke and the pause before the next one. */
+struct WorkloadStep {
+  char byte;
+  unsigned int pause_ms;
+};
+
+static bool workload_step( const char *name, unsigned int i, WorkloadStep &step )
+{
+  if ( 0 == strcmp( name, "typing" ) ) {
+    /* steady interactive typing */
+    if ( i >= 600 ) {
+      return false;
+    }
+    step.byte = 'a' + ( i % 26 );
+    step.pause_ms = 150;
+    return true;
+  } else if ( 0 == strcmp( name, "vim" ) ) {
+    /* bursts of motions with pauses for thought */
+    if ( i >= 1200 ) {
+      return false;
+    }
+    step.byte = "jjkkhhlwwbexu"[ i % 13 ];
+    step.pause_ms = ( i % 40 == 39 ) ? 700 : 60;
+    return true;
+  } else if ( 0 == strcmp( name, "bulk" ) ) {
+    /* paste-like: no pacing at all */
+    if ( i >= 16384 ) {
+      return false;
+    }
+    step.byte = 'a' + ( i % 26 );
+    step.pause_ms = 0;
+    return true;
+  }
+  fprintf( stderr, "Unknown workload %s (try typing, vim, bulk)\n", name );
+  exit( 1 );
+}
+
+static int compare_uint64( const void *a, const void *b )
+{
+  const uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return ( x < y ) ? -1 : ( x > y ) ? 1 : 0;
+}
+
+static void print_latency_stats( std::vector< uint64_t > &samples )
+{
+  if ( samples.empty() ) {
+    return;
+  }
+  qsort( &samples[ 0 ], samples.size(), sizeof( samples[ 0 ] ), compare_uint64 );
+  uint64_t sum = 0;
+  for ( std::vector< uint64_t >::const_iterator i = samples.begin();
+	i != samples.end();
+	i++ ) {
+    sum += *i;
+  }
+  fprintf( stderr, "ack latency (ms): n=%u mean=%llu p50=%llu p99=%llu max=%llu\n",
+	   (unsigned int)samples.size(),
+	   (unsigned long long)( sum / samples.size() ),
+	   (unsigned long long)samples[ samples.size() / 2 ],
+	   (unsigned long long)samples[ ( samples.size() * 99 ) / 100 ],
+	   (unsigned long long)samples.back() );
+}
+
 int main( int argc, char *argv[] )
 {
   bool server = true;
   char *key;
   char *ip;
   char *port;
+  const char *workload = NULL;
 
   UserStream me, remote;
   typedef shared::shared_ptr<Transport<UserStream, UserStream> > NetworkPointer;
@@ -60,7 +131,10 @@ int main( int argc, char *argv[] )
       key = argv[ 1 ];
       ip = argv[ 2 ];
       port = argv[ 3 ];
-      
+      if ( argc > 4 ) {
+	workload = argv[ 4 ];
+      }
+
       raw_n = new Transport<UserStream, UserStream>( me, remote, key, ip, port );
     } else {
       raw_n = new Transport<UserStream, UserStream>( me, remote, NULL, NULL );
@@ -101,6 +175,80 @@ int main( int argc, char *argv[] )
 	fprintf( stderr, "Server error: %s\n", e.what() );
       }
     }
+  } else if ( workload ) {
+    /* scripted client: replay the workload and report per-keystroke
+       acknowledgment latency */
+    Select &sel = Select::get_instance();
+
+    unsigned int step_num = 0;
+    WorkloadStep step = { 0, 0 };
+    bool more = workload_step( workload, step_num, step );
+    uint64_t next_key_time = timestamp();
+
+    typedef std::list< std::pair< uint64_t, uint64_t > > pending_type; /* push time, state num */
+    pending_type pending;
+    std::vector< uint64_t > samples;
+
+    while ( true ) {
+      try {
+	int wait = n->wait_time();
+	if ( more ) {
+	  const uint64_t now = timestamp();
+	  const int until = ( next_key_time > now ) ? int( next_key_time - now ) : 0;
+	  if ( until < wait ) {
+	    wait = until;
+	  }
+	}
+
+	sel.clear_fds();
+	std::vector< int > fd_list( n->fds() );
+	for ( std::vector< int >::const_iterator it = fd_list.begin();
+	      it != fd_list.end();
+	      it++ ) {
+	  sel.add_fd( *it );
+	}
+
+	if ( sel.select( wait ) < 0 ) {
+	  perror( "select" );
+	}
+
+	if ( more && ( timestamp() >= next_key_time ) ) {
+	  n->get_current_state().push_back( Parser::UserByte( step.byte ) );
+	  /* the change goes out in a state numbered at least last+1 */
+	  pending.push_back( std::make_pair( timestamp(), n->get_sent_state_last() + 1 ) );
+	  next_key_time = timestamp() + step.pause_ms;
+	  step_num++;
+	  more = workload_step( workload, step_num, step );
+	}
+
+	bool network_ready_to_read = false;
+	for ( std::vector< int >::const_iterator it = fd_list.begin();
+	      it != fd_list.end();
+	      it++ ) {
+	  if ( sel.read( *it ) ) {
+	    network_ready_to_read = true;
+	  }
+	}
+	if ( network_ready_to_read ) {
+	  n->recv();
+	}
+
+	n->tick();
+
+	while ( ( !pending.empty() )
+		&& ( n->get_sent_state_acked() >= pending.front().second ) ) {
+	  samples.push_back( timestamp() - pending.front().first );
+	  pending.pop_front();
+	}
+
+	if ( ( !more ) && pending.empty() ) {
+	  print_latency_stats( samples );
+	  break;
+	}
+      } catch ( const std::exception &e ) {
+	fprintf( stderr, "Client error: %s\n", e.what() );
+      }
+    }
   } else {
     struct termios saved_termios;
     struct termios the_termios;
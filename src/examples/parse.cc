@@ -199,8 +199,7 @@ static int vt_parser( int fd, Parser::UTF8Parser *parser )
 	  j != actions.end();
 	  j++ ) {
 
-      assert( *j );
-      Parser::Action &act = **j;
+      Parser::Action &act = *j;
 
       if ( act.char_present ) {
 	if ( iswprint( act.ch ) ) {
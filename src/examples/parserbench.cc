@@ -0,0 +1,320 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+/* Performance-regression harness for the emulator: replays the fuzz
+   corpora (src/fuzz/terminal_corpus) and any recorded session
+   transcripts through Complete::act, accounting nanoseconds per input
+   class.  A baseline file written with -w is compared against on
+   later runs with -b; the run fails if any class slowed down by more
+   than the tolerance, so a parser change that doubles CPU shows up in
+   CI instead of in production.
+
+   Usage: parserbench [-w baseline] [-b baseline] [-t percent] FILE|DIR ...  */
+
+#include "config.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "completeterminal.h"
+#include "latencystats.h"
+#include "locale_utils.h"
+#include "parser.h"
+
+using std::string;
+using std::vector;
+
+enum InputClass {
+  CLASS_TEXT = 0, /* printable ground-state bytes */
+  CLASS_CSI,      /* ESC [ ... final */
+  CLASS_OSC,      /* ESC ] ... BEL/ST */
+  CLASS_UTF8,     /* bytes with the high bit set */
+  CLASS_CONTROL,  /* C0 controls and other escape sequences */
+  NUM_CLASSES
+};
+
+static const char *const class_names[ NUM_CLASSES ]
+  = { "text", "csi", "osc", "utf8", "control" };
+
+static uint64_t class_ns[ NUM_CLASSES ];
+static uint64_t class_bytes[ NUM_CLASSES ];
+
+/* Attribute each byte to an input class.  This is a shadow of the
+   real parser, for accounting only: it doesn't need to agree with
+   every transition, just to put bytes in the right bucket. */
+static void classify( const string &input, vector<unsigned char> &classes )
+{
+  enum { GROUND, SEEN_ESC, IN_CSI, IN_OSC } state = GROUND;
+
+  classes.resize( input.size() );
+  for ( size_t i = 0; i < input.size(); i++ ) {
+    const unsigned char c = input[ i ];
+    unsigned char cl = CLASS_CONTROL;
+
+    switch ( state ) {
+    case GROUND:
+      if ( c == 0x1b ) {
+	state = SEEN_ESC;
+      } else if ( c >= 0x80 ) {
+	cl = CLASS_UTF8;
+      } else if ( c >= 0x20 && c != 0x7f ) {
+	cl = CLASS_TEXT;
+      }
+      break;
+    case SEEN_ESC:
+      if ( c == '[' ) {
+	state = IN_CSI;
+	cl = CLASS_CSI;
+      } else if ( c == ']' ) {
+	state = IN_OSC;
+	cl = CLASS_OSC;
+      } else {
+	state = GROUND;
+      }
+      break;
+    case IN_CSI:
+      cl = CLASS_CSI;
+      if ( c >= 0x40 && c <= 0x7e ) {
+	state = GROUND;
+      }
+      break;
+    case IN_OSC:
+      cl = CLASS_OSC;
+      if ( c == 0x07 ) { /* BEL terminator */
+	state = GROUND;
+      } else if ( c == 0x1b ) { /* first half of ST */
+	state = SEEN_ESC;
+	cl = CLASS_CONTROL;
+      }
+      break;
+    }
+
+    classes[ i ] = cl;
+  }
+}
+
+/* Feed one transcript through a fresh terminal, timing each run of
+   same-class bytes so clock reads stay off the per-byte path. */
+static void replay( const string &input )
+{
+  vector<unsigned char> classes;
+  classify( input, classes );
+
+  Terminal::Complete terminal( 80, 24 );
+
+  size_t i = 0;
+  while ( i < input.size() ) {
+    const unsigned char cl = classes[ i ];
+    size_t end = i;
+    while ( ( end < input.size() ) && ( classes[ end ] == cl ) ) {
+      end++;
+    }
+
+    const uint64_t start_ns = LatencyStats::now_ns();
+    for ( size_t j = i; j < end; j++ ) {
+      terminal.act( Parser::UserByte( input[ j ] ) );
+    }
+    class_ns[ cl ] += LatencyStats::now_ns() - start_ns;
+    class_bytes[ cl ] += end - i;
+
+    i = end;
+  }
+}
+
+static bool slurp( const char *path, string &contents )
+{
+  FILE *f = fopen( path, "rb" );
+  if ( !f ) {
+    perror( path );
+    return false;
+  }
+  char buf[ 65536 ];
+  size_t n;
+  contents.clear();
+  while ( ( n = fread( buf, 1, sizeof buf, f ) ) > 0 ) {
+    contents.append( buf, n );
+  }
+  fclose( f );
+  return true;
+}
+
+static void replay_path( const char *path )
+{
+  struct stat st;
+  if ( stat( path, &st ) < 0 ) {
+    perror( path );
+    exit( 1 );
+  }
+
+  if ( S_ISDIR( st.st_mode ) ) {
+    DIR *dir = opendir( path );
+    if ( !dir ) {
+      perror( path );
+      exit( 1 );
+    }
+    for ( struct dirent *ent = readdir( dir ); ent; ent = readdir( dir ) ) {
+      if ( ent->d_name[ 0 ] == '.' ) {
+	continue;
+      }
+      const string child = string( path ) + "/" + ent->d_name;
+      struct stat cst;
+      if ( ( stat( child.c_str(), &cst ) == 0 ) && S_ISREG( cst.st_mode ) ) {
+	string contents;
+	if ( slurp( child.c_str(), contents ) ) {
+	  replay( contents );
+	}
+      }
+    }
+    closedir( dir );
+  } else {
+    string contents;
+    if ( slurp( path, contents ) ) {
+      replay( contents );
+    }
+  }
+}
+
+static double ns_per_byte( int cl )
+{
+  return class_bytes[ cl ] ? (double)class_ns[ cl ] / (double)class_bytes[ cl ] : 0.0;
+}
+
+static void write_baseline( const char *path )
+{
+  FILE *f = fopen( path, "w" );
+  if ( !f ) {
+    perror( path );
+    exit( 1 );
+  }
+  for ( int cl = 0; cl < NUM_CLASSES; cl++ ) {
+    fprintf( f, "%s %.2f\n", class_names[ cl ], ns_per_byte( cl ) );
+  }
+  fclose( f );
+}
+
+/* returns true when every class is within tolerance of the baseline */
+static bool compare_baseline( const char *path, double tolerance_percent )
+{
+  FILE *f = fopen( path, "r" );
+  if ( !f ) {
+    perror( path );
+    exit( 1 );
+  }
+
+  bool ok = true;
+  char name[ 32 ];
+  double base;
+  while ( fscanf( f, "%31s %lf", name, &base ) == 2 ) {
+    for ( int cl = 0; cl < NUM_CLASSES; cl++ ) {
+      if ( strcmp( name, class_names[ cl ] ) ) {
+	continue;
+      }
+      const double now = ns_per_byte( cl );
+      if ( ( base > 0 ) && ( now > base * ( 1.0 + tolerance_percent / 100.0 ) ) ) {
+	fprintf( stderr, "REGRESSION %-8s %8.2f ns/byte vs baseline %8.2f (+%.0f%%)\n",
+		 class_names[ cl ], now, base, 100.0 * ( now / base - 1.0 ) );
+	ok = false;
+      }
+      break;
+    }
+  }
+  fclose( f );
+  return ok;
+}
+
+static void usage( const char *argv0 )
+{
+  fprintf( stderr, "Usage: %s [-w baseline-out] [-b baseline] [-t tolerance-percent] FILE|DIR ...\n", argv0 );
+  exit( 1 );
+}
+
+int main( int argc, char *argv[] )
+{
+  const char *baseline_out = NULL;
+  const char *baseline_in = NULL;
+  double tolerance = 20.0;
+
+  int opt;
+  while ( ( opt = getopt( argc, argv, "w:b:t:" ) ) != -1 ) {
+    switch ( opt ) {
+    case 'w':
+      baseline_out = optarg;
+      break;
+    case 'b':
+      baseline_in = optarg;
+      break;
+    case 't':
+      tolerance = atof( optarg );
+      break;
+    default:
+      usage( argv[ 0 ] );
+    }
+  }
+
+  if ( optind == argc ) {
+    usage( argv[ 0 ] );
+  }
+
+  /* the emulator expects a UTF-8 locale */
+  setenv( "LC_ALL", "C.UTF-8", 1 );
+  set_native_locale();
+
+  for ( int i = optind; i < argc; i++ ) {
+    replay_path( argv[ i ] );
+  }
+
+  for ( int cl = 0; cl < NUM_CLASSES; cl++ ) {
+    printf( "%-8s %12llu bytes %10.2f ns/byte\n",
+	    class_names[ cl ],
+	    (unsigned long long)class_bytes[ cl ],
+	    ns_per_byte( cl ) );
+  }
+
+  if ( baseline_out ) {
+    write_baseline( baseline_out );
+  }
+
+  if ( baseline_in && !compare_baseline( baseline_in, tolerance ) ) {
+    return 1;
+  }
+
+  return 0;
+}
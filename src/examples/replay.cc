@@ -0,0 +1,177 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+/* Plays back a session recording made by mosh-server (see
+   MOSH_SERVER_RECORD and src/network/recordingtap.h): each record's
+   diff is fed through apply_string() on a fresh Complete, and the
+   resulting frames are rendered to the local terminal with the
+   original timing. */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <string>
+#include <zlib.h>
+
+#include "byteorder.h"
+#include "completeterminal.h"
+#include "terminaldisplay.h"
+#include "fatal_assert.h"
+#include "locale_utils.h"
+#include "swrite.h"
+
+/* long idle stretches are compressed, like asciinema's -i */
+static const uint64_t MAX_IDLE_MS = 3000;
+
+static bool read_uint64( gzFile file, uint64_t &val )
+{
+  uint64_t net;
+  if ( gzread( file, &net, sizeof( net ) ) != (int)sizeof( net ) ) {
+    return false;
+  }
+  val = be64toh( net );
+  return true;
+}
+
+static void usage( const char *argv0 )
+{
+  fprintf( stderr, "Usage: %s [-s speed] recording\n", argv0 );
+  exit( 1 );
+}
+
+int main( int argc, char *argv[] )
+{
+  double speed = 1.0;
+
+  int opt;
+  while ( ( opt = getopt( argc, argv, "s:" ) ) != -1 ) {
+    switch ( opt ) {
+    case 's':
+      speed = atof( optarg );
+      if ( speed <= 0 ) {
+	fprintf( stderr, "%s: invalid speed\n", argv[ 0 ] );
+	exit( 1 );
+      }
+      break;
+    default:
+      usage( argv[ 0 ] );
+    }
+  }
+
+  if ( optind != argc - 1 ) {
+    usage( argv[ 0 ] );
+  }
+
+  set_native_locale();
+
+  gzFile file = gzopen( argv[ optind ], "rb" );
+  if ( file == NULL ) {
+    perror( "gzopen" );
+    exit( 1 );
+  }
+
+  char magic[ 8 ];
+  if ( ( gzread( file, magic, sizeof( magic ) ) != (int)sizeof( magic ) )
+       || ( 0 != memcmp( magic, "MOSHTAP1", sizeof( magic ) ) ) ) {
+    fprintf( stderr, "%s: not a mosh session recording\n", argv[ optind ] );
+    exit( 1 );
+  }
+
+  uint64_t header_len;
+  if ( !read_uint64( file, header_len ) || ( header_len > 64 ) ) {
+    fprintf( stderr, "%s: corrupt recording header\n", argv[ optind ] );
+    exit( 1 );
+  }
+  char header[ 65 ] = { 0 };
+  if ( gzread( file, header, header_len ) != (int)header_len ) {
+    fprintf( stderr, "%s: corrupt recording header\n", argv[ optind ] );
+    exit( 1 );
+  }
+
+  int width, height;
+  if ( ( 2 != sscanf( header, "%d %d", &width, &height ) )
+       || ( width <= 0 ) || ( height <= 0 ) ) {
+    fprintf( stderr, "%s: corrupt recording header\n", argv[ optind ] );
+    exit( 1 );
+  }
+
+  Terminal::Complete complete( width, height );
+  Terminal::Framebuffer state( width, height );
+  Terminal::Display display( true ); /* use TERM to initialize */
+
+  std::string init = display.open();
+  fatal_assert( swrite( STDOUT_FILENO, init.data(), init.size() ) == 0 );
+
+  bool initialized = false;
+  uint64_t prev_timestamp = 0;
+  std::string diff;
+
+  for ( ;; ) {
+    uint64_t the_timestamp, diff_len;
+    if ( !read_uint64( file, the_timestamp )
+	 || !read_uint64( file, diff_len ) ) {
+      break; /* end of recording (or truncated tail) */
+    }
+    diff.resize( diff_len );
+    if ( diff_len && ( gzread( file, &diff[ 0 ], diff_len ) != (int)diff_len ) ) {
+      break;
+    }
+
+    if ( initialized && ( the_timestamp > prev_timestamp ) ) {
+      uint64_t wait = the_timestamp - prev_timestamp;
+      if ( wait > MAX_IDLE_MS ) {
+	wait = MAX_IDLE_MS;
+      }
+      usleep( (useconds_t)( 1000 * wait / speed ) );
+    }
+    prev_timestamp = the_timestamp;
+
+    complete.apply_string( diff );
+
+    Terminal::Framebuffer new_frame( complete.get_fb() );
+    std::string update = display.new_frame( initialized, state, new_frame );
+    fatal_assert( swrite( STDOUT_FILENO, update.data(), update.size() ) == 0 );
+    state = new_frame;
+    initialized = true;
+  }
+
+  std::string tail = display.close();
+  fatal_assert( swrite( STDOUT_FILENO, tail.data(), tail.size() ) == 0 );
+
+  gzclose( file );
+
+  return 0;
+}
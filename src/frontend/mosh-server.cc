@@ -79,8 +79,18 @@
 #include <libutil.h>
 #endif
 
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "byteorder.h"
+#include "snapshotcodec.h"
 #include "completeterminal.h"
+#include "allocstats.h"
+#include "latencystats.h"
+#include "transportstats.h"
 #include "swrite.h"
+#include "recordingtap.h"
 #include "user.h"
 #include "fatal_assert.h"
 #include "locale_utils.h"
@@ -100,13 +110,50 @@ typedef Network::Transport< Terminal::Complete, Network::UserStream > ServerConn
 static void serve( int host_fd,
 		   Terminal::Complete &terminal,
 		   ServerConnection &network,
+		   Network::Connection *observer,
 		   long network_timeout,
 		   long network_signaled_timeout );
 
 static int run_server( const char *desired_ip, const char *desired_port,
+		       const char *restore_path,
 		       const string &command_path, char *command_argv[],
-		       const int colors, unsigned int verbose, bool with_motd );
+		       const int colors, unsigned int verbose, bool with_motd,
+		       bool observer_requested );
+
+
+#ifdef __linux__
+/* Opt-in CPU pinning for crowded multi-socket hosts, where hundreds
+   of detached sessions otherwise migrate between cache domains and
+   drag their compressor scratch and framebuffer rows along.  If
+   MOSH_SERVER_PIN names a CPU number, pin there; any other non-empty
+   value pins to whichever CPU the scheduler chose for us, keeping
+   the session (and, by inheritance, its PTY child) where it landed. */
+static void pin_to_cpu( void )
+{
+  const char *pin_envar = getenv( "MOSH_SERVER_PIN" );
+  if ( !pin_envar || !*pin_envar ) {
+    return;
+  }
 
+  errno = 0;
+  char *endptr;
+  long cpu = strtol( pin_envar, &endptr, 10 );
+  if ( *endptr != '\0' || errno != 0 || cpu < 0 || cpu >= CPU_SETSIZE ) {
+    cpu = sched_getcpu();
+    if ( cpu < 0 ) {
+      perror( "sched_getcpu" );
+      return;
+    }
+  }
+
+  cpu_set_t mask;
+  CPU_ZERO( &mask );
+  CPU_SET( cpu, &mask );
+  if ( sched_setaffinity( 0, sizeof mask, &mask ) < 0 ) {
+    perror( "sched_setaffinity" ); /* e.g. CPU number not present; run unpinned */
+  }
+}
+#endif
 
 static void print_version( FILE *file )
 {
@@ -119,7 +166,8 @@ static void print_version( FILE *file )
 
 static void print_usage( FILE *stream, const char *argv0 )
 {
-  fprintf( stream, "Usage: %s new [-s] [-v] [-i LOCALADDR] [-p PORT[:PORT2]] [-c COLORS] [-l NAME=VALUE] [-- COMMAND...]\n", argv0 );
+  fprintf( stream, "Usage: %s new [-s] [-v] [-o] [-i LOCALADDR] [-p PORT[:PORT2]] [-c COLORS] [-l NAME=VALUE] [-- COMMAND...]\n", argv0 );
+  fprintf( stream, "       %s restore SNAPSHOT-FILE\n", argv0 );
 }
 
 static bool print_motd( const char *filename );
@@ -142,6 +190,50 @@ static void spin( void )
   }
 }
 
+/* true if the pty has more output ready right now */
+static bool pty_readable( int fd )
+{
+  fd_set fds;
+  FD_ZERO( &fds );
+  FD_SET( fd, &fds );
+  struct timeval tv = { 0, 0 };
+  return select( fd + 1, &fds, NULL, NULL, &tv ) == 1;
+}
+
+/* Write what the host pty will accept right now; a bulk paste must not
+   block the event loop while the application catches up. */
+static bool drain_host_input( int host_fd, string &pending )
+{
+  if ( pending.empty() ) {
+    return true;
+  }
+
+  int flags = fcntl( host_fd, F_GETFL );
+  if ( ( flags < 0 )
+       || ( fcntl( host_fd, F_SETFL, flags | O_NONBLOCK ) < 0 ) ) {
+    /* fall back to a blocking write */
+    bool ok = swrite( host_fd, pending.data(), pending.size() ) == 0;
+    pending.clear();
+    return ok;
+  }
+
+  ssize_t bytes_written = write( host_fd, pending.data(), pending.size() );
+  int saved_errno = errno;
+
+  fcntl( host_fd, F_SETFL, flags );
+
+  if ( bytes_written > 0 ) {
+    pending.erase( 0, bytes_written );
+  } else if ( ( bytes_written < 0 )
+	      && ( saved_errno != EAGAIN )
+	      && ( saved_errno != EWOULDBLOCK )
+	      && ( saved_errno != EINTR ) ) {
+    pending.clear();
+    return false;
+  }
+  return true;
+}
+
 static string get_SSH_IP( void )
 {
   const char *SSH_CONNECTION = getenv( "SSH_CONNECTION" );
@@ -183,6 +275,7 @@ int main( int argc, char *argv[] )
   char **command_argv = NULL;
   int colors = 0;
   unsigned int verbose = 0; /* don't close stdin/stdout/stderr */
+  bool observer_requested = false;
   /* Will cause mosh-server not to correctly detach on old versions of sshd. */
   list<string> locale_vars;
 
@@ -206,11 +299,19 @@ int main( int argc, char *argv[] )
   }
 
   /* Parse new command-line syntax */
+  const char *restore_path = NULL;
   if ( (argc >= 2)
+       && (strcmp( argv[ 1 ], "restore" ) == 0) ) {
+    if ( argc != 3 ) {
+      print_usage( stderr, argv[ 0 ] );
+      exit( 1 );
+    }
+    restore_path = argv[ 2 ];
+  } else if ( (argc >= 2)
        && (strcmp( argv[ 1 ], "new" ) == 0) ) {
     /* new option syntax */
     int opt;
-    while ( (opt = getopt( argc - 1, argv + 1, "@:i:p:c:svl:" )) != -1 ) {
+    while ( (opt = getopt( argc - 1, argv + 1, "@:i:p:c:svl:o" )) != -1 ) {
       switch ( opt ) {
 	/*
 	 * This undocumented option does nothing but eat its argument.
@@ -251,6 +352,9 @@ int main( int argc, char *argv[] )
       case 'l':
 	locale_vars.push_back( string( optarg ) );
 	break;
+      case 'o':
+	observer_requested = true;
+	break;
       default:
 	/* don't die on unknown options */
 	print_usage( stderr, argv[ 0 ] );
@@ -278,6 +382,13 @@ int main( int argc, char *argv[] )
     exit( 1 );
   }
 
+  /* the observer is a second connection and needs a port of its own */
+  if ( observer_requested && desired_port && ( dpl == dph ) ) {
+    fprintf( stderr, "%s: -o needs a second UDP port; give -p a range (e.g. -p %d:%d)\n",
+	     argv[ 0 ], dpl, dpl + 1 );
+    exit( 1 );
+  }
+
   bool with_motd = false;
 
   #ifdef HAVE_SYSLOG
@@ -364,7 +475,7 @@ int main( int argc, char *argv[] )
   }
 
   try {
-    return run_server( desired_ip, desired_port, command_path, command_argv, colors, verbose, with_motd );
+    return run_server( desired_ip, desired_port, restore_path, command_path, command_argv, colors, verbose, with_motd, observer_requested );
   } catch ( const Network::NetworkException &e ) {
     fprintf( stderr, "Network exception: %s\n",
 	     e.what() );
@@ -376,9 +487,113 @@ int main( int argc, char *argv[] )
   }
 }
 
+/* A session snapshot: everything a fresh process needs to keep serving
+   an existing client, e.g. across a server upgrade.  The terminal and
+   input streams are stored as diffs from blank states, the same
+   serialization the transport already uses on the wire. */
+struct SessionSnapshot {
+  string key;			/* printable session key */
+  string port;			/* concrete bound port */
+  uint64_t width, height;	/* terminal size at snapshot time */
+  uint64_t sent_num;		/* num of the acknowledged terminal state */
+  string terminal_diff;		/* acknowledged terminal state */
+  uint64_t remote_num;		/* num of the latest client state */
+  string remote_diff;		/* latest client state */
+  uint64_t expected_receiver_seq; /* replay-protection floor */
+  uint64_t sequence_minimum;	/* nonce floor for the restored session */
+
+  SessionSnapshot()
+    : key(), port(), width( 0 ), height( 0 ),
+      sent_num( 0 ), terminal_diff(),
+      remote_num( 0 ), remote_diff(),
+      expected_receiver_seq( 0 ), sequence_minimum( 0 ) {}
+};
+
+static const char snapshot_magic[ 8 ] = { 'M', 'O', 'S', 'H', 'S', 'N', 'P', '1' };
+
+static bool write_snapshot( const char *path, ServerConnection &network )
+{
+  /* Snapshot the state the client has acknowledged, not the current
+     one, so the restored server's diffs are guaranteed to apply. */
+  const Terminal::Complete &acked = network.get_acked_state();
+
+  string out( snapshot_magic, sizeof snapshot_magic );
+  put_string( out, network.get_key() );
+  put_string( out, network.port() );
+  put_u64( out, acked.get_fb().ds.get_width() );
+  put_u64( out, acked.get_fb().ds.get_height() );
+  put_u64( out, network.get_sent_state_acked() );
+  put_string( out, acked.init_diff() );
+  put_u64( out, network.get_latest_remote_state().num );
+  put_string( out, network.get_latest_remote_state().state.init_diff() );
+  put_u64( out, network.get_expected_receiver_seq() );
+  /* generous margin over any nonce this process may still have issued */
+  put_u64( out, Crypto::unique() + ( uint64_t( 1 ) << 20 ) );
+
+  /* The snapshot holds key material: create it unreadable by others,
+     and rename into place so a crash can't leave a partial file. */
+  string tmp_path = string( path ) + ".tmp";
+  int fd = open( tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR );
+  if ( fd < 0 ) {
+    perror( "open" );
+    return false;
+  }
+  if ( swrite( fd, out.data(), out.size() ) < 0 ) {
+    close( fd );
+    unlink( tmp_path.c_str() );
+    return false;
+  }
+  if ( close( fd ) < 0 ) {
+    perror( "close" );
+    unlink( tmp_path.c_str() );
+    return false;
+  }
+  if ( rename( tmp_path.c_str(), path ) < 0 ) {
+    perror( "rename" );
+    unlink( tmp_path.c_str() );
+    return false;
+  }
+  return true;
+}
+
+static bool read_snapshot( const char *path, SessionSnapshot &snap )
+{
+  FILE *file = fopen( path, "rb" );
+  if ( !file ) {
+    perror( "fopen" );
+    return false;
+  }
+  string in;
+  char buf[ 4096 ];
+  size_t n;
+  while ( (n = fread( buf, 1, sizeof buf, file )) > 0 ) {
+    in.append( buf, n );
+  }
+  bool read_ok = !ferror( file );
+  fclose( file );
+
+  size_t pos = sizeof snapshot_magic;
+  return read_ok
+    && in.size() >= pos
+    && 0 == memcmp( in.data(), snapshot_magic, pos )
+    && get_string( in, pos, snap.key )
+    && get_string( in, pos, snap.port )
+    && get_u64( in, pos, snap.width )
+    && get_u64( in, pos, snap.height )
+    && get_u64( in, pos, snap.sent_num )
+    && get_string( in, pos, snap.terminal_diff )
+    && get_u64( in, pos, snap.remote_num )
+    && get_string( in, pos, snap.remote_diff )
+    && get_u64( in, pos, snap.expected_receiver_seq )
+    && get_u64( in, pos, snap.sequence_minimum )
+    && pos == in.size();
+}
+
 static int run_server( const char *desired_ip, const char *desired_port,
+		       const char *restore_path,
 		       const string &command_path, char *command_argv[],
-		       const int colors, unsigned int verbose, bool with_motd ) {
+		       const int colors, unsigned int verbose, bool with_motd,
+		       bool observer_requested ) {
   /* get network idle timeout */
   long network_timeout = 0;
   char *timeout_envar = getenv( "MOSH_SERVER_NETWORK_TMOUT" );
@@ -419,17 +634,87 @@ static int run_server( const char *desired_ip, const char *desired_port,
     window_size.ws_row = 24;
   }
 
+  /* load session snapshot, if restoring */
+  SessionSnapshot snap;
+  bool restoring = false;
+  if ( restore_path ) {
+    if ( !read_snapshot( restore_path, snap ) ) {
+      fprintf( stderr, "Could not read session snapshot %s.\n", restore_path );
+      exit( 1 );
+    }
+    restoring = true;
+    /* never reuse a nonce issued by the previous incarnation */
+    Crypto::set_unique_minimum( snap.sequence_minimum );
+    window_size.ws_col = snap.width;
+    window_size.ws_row = snap.height;
+  }
+
   /* open parser and terminal */
   Terminal::Complete terminal( window_size.ws_col, window_size.ws_row );
+  if ( restoring ) {
+    terminal.apply_string( snap.terminal_diff );
+  }
 
   /* open network */
   Network::UserStream blank;
   typedef shared::shared_ptr<ServerConnection> NetworkPointer;
-  NetworkPointer network( new ServerConnection( terminal, blank, desired_ip, desired_port ) );
+  NetworkPointer network;
+  if ( restoring ) {
+    blank.apply_string( snap.remote_diff );
+    network = NetworkPointer( new ServerConnection( terminal, blank, snap.sent_num, snap.remote_num,
+						    Crypto::Base64Key( snap.key ), desired_ip, snap.port.c_str() ) );
+    network->set_expected_receiver_seq( snap.expected_receiver_seq );
+  } else {
+    network = NetworkPointer( new ServerConnection( terminal, blank, desired_ip, desired_port ) );
+  }
 
   network->set_verbose( verbose );
   Select::set_verbose( verbose );
 
+  if ( getenv( "MOSH_NO_PADDING" ) ) {
+    network->set_padding( false ); /* save bytes on trusted/metered links */
+  }
+
+  if ( getenv( "MOSH_SERVER_LOWMEM" ) ) {
+    /* embedded gateways: cap sent-state history and free outsized
+       scratch after each send, trading retransmit efficiency for a
+       memory ceiling */
+    network->set_lowmem( true );
+  }
+
+  /* Session recording: log the terminal diff stream for later replay
+     (see src/examples/replay.cc). */
+  Network::RecordingTap tap;
+  {
+    const char *record_path = getenv( "MOSH_SERVER_RECORD" );
+    if ( record_path && *record_path ) {
+      char record_header[ 32 ];
+      snprintf( record_header, sizeof record_header, "%d %d",
+		(int)window_size.ws_col, (int)window_size.ws_row );
+      if ( tap.open( record_path, record_header ) ) {
+	network->set_tap( &tap );
+      } else {
+	fprintf( stderr, "Could not open session recording %s.\n", record_path );
+      }
+    }
+  }
+
+  /* Read-only observer: a second connection with its own port and
+     key, fed a copy of the terminal's instruction stream.  Its input
+     never reaches the host. */
+  typedef shared::shared_ptr<Network::Connection> ObserverPointer;
+  ObserverPointer observer_connection;
+  if ( observer_requested ) {
+    try {
+      observer_connection = ObserverPointer( new Network::Connection( desired_ip, desired_port ) );
+    } catch ( const Network::NetworkException &e ) {
+      /* e.g. the requested port range has no second port free */
+      fprintf( stderr, "Could not bind a port for the observer connection (%s).\n", e.what() );
+      exit( 1 );
+    }
+    network->add_mirror( observer_connection.get() );
+  }
+
   /*
    * If mosh-server is run on a pty, then typeahead may echo and break mosh.pl's
    * detection of the MOSH CONNECT message.  Print it on a new line to bodge
@@ -439,6 +724,9 @@ static int run_server( const char *desired_ip, const char *desired_port,
     puts( "\r\n" );
   }
   printf( "MOSH CONNECT %s %s\n", network->port().c_str(), network->get_key().c_str() );
+  if ( observer_connection.get() ) {
+    printf( "MOSH OBSERVE %s %s\n", observer_connection->port().c_str(), observer_connection->get_key().c_str() );
+  }
 
   /* don't let signals kill us */
   struct sigaction sa;
@@ -504,6 +792,12 @@ static int run_server( const char *desired_ip, const char *desired_port,
     }
   }
 
+#ifdef __linux__
+  /* settle this session onto one CPU before the PTY child is forked,
+     so both sides of the pipe inherit the same placement */
+  pin_to_cpu();
+#endif
+
   char utmp_entry[ 64 ] = { 0 };
   snprintf( utmp_entry, 64, "mosh [%ld]", static_cast<long int>( getpid() ) );
 
@@ -620,8 +914,15 @@ static int run_server( const char *desired_ip, const char *desired_port,
     utempter_add_record( master, utmp_entry );
 #endif
 
+    /* Pre-warm while the wrapper is still tearing down ssh and
+       launching the client: run one throwaway diff of the blank
+       screen, so the first datagram exchange doesn't pay for cold
+       allocations.  (The compressor's zlib state is per-connection
+       now and initializes itself on first use.) */
+    terminal.init_diff();
+
     try {
-      serve( master, terminal, *network, network_timeout, network_signaled_timeout );
+      serve( master, terminal, *network, observer_connection.get(), network_timeout, network_signaled_timeout );
     } catch ( const Network::NetworkException &e ) {
       fprintf( stderr, "Network exception: %s\n",
 	       e.what() );
@@ -645,7 +946,7 @@ static int run_server( const char *desired_ip, const char *desired_port,
   return 0;
 }
 
-static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &network, long network_timeout, long network_signaled_timeout )
+static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &network, Network::Connection *observer, long network_timeout, long network_signaled_timeout )
 {
   /* scale timeouts */
   const uint64_t network_timeout_ms = static_cast<uint64_t>( network_timeout ) * 1000;
@@ -655,6 +956,7 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
   sel.add_signal( SIGTERM );
   sel.add_signal( SIGINT );
   sel.add_signal( SIGUSR1 );
+  sel.add_signal( SIGUSR2 ); /* dump latency histograms */
 
   uint64_t last_remote_num = network.get_remote_state_num();
 
@@ -677,6 +979,8 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
 
   bool child_released = false;
 
+  string pending_host_input; /* bytes the host pty hasn't accepted yet */
+
   while ( true ) {
     try {
       static const uint64_t timeout_if_no_client = 60000;
@@ -711,9 +1015,22 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
       assert( fd_list.size() == 1 ); /* servers don't hop */
       int network_fd = fd_list.back();
       sel.add_fd( network_fd );
+      std::vector< int > observer_fds;
+      if ( observer ) {
+	observer_fds = observer->fds();
+	for ( std::vector< int >::const_iterator it = observer_fds.begin();
+	      it != observer_fds.end();
+	      it++ ) {
+	  sel.add_fd( *it );
+	}
+      }
       if ( !network.shutdown_in_progress() ) {
 	sel.add_fd( host_fd );
       }
+      if ( !pending_host_input.empty() ) {
+	/* wake when the full host pty will take more input */
+	sel.add_write_fd( host_fd );
+      }
 
       int active_fds = sel.select( timeout );
       if ( active_fds < 0 ) {
@@ -724,6 +1041,18 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
       now = Network::timestamp();
       uint64_t time_since_remote_state = now - network.get_latest_remote_state().timestamp;
       string terminal_to_host;
+      bool terminal_updated = false;
+
+      for ( std::vector< int >::const_iterator it = observer_fds.begin();
+	    it != observer_fds.end();
+	    it++ ) {
+	if ( sel.read( *it ) ) {
+	  /* datagrams from the observer carry acks only; input on a
+	     read-only link is ignored */
+	  network.mirror_recv();
+	  break;
+	}
+      }
 
       if ( sel.read( network_fd ) ) {
 	/* packet received from the network */
@@ -738,24 +1067,33 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
 	  us.apply_string( network.get_remote_diff() );
 	  /* apply userstream to terminal */
 	  for ( size_t i = 0; i < us.size(); i++ ) {
+	    if ( us.get_event_type( i ) == Network::CapabilityType ) {
+	      /* client advertises protocol features (e.g. binary row deltas) */
+	      terminal.set_peer_capabilities( us.get_capability( i ) );
+	      continue;
+	    }
+	    if ( us.get_event_type( i ) == Network::PasteType ) {
+	      /* bulk pasted data, one event for the whole chunk */
+	      terminal_to_host += terminal.paste( us.get_paste( i ) );
+	      continue;
+	    }
 	    const Parser::Action &action = us.get_action( i );
-	    if ( typeid( action ) == typeid( Parser::Resize ) ) {
+	    if ( action.type == Parser::Action::RESIZE ) {
 	      /* apply only the last consecutive Resize action */
 	      if ( i < us.size() - 1 ) {
 		const Parser::Action &next = us.get_action( i + 1 );
-		if ( typeid( next ) == typeid( Parser::Resize ) ) {
+		if ( next.type == Parser::Action::RESIZE ) {
 		  continue;
 		}
 	      }
 	      /* tell child process of resize */
-	      const Parser::Resize &res = static_cast<const Parser::Resize &>( action );
 	      struct winsize window_size;
 	      if ( ioctl( host_fd, TIOCGWINSZ, &window_size ) < 0 ) {
 		perror( "ioctl TIOCGWINSZ" );
 		network.start_shutdown();
 	      }
-	      window_size.ws_col = res.width;
-	      window_size.ws_row = res.height;
+	      window_size.ws_col = action.width;
+	      window_size.ws_row = action.height;
 	      if ( ioctl( host_fd, TIOCSWINSZ, &window_size ) < 0 ) {
 		perror( "ioctl TIOCSWINSZ" );
 		network.start_shutdown();
@@ -769,10 +1107,8 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
 	    terminal.register_input_frame( last_remote_num, now );
 	  }
 
-	  /* update client with new state of terminal */
-	  if ( !network.shutdown_in_progress() ) {
-	    network.set_current_state( terminal );
-	  }
+	  /* update client with new state of terminal (at tick time) */
+	  terminal_updated = true;
 	  #if defined(HAVE_SYSLOG) || defined(HAVE_UTEMPTER)
 	  #ifdef HAVE_UTEMPTER
 	  if (!connected_utmp) {
@@ -832,8 +1168,9 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
       if ( (!network.shutdown_in_progress()) && sel.read( host_fd ) ) {
 	/* input from the host needs to be fed to the terminal */
 	const int buf_size = 16384;
+	const size_t read_budget = 262144; /* bounds emulation latency per wakeup */
 	char buf[ buf_size ];
-	
+
 	/* fill buffer if possible */
 	ssize_t bytes_read = read( host_fd, buf, buf_size );
 
@@ -842,18 +1179,41 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
         if ( bytes_read <= 0 ) {
 	  network.start_shutdown();
 	} else {
-	  terminal_to_host += terminal.act( string( buf, bytes_read ) );
-	
-	  /* update client with new state of terminal */
-	  network.set_current_state( terminal );
+	  string host_data( buf, bytes_read );
+
+	  /* Keep draining while the pty has more: under bulk output,
+	     one emulation pass over a large buffer beats a select
+	     wakeup and an act() call per 16 kB chunk.  EOF or error
+	     here is left for the next wakeup to report. */
+	  while ( ( host_data.size() < read_budget )
+		  && pty_readable( host_fd ) ) {
+	    bytes_read = read( host_fd, buf, buf_size );
+	    if ( bytes_read <= 0 ) {
+	      break;
+	    }
+	    host_data.append( buf, bytes_read );
+	  }
+
+	  terminal_to_host += terminal.act( host_data );
+
+	  /* update client with new state of terminal (at tick time) */
+	  terminal_updated = true;
 	}
       }
 
       /* write user input and terminal writeback to the host */
-      if ( swrite( host_fd, terminal_to_host.c_str(), terminal_to_host.length() ) < 0 ) {
+      pending_host_input += terminal_to_host;
+      if ( !drain_host_input( host_fd, pending_host_input ) ) {
 	network.start_shutdown();
       }
 
+      /* consume before the any_signal() shutdown check below */
+      if ( sel.signal( SIGUSR2 ) ) {
+	LatencyStats::dump();
+	AllocStats::dump();
+	TransportStats::dump();
+      }
+
       bool idle_shutdown = false;
       if ( network_timeout_ms &&
 	   network_timeout_ms <= time_since_remote_state ) {
@@ -870,6 +1230,16 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
 
       if ( sel.any_signal() || idle_shutdown ) {
 	/* shutdown signal */
+	const char *snapshot_path = getenv( "MOSH_SERVER_SNAPSHOT" );
+	if ( snapshot_path && *snapshot_path
+	     && sel.signal( SIGTERM )
+	     && network.has_remote_addr()
+	     && write_snapshot( snapshot_path, network ) ) {
+	  /* Exit without the shutdown handshake; the client keeps
+	     retrying until a restored server answers on the same port. */
+	  fprintf( stderr, "Wrote session snapshot to %s.\n", snapshot_path );
+	  break;
+	}
 	if ( network.has_remote_addr() && (!network.shutdown_in_progress()) ) {
 	  network.start_shutdown();
 	} else {
@@ -906,9 +1276,9 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
       }
       #endif
 
-      if ( terminal.set_echo_ack( now ) && !network.shutdown_in_progress() ) {
-	/* update client with new echo ack */
-	network.set_current_state( terminal );
+      if ( terminal.set_echo_ack( now ) ) {
+	/* update client with new echo ack (at tick time) */
+	terminal_updated = true;
       }
 
       if ( !network.get_remote_state_num()
@@ -918,6 +1288,15 @@ static void serve( int host_fd, Terminal::Complete &terminal, ServerConnection &
         break;
       }
 
+      /* Hand the emulator's new state to the transport in one place,
+	 just before the tick: however many sources wrote to the
+	 terminal this wakeup (user input, PTY output, echo ack), the
+	 transport takes a single coherent snapshot, and emulation work
+	 never delays ack processing earlier in the loop. */
+      if ( terminal_updated && !network.shutdown_in_progress() ) {
+	network.set_current_state( terminal );
+      }
+
       network.tick();
     } catch ( const Network::NetworkException &e ) {
       fprintf( stderr, "%s\n", e.what() );
@@ -0,0 +1,81 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#ifndef SNAPSHOT_CODEC_HPP
+#define SNAPSHOT_CODEC_HPP
+
+#include <string>
+#include <string.h>
+#include <stdint.h>
+
+#include "byteorder.h"
+
+/* Serialization used by the session snapshot files written by
+   mosh-server and mosh-client: big-endian u64s and length-prefixed
+   strings. */
+
+static void put_u64( std::string &out, uint64_t x )
+{
+  uint64_t net = htobe64( x );
+  out.append( reinterpret_cast<const char *>( &net ), sizeof net );
+}
+
+static void put_string( std::string &out, const std::string &s )
+{
+  put_u64( out, s.size() );
+  out.append( s );
+}
+
+static bool get_u64( const std::string &in, size_t &pos, uint64_t &x )
+{
+  uint64_t net;
+  if ( in.size() - pos < sizeof net ) {
+    return false;
+  }
+  memcpy( &net, in.data() + pos, sizeof net );
+  pos += sizeof net;
+  x = be64toh( net );
+  return true;
+}
+
+static bool get_string( const std::string &in, size_t &pos, std::string &s )
+{
+  uint64_t len;
+  if ( !get_u64( in, pos, len ) || in.size() - pos < len ) {
+    return false;
+  }
+  s.assign( in.data() + pos, len );
+  pos += len;
+  return true;
+}
+
+#endif
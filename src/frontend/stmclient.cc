@@ -34,6 +34,7 @@
 
 #include <err.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <locale.h>
 #include <string.h>
 #include <unistd.h>
@@ -44,6 +45,7 @@
 #include <pwd.h>
 #include <signal.h>
 #include <time.h>
+#include <sys/stat.h>
 
 #if HAVE_PTY_H
 #include <pty.h>
@@ -52,7 +54,11 @@
 #endif
 
 #include "stmclient.h"
+#include "snapshotcodec.h"
 #include "swrite.h"
+#include "allocstats.h"
+#include "latencystats.h"
+#include "transportstats.h"
 #include "completeterminal.h"
 #include "user.h"
 #include "fatal_assert.h"
@@ -65,6 +71,13 @@
 
 using std::wstring;
 
+/* Format of the session cache written when MOSH_CLIENT_SNAPSHOT is
+   set: enough metadata (addressing, key, state and nonce numbering,
+   and the last remote screen) that a fresh mosh-client can resume the
+   connection without a round trip.  Mirrors the mosh-server snapshot,
+   from the client's perspective. */
+static const char client_snapshot_magic[ 8 ] = { 'M', 'O', 'S', 'H', 'C', 'S', 'N', '1' };
+
 void STMClient::resume( void )
 {
   /* Restore termios state */
@@ -78,6 +91,197 @@ void STMClient::resume( void )
 
   /* Flag that outer terminal state is unknown */
   repaint_requested = true;
+
+  /* Probe the server right away; timers scheduled before the
+     suspension may be far in the future */
+  if ( network ) {
+    network->wake();
+  }
+}
+
+bool STMClient::write_snapshot( const char *path )
+{
+  const Terminal::Complete &remote = network->get_latest_remote_state().state;
+
+  string out( client_snapshot_magic, sizeof client_snapshot_magic );
+  put_string( out, key );
+  put_string( out, ip );
+  put_string( out, port );
+  put_u64( out, remote.get_fb().ds.get_width() );
+  put_u64( out, remote.get_fb().ds.get_height() );
+  put_u64( out, network->get_sent_state_acked() );
+  put_u64( out, network->get_latest_remote_state().num );
+  put_string( out, remote.init_diff() );
+  put_u64( out, network->get_expected_receiver_seq() );
+  /* generous margin over any nonce this process may still have issued */
+  put_u64( out, Crypto::unique() + ( uint64_t( 1 ) << 20 ) );
+
+  /* The snapshot holds key material: create it unreadable by others,
+     and rename into place so a crash can't leave a partial file. */
+  string tmp_path = string( path ) + ".tmp";
+  int fd = open( tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR );
+  if ( fd < 0 ) {
+    perror( "open" );
+    return false;
+  }
+  if ( swrite( fd, out.data(), out.size() ) < 0 ) {
+    close( fd );
+    unlink( tmp_path.c_str() );
+    return false;
+  }
+  if ( close( fd ) < 0 ) {
+    perror( "close" );
+    unlink( tmp_path.c_str() );
+    return false;
+  }
+  if ( rename( tmp_path.c_str(), path ) < 0 ) {
+    perror( "rename" );
+    unlink( tmp_path.c_str() );
+    return false;
+  }
+  return true;
+}
+
+bool STMClient::restore_snapshot( const char *path )
+{
+  FILE *file = fopen( path, "rb" );
+  if ( !file ) {
+    return false; /* no cache yet: connect normally */
+  }
+  string in;
+  char buf[ 4096 ];
+  size_t n;
+  while ( (n = fread( buf, 1, sizeof buf, file )) > 0 ) {
+    in.append( buf, n );
+  }
+  bool read_ok = !ferror( file );
+  fclose( file );
+
+  string snap_key, snap_ip, snap_port, remote_diff;
+  uint64_t width, height, sent_num, remote_num, expected_receiver_seq, sequence_minimum;
+  size_t pos = sizeof client_snapshot_magic;
+  bool parse_ok = read_ok
+    && in.size() >= pos
+    && 0 == memcmp( in.data(), client_snapshot_magic, pos )
+    && get_string( in, pos, snap_key )
+    && get_string( in, pos, snap_ip )
+    && get_string( in, pos, snap_port )
+    && get_u64( in, pos, width )
+    && get_u64( in, pos, height )
+    && get_u64( in, pos, sent_num )
+    && get_u64( in, pos, remote_num )
+    && get_string( in, pos, remote_diff )
+    && get_u64( in, pos, expected_receiver_seq )
+    && get_u64( in, pos, sequence_minimum )
+    && pos == in.size();
+
+  if ( !parse_ok
+       || snap_key != key || snap_ip != ip || snap_port != port ) {
+    /* a stale cache for some other session: ignore it */
+    return false;
+  }
+
+  /* Rebuild the last remote screen so the first frame paints without
+     waiting on the server. */
+  Terminal::Complete local_terminal( width, height );
+  if ( !remote_diff.empty() ) {
+    local_terminal.apply_string( remote_diff );
+  }
+
+  Network::UserStream blank;
+  network = NetworkPointer( new NetworkType( blank, local_terminal, sent_num, remote_num,
+					     key.c_str(), ip.c_str(), port.c_str() ) );
+  network->set_expected_receiver_seq( expected_receiver_seq );
+  Crypto::set_unique_minimum( sequence_minimum );
+
+  return true;
+}
+
+/* The per-host prediction cache, gated by MOSH_PREDICTION_CACHE: one
+   line per host with the timing state the prediction engine otherwise
+   has to relearn every session (whether to display, whether to
+   underline, and the observed frame interval). */
+void STMClient::load_prediction_cache( void )
+{
+  const char *path = getenv( "MOSH_PREDICTION_CACHE" );
+  if ( !path ) {
+    return;
+  }
+  FILE *file = fopen( path, "r" );
+  if ( !file ) {
+    return; /* no cache yet */
+  }
+
+  char line[ 256 ];
+  while ( fgets( line, sizeof line, file ) ) {
+    char host[ 128 ];
+    unsigned int cached_interval, cached_glitch;
+    int cached_srtt, cached_flagging;
+    if ( ( sscanf( line, "%127s %u %d %d %u", host, &cached_interval,
+		   &cached_srtt, &cached_flagging, &cached_glitch ) == 5 )
+	 && ( ip == host ) ) {
+      overlays.get_prediction_engine().warm_start( cached_interval,
+						   cached_srtt != 0,
+						   cached_flagging != 0,
+						   cached_glitch );
+      break;
+    }
+  }
+  fclose( file );
+}
+
+void STMClient::save_prediction_cache( void )
+{
+  const char *path = getenv( "MOSH_PREDICTION_CACHE" );
+  if ( !path ) {
+    return;
+  }
+
+  /* keep the other hosts' entries */
+  std::vector< string > others;
+  FILE *file = fopen( path, "r" );
+  if ( file ) {
+    char line[ 256 ];
+    while ( fgets( line, sizeof line, file )
+	    && ( others.size() < 64 ) ) {
+      char host[ 128 ];
+      if ( ( sscanf( line, "%127s", host ) == 1 )
+	   && ( ip != host ) ) {
+	others.push_back( string( line ) );
+      }
+    }
+    fclose( file );
+  }
+
+  Overlay::PredictionEngine &engine = overlays.get_prediction_engine();
+  string tmp_path = string( path ) + ".tmp";
+  int fd = open( tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR );
+  if ( fd < 0 ) {
+    return;
+  }
+  FILE *out = fdopen( fd, "w" );
+  if ( !out ) {
+    close( fd );
+    unlink( tmp_path.c_str() );
+    return;
+  }
+  fprintf( out, "%s %u %d %d %u\n", ip.c_str(),
+	   engine.get_send_interval(),
+	   engine.get_srtt_trigger() ? 1 : 0,
+	   engine.get_flagging() ? 1 : 0,
+	   engine.get_glitch_trigger() );
+  for ( std::vector< string >::const_iterator i = others.begin();
+	i != others.end();
+	i++ ) {
+    fputs( i->c_str(), out );
+  }
+  if ( fclose( out ) < 0 ) {
+    unlink( tmp_path.c_str() );
+    return;
+  }
+  if ( rename( tmp_path.c_str(), path ) < 0 ) {
+    unlink( tmp_path.c_str() );
+  }
 }
 
 void STMClient::init( void )
@@ -190,12 +394,16 @@ void STMClient::init( void )
     wstring escape_pass_name = std::wstring(tmp.begin(), tmp.end());
     tmp = string( escape_key_name_buf );
     wstring escape_key_name = std::wstring(tmp.begin(), tmp.end());
-    escape_key_help = L"Commands: Ctrl-Z suspends, \".\" quits, " + escape_pass_name + L" gives literal " + escape_key_name;
+    escape_key_help = L"Commands: Ctrl-Z suspends, \".\" quits, \"[\"/\"]\" scroll, " + escape_pass_name + L" gives literal " + escape_key_name;
     overlays.get_notification_engine().set_escape_key_string( tmp );
   }
   wchar_t tmp[ 128 ];
   swprintf( tmp, 128, L"Nothing received from server on UDP port %s.", port.c_str() );
   connecting_notification = wstring( tmp );
+
+  /* Start the prediction engine in the mode it ended up in last time
+     we talked to this host, instead of relearning the link. */
+  load_prediction_cache();
 }
 
 void STMClient::shutdown( void )
@@ -206,14 +414,24 @@ void STMClient::shutdown( void )
   overlays.set_title_prefix( wstring( L"" ) );
   output_new_frame();
 
+  /* flush any frame bytes still queued for the terminal */
+  if ( !pending_output.empty() ) {
+    swrite( STDOUT_FILENO, pending_output.data(), pending_output.size() );
+    pending_output.clear();
+  }
+
   /* Restore terminal and terminal-driver state */
   swrite( STDOUT_FILENO, display.close().c_str() );
-  
+
   if ( tcsetattr( STDIN_FILENO, TCSANOW, &saved_termios ) < 0 ) {
     perror( "tcsetattr" );
     exit( 1 );
   }
 
+  if ( network && !still_connecting() ) {
+    save_prediction_cache();
+  }
+
   if ( still_connecting() ) {
     fprintf( stderr, "\nmosh did not make a successful connection to %s:%s.\n"
 	     "Please verify that UDP port %s is not firewalled and can reach the server.\n\n"
@@ -234,6 +452,7 @@ void STMClient::main_init( void )
   sel.add_signal( SIGHUP );
   sel.add_signal( SIGPIPE );
   sel.add_signal( SIGCONT );
+  sel.add_signal( SIGUSR2 ); /* dump latency histograms */
 
   /* get initial window size */
   if ( ioctl( STDIN_FILENO, TIOCGWINSZ, &window_size ) < 0 ) {
@@ -249,44 +468,158 @@ void STMClient::main_init( void )
   string init = display.new_frame( false, local_framebuffer, local_framebuffer );
   swrite( STDOUT_FILENO, init.data(), init.size() );
 
-  /* open network */
-  Network::UserStream blank;
-  Terminal::Complete local_terminal( window_size.ws_col, window_size.ws_row );
-  network = NetworkPointer( new NetworkType( blank, local_terminal, key.c_str(), ip.c_str(), port.c_str() ) );
+  /* open network, resuming from the session cache if one matches */
+  const char *snapshot_path = getenv( "MOSH_CLIENT_SNAPSHOT" );
+  if ( !( snapshot_path && restore_snapshot( snapshot_path ) ) ) {
+    Network::UserStream blank;
+    Terminal::Complete local_terminal( window_size.ws_col, window_size.ws_row );
+    network = NetworkPointer( new NetworkType( blank, local_terminal, key.c_str(), ip.c_str(), port.c_str() ) );
+  }
 
   network->set_send_delay( 1 ); /* minimal delay on outgoing keystrokes */
 
+  if ( getenv( "MOSH_NO_PADDING" ) ) {
+    network->set_padding( false ); /* save bytes on trusted/metered links */
+  }
+
   /* tell server the size of the terminal */
   network->get_current_state().push_back( Parser::Resize( window_size.ws_col, window_size.ws_row ) );
 
+  /* advertise support for binary row deltas and scrollback history */
+  network->get_current_state().push_capability( Terminal::Complete::CAP_ROWDELTA );
+  network->get_current_state().push_capability( Terminal::Complete::CAP_SCROLLHISTORY );
+
   /* be noisy as necessary */
   network->set_verbose( verbose );
   Select::set_verbose( verbose );
 }
 
+/* Queue bytes for the real terminal and write what it will accept. */
+void STMClient::queue_output( const string &s )
+{
+  pending_output.append( s );
+  drain_output();
+}
+
+/* Write buffered output without blocking the event loop; whatever the
+   terminal does not accept stays queued and is retried later. */
+void STMClient::drain_output( void )
+{
+  if ( pending_output.empty() ) {
+    return;
+  }
+
+  int flags = fcntl( STDOUT_FILENO, F_GETFL );
+  if ( ( flags < 0 )
+       || ( fcntl( STDOUT_FILENO, F_SETFL, flags | O_NONBLOCK ) < 0 ) ) {
+    /* fall back to a blocking write */
+    swrite( STDOUT_FILENO, pending_output.data(), pending_output.size() );
+    pending_output.clear();
+    return;
+  }
+
+  ssize_t bytes_written = write( STDOUT_FILENO, pending_output.data(),
+				 pending_output.size() );
+  int saved_errno = errno;
+
+  /* restore blocking mode; stdin may share the file description */
+  fcntl( STDOUT_FILENO, F_SETFL, flags );
+
+  if ( bytes_written > 0 ) {
+    pending_output.erase( 0, bytes_written );
+  } else if ( ( bytes_written < 0 )
+	      && ( saved_errno != EAGAIN )
+	      && ( saved_errno != EWOULDBLOCK )
+	      && ( saved_errno != EINTR ) ) {
+    errno = saved_errno;
+    perror( "write" );
+    pending_output.clear();
+  }
+}
+
 void STMClient::output_new_frame( void )
 {
   if ( !network ) { /* clean shutdown even when not initialized */
     return;
   }
 
+  if ( !pending_output.empty() ) {
+    /* The terminal hasn't accepted the last frame yet.  Skip this one:
+       once the queue drains, the next frame diffs straight from the
+       state the terminal is actually showing, coalescing everything
+       in between. */
+    drain_output();
+    if ( !pending_output.empty() ) {
+      return;
+    }
+  }
+
   /* fetch target state */
   new_state = network->get_latest_remote_state().state.get_fb();
 
-  /* apply local overlays */
-  overlays.apply( new_state );
+  if ( scrollback_offset > 0 ) {
+    /* replace the view with scrollback; no overlays while paging */
+    compose_scrollback_view( new_state );
+  } else {
+    /* apply local overlays */
+    overlays.apply( new_state );
+  }
 
   /* calculate minimal difference from where we are */
   const string diff( display.new_frame( !repaint_requested,
 					local_framebuffer,
 					new_state ) );
-  swrite( STDOUT_FILENO, diff.data(), diff.size() );
+  queue_output( diff );
 
   repaint_requested = false;
 
   local_framebuffer = new_state;
 }
 
+/* Overwrite the framebuffer with a view scrolled back by
+   scrollback_offset rows: history rows on top, then the upper part of
+   the live screen. */
+void STMClient::compose_scrollback_view( Terminal::Framebuffer &fb )
+{
+  const Terminal::Framebuffer::rows_type &history = fb.get_scrollback();
+  if ( scrollback_offset > history.size() ) {
+    scrollback_offset = history.size();
+  }
+  if ( scrollback_offset == 0 ) {
+    overlays.apply( fb );
+    return;
+  }
+
+  /* The view is composed in place from the top down, and lower view
+     rows read higher source rows, so snapshot the source first.  The
+     copy is cheap: rows are shared pointers. */
+  const Terminal::Framebuffer source( fb );
+  const int height = fb.ds.get_height();
+  const int width = fb.ds.get_width();
+
+  for ( int y = 0; y < height; y++ ) {
+    const size_t j = history.size() - scrollback_offset + y;
+    const Terminal::Row *src;
+    if ( j < history.size() ) {
+      src = history[ j ].get();
+    } else {
+      src = source.get_row( j - history.size() );
+    }
+
+    Terminal::Row *dst = fb.get_mutable_row( y );
+    int src_width = src->cells.size();
+    for ( int col = 0; col < width; col++ ) {
+      if ( col < src_width ) {
+	dst->cells[ col ] = src->cells[ col ];
+      } else {
+	fb.reset_cell( &dst->cells[ col ] );
+      }
+    }
+  }
+
+  fb.ds.cursor_visible = false;
+}
+
 void STMClient::process_network_input( void )
 {
   network->recv();
@@ -327,6 +660,20 @@ bool STMClient::process_user_input( int fd )
     overlays.get_prediction_engine().reset();
   }
 
+  if ( paste && (!quit_sequence_started)
+       && ( (escape_key <= 0)
+	    || ( memchr( buf, escape_key, bytes_read ) == NULL ) ) ) {
+    /* bulk channel: ship the whole chunk as one event instead of one
+       UserByte per octet */
+    net.get_current_state().push_paste( string( buf, bytes_read ) );
+    lf_entered = ( (buf[ bytes_read - 1 ] == 0x0A) || (buf[ bytes_read - 1 ] == 0x0D) );
+    if ( scrollback_offset > 0 ) {
+      scrollback_offset = 0; /* new input snaps back to the live screen */
+      repaint_requested = true;
+    }
+    return true;
+  }
+
   for ( int i = 0; i < bytes_read; i++ ) {
     char the_byte = buf[ i ];
 
@@ -344,6 +691,10 @@ bool STMClient::process_user_input( int fd )
 	return false;
       } else if ( the_byte == 0x1a ) { /* Suspend sequence is escape_key Ctrl-Z */
 	/* Restore terminal and terminal-driver state */
+	if ( !pending_output.empty() ) {
+	  swrite( STDOUT_FILENO, pending_output.data(), pending_output.size() );
+	  pending_output.clear();
+	}
 	swrite( STDOUT_FILENO, display.close().c_str() );
 
 	if ( tcsetattr( STDIN_FILENO, TCSANOW, &saved_termios ) < 0 ) {
@@ -359,6 +710,25 @@ bool STMClient::process_user_input( int fd )
 	kill( 0, SIGSTOP );
 
 	resume();
+      } else if ( the_byte == '[' ) { /* Page back into scrollback */
+	const Terminal::Framebuffer &fb = net.get_latest_remote_state().state.get_fb();
+	unsigned int page = fb.ds.get_height() / 2;
+	if ( page == 0 ) {
+	  page = 1;
+	}
+	scrollback_offset += page;
+	if ( scrollback_offset > fb.get_scrollback().size() ) {
+	  scrollback_offset = fb.get_scrollback().size();
+	}
+	repaint_requested = true;
+      } else if ( the_byte == ']' ) { /* Page forward toward the live screen */
+	const Terminal::Framebuffer &fb = net.get_latest_remote_state().state.get_fb();
+	unsigned int page = fb.ds.get_height() / 2;
+	if ( page == 0 ) {
+	  page = 1;
+	}
+	scrollback_offset = ( scrollback_offset > page ) ? ( scrollback_offset - page ) : 0;
+	repaint_requested = true;
       } else if ( (the_byte == escape_pass_key) || (the_byte == escape_pass_key2) ) {
 	/* Emulation sequence to type escape_key is escape_key +
 	   escape_pass_key (that is escape key without Ctrl) */
@@ -391,7 +761,12 @@ bool STMClient::process_user_input( int fd )
       repaint_requested = true;
     }
 
-    net.get_current_state().push_back( Parser::UserByte( the_byte ) );		
+    if ( scrollback_offset > 0 ) {
+      scrollback_offset = 0; /* new input snaps back to the live screen */
+      repaint_requested = true;
+    }
+
+    net.get_current_state().push_back( Parser::UserByte( the_byte ) );
   }
 
   return true;
@@ -417,6 +792,9 @@ bool STMClient::process_resize( void )
   /* tell prediction engine */
   overlays.get_prediction_engine().reset();
 
+  /* a paged-back view of the old geometry would be misleading */
+  scrollback_offset = 0;
+
   return true;
 }
 
@@ -437,6 +815,8 @@ bool STMClient::main( void )
   /* prepare to poll for events */
   Select &sel = Select::get_instance();
 
+  time_t last_wall = time( NULL );
+
   while ( 1 ) {
     try {
       output_new_frame();
@@ -448,6 +828,11 @@ bool STMClient::main( void )
 	wait_time = std::min( 250, wait_time );
       }
 
+      /* retry a stalled terminal at frame rate */
+      if ( !pending_output.empty() ) {
+	wait_time = std::min( 20, wait_time );
+      }
+
       /* poll for events */
       /* network->fd() can in theory change over time */
       sel.clear_fds();
@@ -465,6 +850,16 @@ bool STMClient::main( void )
 	break;
       }
 
+      /* The monotonic clock stops during a system suspend, so a sleep
+	 is invisible to our timers: detect it on the wall clock and
+	 probe the server right away instead of waiting out timers
+	 scheduled before the sleep. */
+      const time_t now_wall = time( NULL );
+      if ( now_wall - last_wall >= 3 ) {
+	network->wake();
+      }
+      last_wall = now_wall;
+
       bool network_ready_to_read = false;
 
       for ( std::vector< int >::const_iterator it = fd_list.begin();
@@ -498,6 +893,12 @@ bool STMClient::main( void )
 	resume();
       }
 
+      if ( sel.signal( SIGUSR2 ) ) {
+	LatencyStats::dump();
+	AllocStats::dump();
+	TransportStats::dump();
+      }
+
       if ( sel.signal( SIGTERM )
            || sel.signal( SIGINT )
            || sel.signal( SIGHUP )
@@ -506,6 +907,13 @@ bool STMClient::main( void )
         if ( !network->has_remote_addr() ) {
           break;
         } else if ( !network->shutdown_in_progress() ) {
+	  const char *snapshot_path = getenv( "MOSH_CLIENT_SNAPSHOT" );
+	  if ( snapshot_path && write_snapshot( snapshot_path ) ) {
+	    /* detach without the shutdown handshake: the server stays
+	       up, and a restarted client resumes from the cache */
+	    clean_shutdown = true;
+	    break;
+	  }
           overlays.get_notification_engine().set_notification_string( wstring( L"Signal received, shutting down..." ), true );
           network->start_shutdown();
         }
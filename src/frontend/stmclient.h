@@ -66,6 +66,12 @@ private:
   NetworkPointer network;
   Terminal::Display display;
 
+  /* frame bytes the real terminal hasn't accepted yet */
+  std::string pending_output;
+
+  /* rows paged back into scrollback; 0 = live screen */
+  unsigned int scrollback_offset;
+
   std::wstring connecting_notification;
   bool repaint_requested, lf_entered, quit_sequence_started;
   bool clean_shutdown;
@@ -77,6 +83,9 @@ private:
   bool process_resize( void );
 
   void output_new_frame( void );
+  void compose_scrollback_view( Terminal::Framebuffer &fb );
+  void queue_output( const std::string &s );
+  void drain_output( void );
 
   bool still_connecting( void ) const
   {
@@ -86,6 +95,14 @@ private:
 
   void resume( void ); /* restore state after SIGCONT */
 
+  /* cached session metadata, for reconnecting without a round trip */
+  bool write_snapshot( const char *path );
+  bool restore_snapshot( const char *path );
+
+  /* per-host prediction timing cache */
+  void load_prediction_cache( void );
+  void save_prediction_cache( void );
+
 public:
   STMClient( const char *s_ip, const char *s_port, const char *s_key, const char *predict_mode, unsigned int s_verbose, const char *predict_overwrite )
     : ip( s_ip ? s_ip : "" ), port( s_port ? s_port : "" ),
@@ -99,6 +116,8 @@ public:
       overlays(),
       network(),
       display( true ), /* use TERM environment var to initialize display */
+      pending_output(),
+      scrollback_offset( 0 ),
       connecting_notification(),
       repaint_requested( false ),
       lf_entered( false ),
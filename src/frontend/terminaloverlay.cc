@@ -37,6 +37,7 @@
 #include <limits.h>
 
 #include "terminaloverlay.h"
+#include "charwidth.h"
 
 using namespace Overlay;
 
@@ -261,7 +262,7 @@ void NotificationEngine::apply( Framebuffer &fb ) const
     }
 
     wchar_t ch = *i;
-    int chwidth = ch == L'\0' ? -1 : wcwidth( ch );
+    int chwidth = ch == L'\0' ? -1 : ::chwidth( ch );
     Cell *this_cell = 0;
 
     switch ( chwidth ) {
@@ -297,7 +298,7 @@ void NotificationEngine::apply( Framebuffer &fb ) const
     case -1: /* unprintable character */
       break;
     default:
-      assert( !"unexpected character width from wcwidth()" );
+      assert( !"unexpected character width from chwidth()" );
     }
   }
 }
@@ -362,6 +363,10 @@ void PredictionEngine::apply( Framebuffer &fb ) const
     return;
   }
 
+  if ( quiescent ) {
+    return; /* nothing to draw */
+  }
+
   for ( cursors_type::const_iterator it = cursors.begin();
 	it != cursors.end();
 	it++ ) {
@@ -411,6 +416,7 @@ void PredictionEngine::reset( void )
 {
   cursors.clear();
   overlays.clear();
+  quiescent = true;
   become_tentative();
 
   //  fprintf( stderr, "RESETTING\n" );
@@ -473,16 +479,21 @@ void PredictionEngine::cull( const Framebuffer &fb )
     flagging = true;
   }
 
+  /* Nothing was active at the last sweep and no prediction has been
+     made since; the sweep below would be a no-op. */
+  if ( quiescent ) {
+    return;
+  }
+
+  bool still_active = false;
+
   /* go through cell predictions */
 
-  overlays_type::iterator i = overlays.begin();
-  while ( i != overlays.end() ) {
-    overlays_type::iterator inext = i;
-    inext++;
-    if ( (i->row_num < 0) || (i->row_num >= fb.ds.get_height()) ) {
-      overlays.erase( i );
-      i = inext;
-      continue;
+  for ( overlays_type::iterator i = overlays.begin();
+	i != overlays.end();
+	i++ ) {
+    if ( i->overlay_cells.empty() ) {
+      continue; /* row has never held a prediction */
     }
 
     for ( overlay_cells_type::iterator j = i->overlay_cells.begin();
@@ -501,10 +512,13 @@ void PredictionEngine::cull( const Framebuffer &fb )
 		   );
 	  */
 
+	  anchor_streak = 0; /* the echo anchor lied; stop trusting it */
+
 	  if ( display_preference == Experimental ) {
 	    j->reset();
 	  } else {
 	    kill_epoch( j->tentative_until_epoch, fb );
+	    still_active = true; /* kill_epoch only resets tentative cells */
 	  }
 	  /*
 	  if ( j->display_time != uint64_t(-1) ) {
@@ -525,6 +539,8 @@ void PredictionEngine::cull( const Framebuffer &fb )
 	  }
 	  */
 
+	  anchor_streak = 0;
+
 	  if ( display_preference == Experimental ) {
 	    j->reset();
 	  } else {
@@ -543,6 +559,11 @@ void PredictionEngine::cull( const Framebuffer &fb )
 	if ( j->tentative_until_epoch > confirmed_epoch ) {
 	  confirmed_epoch = j->tentative_until_epoch;
 
+	  /* another whole epoch echoed where the anchor said it would */
+	  if ( anchor_streak < ANCHOR_TRUST_THRESHOLD ) {
+	    anchor_streak++;
+	  }
+
 	  /*
 	  fprintf( stderr, "%lc in (%d,%d) confirms epoch %lu (predicting in epoch %lu)\n",
 		   j->replacement.debug_contents(), i->row_num, j->col,
@@ -574,6 +595,8 @@ void PredictionEngine::cull( const Framebuffer &fb )
 
 	break;
       case Pending:
+	still_active = true;
+
 	/* When a prediction takes a long time to be confirmed, we
 	   activate the predictions even if SRTT is low */
 	if ( (now - j->prediction_time) >= GLITCH_FLAG_THRESHOLD ) {
@@ -588,8 +611,6 @@ void PredictionEngine::cull( const Framebuffer &fb )
 	break;
       }
     }
-
-    i = inext;
   }
 
   /* go through cursor predictions */
@@ -605,6 +626,8 @@ void PredictionEngine::cull( const Framebuffer &fb )
       cursor().expiration_time,
       now );
     */
+    anchor_streak = 0;
+
     if ( display_preference == Experimental ) {
       cursors.clear();
     } else {
@@ -623,30 +646,29 @@ void PredictionEngine::cull( const Framebuffer &fb )
       it++;
     }
   }
+
+  quiescent = (!still_active) && cursors.empty();
 }
 
 ConditionalOverlayRow & PredictionEngine::get_or_make_row( int row_num, int num_cols )
 {
-  overlays_type::iterator it;
+  assert( row_num >= 0 );
 
-  for ( it = overlays.begin(); it != overlays.end(); it++ ) {
-    if ( it->row_num == row_num ) {
-      break;
-    }
+  /* grow the flat storage to cover the row, then index directly */
+  while ( (int)overlays.size() <= row_num ) {
+    overlays.push_back( ConditionalOverlayRow( (int)overlays.size() ) );
   }
 
-  if ( it != overlays.end() ) {
-    return *it;
-  }
-  /* make row */
-  ConditionalOverlayRow r( row_num );
-  r.overlay_cells.reserve( num_cols );
-  for ( int i = 0; i < num_cols; i++ ) {
-    r.overlay_cells.push_back( ConditionalOverlayCell( 0, i, prediction_epoch ) );
-    assert( r.overlay_cells[ i ].col == i );
+  ConditionalOverlayRow &the_row = overlays[ row_num ];
+  if ( the_row.overlay_cells.empty() ) {
+    /* populate cells on first use */
+    the_row.overlay_cells.reserve( num_cols );
+    for ( int i = 0; i < num_cols; i++ ) {
+      the_row.overlay_cells.push_back( ConditionalOverlayCell( 0, i, prediction_epoch ) );
+      assert( the_row.overlay_cells[ i ].col == i );
+    }
   }
-  overlays.push_back( r );
-  return overlays.back();
+  return the_row;
 }
 
 void PredictionEngine::new_user_byte( char the_byte, const Framebuffer &fb )
@@ -656,10 +678,21 @@ void PredictionEngine::new_user_byte( char the_byte, const Framebuffer &fb )
   }
   if ( display_preference == Experimental ) {
     prediction_epoch = confirmed_epoch;
+  } else if ( anchor_streak >= ANCHOR_TRUST_THRESHOLD ) {
+    /* The application has echoed ANCHOR_TRUST_THRESHOLD epochs in a
+       row exactly where the cursor anchor predicted, so display this
+       epoch's predictions immediately instead of withholding them
+       until one is confirmed.  Unlike Experimental mode, a single
+       misprediction zeroes the streak (in cull()) and restores the
+       conservative wait-for-confirmation behavior. */
+    prediction_epoch = confirmed_epoch;
   }
 
   cull( fb );
 
+  /* anything we predict below must be swept again */
+  quiescent = false;
+
   uint64_t now = timestamp();
 
   /* translate application-mode cursor control function to ANSI cursor control sequence */
@@ -675,15 +708,14 @@ void PredictionEngine::new_user_byte( char the_byte, const Framebuffer &fb )
   for ( Parser::Actions::iterator it = actions.begin();
         it != actions.end();
         it++ ) {
-    Parser::Action& act = **it;
+    Parser::Action& act = *it;
 
     /*
     fprintf( stderr, "Action: %s (%lc)\n",
-	     act->name().c_str(), act->char_present ? act->ch : L'_' );
+	     act.name().c_str(), act.char_present ? act.ch : L'_' );
     */
 
-    const std::type_info& type_act = typeid( act );
-    if ( type_act == typeid( Parser::Print ) ) {
+    if ( act.type == Parser::Action::PRINT ) {
       /* make new prediction */
 
       init_cursor( fb );
@@ -743,7 +775,7 @@ void PredictionEngine::new_user_byte( char the_byte, const Framebuffer &fb )
 	    }
 	  }
 	}
-      } else if ( (ch < 0x20) || (wcwidth( ch ) != 1) ) {
+      } else if ( (ch < 0x20) || (::chwidth( ch ) != 1) ) {
 	/* unknown print */
 	become_tentative();
 	//	fprintf( stderr, "Unknown print 0x%x\n", ch );
@@ -828,7 +860,7 @@ void PredictionEngine::new_user_byte( char the_byte, const Framebuffer &fb )
 	  newline_carriage_return( fb );
 	}
       }
-    } else if ( type_act == typeid( Parser::Execute ) ) {
+    } else if ( act.type == Parser::Action::EXECUTE ) {
       if ( act.char_present && (act.ch == 0x0d) /* CR */ ) {
 	become_tentative();
 	newline_carriage_return( fb );
@@ -836,10 +868,10 @@ void PredictionEngine::new_user_byte( char the_byte, const Framebuffer &fb )
 	//	fprintf( stderr, "Execute 0x%x\n", act.ch );
 	become_tentative();	
       }
-    } else if ( type_act == typeid( Parser::Esc_Dispatch ) ) {
+    } else if ( act.type == Parser::Action::ESC_DISPATCH ) {
       //      fprintf( stderr, "Escape sequence\n" );
       become_tentative();
-    } else if ( type_act == typeid( Parser::CSI_Dispatch ) ) {
+    } else if ( act.type == Parser::Action::CSI_DISPATCH ) {
       if ( act.char_present && (act.ch == L'C') ) { /* right arrow */
 	init_cursor( fb );
 	if ( cursor().col < fb.ds.get_width() - 1 ) {
@@ -912,6 +944,10 @@ void PredictionEngine::become_tentative( void )
 
 bool PredictionEngine::active( void ) const
 {
+  if ( quiescent ) {
+    return false;
+  }
+
   if ( !cursors.empty() ) {
     return true;
   }
@@ -212,10 +212,17 @@ namespace Overlay {
 
     static const uint64_t GLITCH_FLAG_THRESHOLD = 5000; /* prediction outstanding this long => underline */
 
+    static const unsigned int ANCHOR_TRUST_THRESHOLD = 4; /* consecutive confirmed epochs before
+							     tentative predictions show immediately */
+
     char last_byte;
     Parser::UTF8Parser parser;
 
-    typedef list<ConditionalOverlayRow> overlays_type;
+    /* flat, indexed by row number.  A row whose overlay_cells is empty
+       has never held a prediction; rows are invalidated by resetting
+       their cells (the epoch machinery), never erased, so every lookup
+       is a direct index. */
+    typedef vector<ConditionalOverlayRow> overlays_type;
     overlays_type overlays;
 
     typedef list<ConditionalCursorMove> cursors_type;
@@ -239,6 +246,20 @@ namespace Overlay {
     unsigned int glitch_trigger; /* show predictions temporarily because of long-pending prediction */
     uint64_t last_quick_confirmation;
 
+    /* Learned echo anchor for full-screen applications.  Every control
+       key opens a fresh tentative epoch, and tentative predictions are
+       normally withheld until the server confirms one -- which in an
+       editor, where control keys interleave with every burst of
+       typing, starves the user of predictions entirely.  Count how
+       many consecutive epochs the application has echoed our glyphs
+       exactly where the cursor anchor predicted; once the mapping has
+       proven stable, trust new epochs on sight.  Any misprediction
+       zeroes the streak and we fall back to waiting for confirmation. */
+    unsigned int anchor_streak;
+    bool quiescent; /* no active predictions at last cull; lets apply()
+		       and cull() skip the full-screen sweep, which is
+		       the common case at every tick in steady state */
+
     ConditionalCursorMove & cursor( void ) { assert( !cursors.empty() ); return cursors.back(); }
 
     void kill_epoch( uint64_t epoch, const Framebuffer &fb );
@@ -284,6 +305,22 @@ namespace Overlay {
 
     void set_send_interval( unsigned int x ) { send_interval = x; }
 
+    /* Seed timing state from the per-host cache, so reconnecting to a
+       known-slow host doesn't flicker through warm-up; and read it
+       back out when the session ends. */
+    void warm_start( unsigned int s_send_interval, bool s_srtt_trigger,
+		     bool s_flagging, unsigned int s_glitch_trigger )
+    {
+      send_interval = s_send_interval;
+      srtt_trigger = s_srtt_trigger;
+      flagging = s_flagging;
+      glitch_trigger = s_glitch_trigger;
+    }
+    unsigned int get_send_interval( void ) const { return send_interval; }
+    bool get_srtt_trigger( void ) const { return srtt_trigger; }
+    bool get_flagging( void ) const { return flagging; }
+    unsigned int get_glitch_trigger( void ) const { return glitch_trigger; }
+
     int wait_time( void ) const
     {
       return ( timing_tests_necessary() && active() )
@@ -299,6 +336,8 @@ namespace Overlay {
 			       srtt_trigger( false ),
 			       glitch_trigger( 0 ),
 			       last_quick_confirmation( 0 ),
+			       anchor_streak( 0 ),
+			       quiescent( true ),
 			       send_interval( 250 ),
 			       last_height( 0 ), last_width( 0 ),
 			       display_preference( Adaptive ),
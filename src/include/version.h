@@ -0,0 +1 @@
+#define BUILD_VERSION "2b6f512"
@@ -30,35 +30,201 @@
     also delete it here.
 */
 
+#include <algorithm>
+
+#include <string.h>
 #include <zlib.h>
 
 #include "compressor.h"
 #include "dos_assert.h"
+#include "fatal_assert.h"
 
 using namespace Network;
 using std::string;
 
+/* Grow the scratch buffer in whole pages: regrowth stays rare, and
+   the hot region never ends mid-page where the allocator could hand
+   the tail cache lines to an unrelated allocation. */
+static size_t round_up_page( size_t n )
+{
+  return ( n + 4095 ) & ~size_t( 4095 );
+}
+
+Compressor::Compressor()
+  : buffer(), deflate_stream(), inflate_stream(),
+    deflate_ready( false ), inflate_ready( false )
+{
+}
+
+Compressor::Compressor( const Compressor & )
+  : buffer(), deflate_stream(), inflate_stream(),
+    deflate_ready( false ), inflate_ready( false )
+{
+}
+
+Compressor & Compressor::operator=( const Compressor & )
+{
+  return *this;
+}
+
+Compressor::~Compressor()
+{
+  if ( deflate_ready ) {
+    deflateEnd( &deflate_stream );
+  }
+  if ( inflate_ready ) {
+    inflateEnd( &inflate_stream );
+  }
+}
+
+void Compressor::ensure_deflate( void )
+{
+  if ( !deflate_ready ) {
+    fatal_assert( Z_OK == deflateInit( &deflate_stream, Z_DEFAULT_COMPRESSION ) );
+    deflate_ready = true;
+  }
+}
+
+void Compressor::ensure_inflate( void )
+{
+  if ( !inflate_ready ) {
+    fatal_assert( Z_OK == inflateInit( &inflate_stream ) );
+    inflate_ready = true;
+  }
+}
+
+void Compressor::trim( size_t cap )
+{
+  if ( buffer.capacity() > cap ) {
+    /* contents are per-call scratch, so just drop the allocation */
+    std::vector<unsigned char>().swap( buffer );
+  }
+}
+
+size_t Compressor::deflate_with( z_stream &stream, const string &input )
+{
+  ensure_deflate();
+  dos_assert( Z_OK == deflateReset( &stream ) );
+
+  const size_t bound = deflateBound( &stream, input.size() );
+  if ( buffer.size() < bound ) {
+    buffer.resize( round_up_page( bound ) );
+  }
+
+  stream.next_in = reinterpret_cast<Bytef *>( const_cast<char *>( input.data() ) );
+  stream.avail_in = input.size();
+  stream.next_out = &buffer[ 0 ];
+  stream.avail_out = buffer.size();
+
+  dos_assert( Z_STREAM_END == deflate( &stream, Z_FINISH ) );
+
+  return buffer.size() - stream.avail_out;
+}
+
+/* Frame input as zlib stored blocks by hand, into the scratch buffer:
+   byte-identical role to a level-0 deflate stream, without keeping a
+   second 256 kB deflate state around for it. */
+const unsigned char *Compressor::stored_view( const string &input, size_t &len )
+{
+  const size_t needed = input.size() + STORED_OVERHEAD
+    + 5 * ( input.size() / 65535 );
+  if ( buffer.size() < needed ) {
+    buffer.resize( round_up_page( needed ) );
+  }
+
+  size_t out = 0;
+  buffer[ out++ ] = 0x78; /* CMF: deflate, 32K window */
+  buffer[ out++ ] = 0x01; /* FLG: no dictionary, checks out mod 31 */
+
+  size_t pos = 0;
+  do {
+    const size_t chunk = std::min( input.size() - pos, size_t( 65535 ) );
+    const bool final_block = ( pos + chunk == input.size() );
+    buffer[ out++ ] = final_block ? 0x01 : 0x00; /* BFINAL, BTYPE=00 */
+    buffer[ out++ ] = chunk & 0xff;
+    buffer[ out++ ] = ( chunk >> 8 ) & 0xff;
+    buffer[ out++ ] = ~chunk & 0xff;
+    buffer[ out++ ] = ( ~chunk >> 8 ) & 0xff;
+    memcpy( &buffer[ out ], input.data() + pos, chunk );
+    out += chunk;
+    pos += chunk;
+  } while ( pos < input.size() );
+
+  const uLong adler = adler32( adler32( 0L, Z_NULL, 0 ),
+			       reinterpret_cast<const Bytef *>( input.data() ),
+			       input.size() );
+  buffer[ out++ ] = ( adler >> 24 ) & 0xff;
+  buffer[ out++ ] = ( adler >> 16 ) & 0xff;
+  buffer[ out++ ] = ( adler >> 8 ) & 0xff;
+  buffer[ out++ ] = adler & 0xff;
+
+  len = out;
+  return &buffer[ 0 ];
+}
+
+const unsigned char *Compressor::compress_view( const string &input, size_t &len )
+{
+  /* Tiny payloads -- keystroke echoes, acks -- skip compression
+     entirely; everything else is compressed, but kept only if that
+     beat a stored block.  Either way the output is an ordinary zlib
+     stream, so the receiver needs no signaling. */
+  if ( input.size() < COMPRESSION_THRESHOLD ) {
+    return stored_view( input, len );
+  }
+
+  const size_t deflated = deflate_with( deflate_stream, input );
+  if ( deflated >= input.size() + STORED_OVERHEAD ) {
+    return stored_view( input, len );
+  }
+
+  len = deflated;
+  return &buffer[ 0 ];
+}
+
 string Compressor::compress_str( const string &input )
 {
-  long unsigned int len = BUFFER_SIZE;
-  dos_assert( Z_OK == compress( buffer, &len,
-				reinterpret_cast<const unsigned char *>( input.data() ),
-				input.size() ) );
-  return string( reinterpret_cast<char *>( buffer ), len );
+  size_t len = 0;
+  const unsigned char *data = compress_view( input, len );
+  return string( reinterpret_cast<const char *>( data ), len );
 }
 
 string Compressor::uncompress_str( const string &input )
 {
-  long unsigned int len = BUFFER_SIZE;
-  dos_assert( Z_OK == uncompress( buffer, &len,
-				  reinterpret_cast<const unsigned char *>( input.data() ),
-				  input.size() ) );
-  return string( reinterpret_cast<char *>( buffer ), len );
+  size_t len = 0;
+  const unsigned char *data = uncompress_view( input, len );
+  return string( reinterpret_cast<const char *>( data ), len );
 }
 
-/* construct on first use */
-Compressor & Network::get_compressor( void )
+const unsigned char *Compressor::uncompress_view( const string &input, size_t &len )
 {
-  static Compressor the_compressor;
-  return the_compressor;
+  ensure_inflate();
+  dos_assert( Z_OK == inflateReset( &inflate_stream ) );
+
+  if ( buffer.size() < 16384 ) {
+    buffer.resize( 16384 );
+  }
+
+  inflate_stream.next_in = reinterpret_cast<Bytef *>( const_cast<char *>( input.data() ) );
+  inflate_stream.avail_in = input.size();
+
+  /* Grow the output space as needed, still bounded: hostile input
+     can't make us allocate more than the old fixed-size buffer. */
+  size_t have = 0;
+  for ( ;; ) {
+    inflate_stream.next_out = &buffer[ have ];
+    inflate_stream.avail_out = buffer.size() - have;
+
+    const int ret = inflate( &inflate_stream, Z_FINISH );
+    have = buffer.size() - inflate_stream.avail_out;
+
+    if ( ret == Z_STREAM_END ) {
+      break;
+    }
+    dos_assert( ( ret == Z_OK ) || ( ret == Z_BUF_ERROR ) );
+    dos_assert( buffer.size() < BUFFER_SIZE ); /* room left to grow */
+    buffer.resize( std::min( buffer.size() * 2, BUFFER_SIZE ) );
+  }
+
+  len = have;
+  return &buffer[ 0 ];
 }
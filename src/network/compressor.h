@@ -34,27 +34,67 @@
 #define COMPRESSOR_H
 
 #include <string>
+#include <vector>
+
+#include <zlib.h>
 
 namespace Network {
   class Compressor {
   private:
-    static const int BUFFER_SIZE = 2048 * 2048; /* effective limit on terminal size */
+    static const size_t BUFFER_SIZE = 2048 * 2048; /* decompression growth limit;
+						      effective limit on terminal size */
+
+    /* scratch space, grown on demand instead of a fixed 4 MB array:
+       a mostly idle session keeps only what its diffs have needed */
+    std::vector<unsigned char> buffer;
+
+    /* Persistent streams, reset per message: every diff used to pay
+       for allocating and tearing down the zlib state via the one-shot
+       compress()/uncompress() wrappers.  The wire format is
+       unchanged.  The states themselves (a quarter megabyte for
+       deflate) are allocated on first use, so a context that only
+       ever inflates never pays for a deflate state and vice versa. */
+    z_stream deflate_stream;
+    z_stream inflate_stream;
+    bool deflate_ready;
+    bool inflate_ready;
+    void ensure_deflate( void );
+    void ensure_inflate( void );
+
+    /* Inputs this small can't repay the cost (in bytes or cycles) of
+       actual compression; they go straight to a stored block, which
+       is still a well-formed zlib stream for any peer. */
+    static const size_t COMPRESSION_THRESHOLD = 32;
 
-    unsigned char buffer[BUFFER_SIZE];
+    /* zlib framing overhead of a stored block: 2-byte header,
+       5-byte block header, 4-byte checksum */
+    static const size_t STORED_OVERHEAD = 11;
+
+    size_t deflate_with( z_stream &stream, const std::string &input );
+    const unsigned char *stored_view( const std::string &input, size_t &len );
 
   public:
-  Compressor() : buffer() {}
-    ~Compressor() {}
+    Compressor();
+    ~Compressor();
 
     std::string compress_str( const std::string &input );
     std::string uncompress_str( const std::string &input );
 
-    /* unused */
+    /* Return scratch beyond cap to the allocator (bounded-memory
+       hosts); the buffer regrows on demand. */
+    void trim( size_t cap );
+
+    /* Zero-copy variants: the output stays in the scratch buffer,
+       valid until the next compress or uncompress call. */
+    const unsigned char *compress_view( const std::string &input, size_t &len );
+    const unsigned char *uncompress_view( const std::string &input, size_t &len );
+
+    /* Copies start fresh: stream state is reset per message and the
+       scratch never outlives a call, so there is nothing worth
+       carrying over (and zlib streams can't be copied anyway). */
     Compressor( const Compressor & );
     Compressor & operator=( const Compressor & );
   };
-
-  Compressor & get_compressor( void );
 }
 
 #endif
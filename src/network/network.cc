@@ -39,11 +39,18 @@
 #endif
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #include <assert.h>
 #include <errno.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#ifdef HAVE_GETIFADDRS
+#include <ifaddrs.h>
+#include <net/if.h>
+#endif
+
 #include "dos_assert.h"
 #include "fatal_assert.h"
 #include "byteorder.h"
@@ -51,6 +58,9 @@
 #include "crypto.h"
 
 #include "timestamp.h"
+#include "allocstats.h"
+#include "latencystats.h"
+#include "transportstats.h"
 
 #ifndef MSG_DONTWAIT
 #define MSG_DONTWAIT MSG_NONBLOCK
@@ -83,6 +93,22 @@ Packet::Packet( const Message & message )
   payload = string( message.text.begin() + 2 * sizeof( uint16_t ), message.text.end() );
 }
 
+Packet::Packet( uint64_t nonce_val, const char *text, size_t text_len )
+  : seq( nonce_val & SEQUENCE_MASK ),
+    direction( (nonce_val & DIRECTION_MASK) ? TO_CLIENT : TO_SERVER ),
+    timestamp( -1 ),
+    timestamp_reply( -1 ),
+    payload()
+{
+  dos_assert( text_len >= 2 * sizeof( uint16_t ) );
+
+  const uint16_t *data = (const uint16_t *)text;
+  timestamp = be16toh( data[ 0 ] );
+  timestamp_reply = be16toh( data[ 1 ] );
+
+  payload = string( text + 2 * sizeof( uint16_t ), text_len - 2 * sizeof( uint16_t ) );
+}
+
 /* Output from packet */
 Message Packet::toMessage( void )
 {
@@ -96,7 +122,7 @@ Message Packet::toMessage( void )
   return Message( Nonce( direction_seq ), timestamps + payload );
 }
 
-Packet Connection::new_packet( const string &s_payload )
+const string & Connection::encrypt_payload( const string &s_payload )
 {
   uint16_t outgoing_timestamp_reply = -1;
 
@@ -109,9 +135,18 @@ Packet Connection::new_packet( const string &s_payload )
     saved_timestamp_received_at = 0;
   }
 
-  Packet p( direction, timestamp16(), outgoing_timestamp_reply, s_payload );
+  uint64_t direction_seq = (uint64_t( direction == TO_CLIENT ) << 63)
+    | (Crypto::unique() & SEQUENCE_MASK);
+
+  uint16_t ts_net[ 2 ] = { static_cast<uint16_t>( htobe16( timestamp16() ) ),
+                           static_cast<uint16_t>( htobe16( outgoing_timestamp_reply ) ) };
+
+  /* The timestamp header and the payload are gathered straight into
+     the cipher's buffer; no Packet or Message string is built. */
+  Span spans[ 2 ] = { Span( (const char *)ts_net, sizeof( ts_net ) ),
+		      Span( s_payload.data(), s_payload.size() ) };
 
-  return p;
+  return session.encrypt( Nonce( direction_seq ), spans, 2 );
 }
 
 void Connection::hop_port( void )
@@ -155,6 +190,27 @@ Connection::Socket::Socket( int family )
     throw NetworkException( "socket", errno );
   }
 
+  set_options( family );
+}
+
+Connection::Socket::Socket( int family, const struct sockaddr *local_addr, socklen_t local_addr_len )
+  : _fd( socket( family, SOCK_DGRAM, 0 ) )
+{
+  if ( _fd < 0 ) {
+    throw NetworkException( "socket", errno );
+  }
+
+  if ( bind( _fd, local_addr, local_addr_len ) < 0 ) {
+    int saved_errno = errno;
+    close( _fd );
+    throw NetworkException( "bind", saved_errno );
+  }
+
+  set_options( family );
+}
+
+void Connection::Socket::set_options( int family )
+{
   /* Disable path MTU discovery */
 #ifdef HAVE_IP_MTU_DISCOVER
   int flag = IP_PMTUDISC_DONT;
@@ -177,6 +233,14 @@ Connection::Socket::Socket( int family )
     perror( "setsockopt( IP_RECVTOS )" );
   }
 #endif
+
+  /* Linux generic receive offload: let the kernel coalesce a burst of
+     equal-sized datagrams into one buffer, announced per-recvmsg() in
+     a UDP_GRO cmsg.  Best-effort; old kernels just say no. */
+#ifdef UDP_GRO
+  int groflag = true;
+  setsockopt( _fd, IPPROTO_UDP, UDP_GRO, &groflag, sizeof groflag );
+#endif
 }
 
 void Connection::setup( void )
@@ -194,6 +258,12 @@ const std::vector< int > Connection::fds( void ) const
     ret.push_back( it->fd() );
   }
 
+  for ( std::deque< Socket >::const_iterator it = path_socks.begin();
+	it != path_socks.end();
+	it++ ) {
+    ret.push_back( it->fd() );
+  }
+
   return ret;
 }
 
@@ -209,6 +279,141 @@ void Connection::set_MTU( int family )
   default:
     throw NetworkException( "Unknown address family", 0 );
   }
+
+  /* any discovered larger MTU belonged to the old path; probe the new
+     one from scratch */
+  probe_MTU = 0;
+  probe_tries = 0;
+  probe_rung = 0;
+  next_probe_time = timestamp();
+}
+
+/* Wire sizes tried by path MTU probing: Ethernet, then common jumbo
+   steps up to the 9000-byte datacenter standard. */
+static const int PROBE_MTU_LADDER[] = { 1500, 2992, 4464, 8950 };
+
+/* Set or clear don't-fragment on a socket.  Returns false where the
+   platform can't, in which case probing would be meaningless: the
+   probe would be fragmented by IP and "succeed" on any path. */
+static bool set_DF( int fd, int family, bool df )
+{
+  if ( family == AF_INET6 ) {
+#ifdef IPV6_MTU_DISCOVER
+    int flag = df ? IPV6_PMTUDISC_DO : IPV6_PMTUDISC_DONT;
+    return setsockopt( fd, IPPROTO_IPV6, IPV6_MTU_DISCOVER, &flag, sizeof flag ) == 0;
+#else
+    return false;
+#endif
+  }
+#ifdef HAVE_IP_MTU_DISCOVER
+  int flag = df ? IP_PMTUDISC_DO : IP_PMTUDISC_DONT;
+  return setsockopt( fd, IPPROTO_IP, IP_MTU_DISCOVER, &flag, sizeof flag ) == 0;
+#else
+  return false;
+#endif
+}
+
+size_t Connection::probe_payload_size( void )
+{
+  if ( !has_remote_addr || !RTT_hit
+       || ( probe_MTU != 0 )
+       || ( timestamp() < next_probe_time ) ) {
+    return 0;
+  }
+
+  /* can we even mark the probe don't-fragment? */
+  const bool v6 = ( remote_addr.sa.sa_family == AF_INET6 );
+#ifndef IPV6_MTU_DISCOVER
+  if ( v6 ) { return 0; }
+#endif
+#ifndef HAVE_IP_MTU_DISCOVER
+  if ( !v6 ) { return 0; }
+#endif
+
+  const int header_len = v6 ? IPV6_HEADER_LEN : IPV4_HEADER_LEN;
+  const int num_rungs = sizeof( PROBE_MTU_LADDER ) / sizeof( PROBE_MTU_LADDER[ 0 ] );
+
+  /* skip rungs the working MTU already covers, e.g. after a restore */
+  while ( ( probe_rung < num_rungs )
+	  && ( PROBE_MTU_LADDER[ probe_rung ] - header_len <= MTU ) ) {
+    probe_rung++;
+  }
+
+  if ( probe_rung >= num_rungs ) {
+    return 0; /* already at the top of the ladder */
+  }
+
+  /* the plaintext size whose ciphertext lands at the rung's size */
+  return PROBE_MTU_LADDER[ probe_rung ] - header_len
+    - ADDED_BYTES - Session::ADDED_BYTES;
+}
+
+/* One don't-fragment datagram at the candidate size.  Returns false
+   if it could not be sent at all (e.g. over the local interface MTU),
+   in which case nothing is in flight. */
+bool Connection::send_probe( const string & s )
+{
+  if ( !has_remote_addr ) {
+    return false;
+  }
+
+  const string & p = encrypt_payload( s );
+
+  if ( static_cast<int>( p.size() ) <= MTU ) {
+    return false; /* nothing to learn at this size */
+  }
+
+  if ( !set_DF( sock(), remote_addr.sa.sa_family, true ) ) {
+    return false;
+  }
+
+  ssize_t bytes_sent = sendto( sock(), p.data(), p.size(), MSG_DONTWAIT,
+			       &remote_addr.sa, remote_addr_len );
+
+  set_DF( sock(), remote_addr.sa.sa_family, false );
+
+  if ( bytes_sent != static_cast<ssize_t>( p.size() ) ) {
+    if ( errno == EMSGSIZE ) {
+      /* the local interface can't even emit this size */
+      probe_tries = 0;
+      next_probe_time = timestamp() + MTU_REPROBE_INTERVAL;
+    }
+    return false;
+  }
+
+  TransportStats::counters.packets_sent++;
+  TransportStats::counters.bytes_sent += p.size();
+
+  probe_MTU = p.size(); /* the verified size is what actually went out */
+  return true;
+}
+
+/* The transport's verdict on the probe in flight. */
+void Connection::probe_result( bool arrived )
+{
+  if ( probe_MTU == 0 ) {
+    return; /* e.g. reset by roaming while the probe was in flight */
+  }
+
+  uint64_t now = timestamp();
+  if ( arrived ) {
+    /* Adopt the verified size and climb.  The rung is done even
+       though padding granularity leaves the probe slightly under the
+       rung's full size. */
+    MTU = probe_MTU;
+    probe_rung++;
+    probe_tries = 0;
+    next_probe_time = now;
+  } else {
+    probe_tries++;
+    if ( probe_tries >= MTU_PROBE_TRIES ) {
+      /* the rung doesn't fit the path (or the session is too busy to
+	 tell); leave the working MTU alone for a while */
+      probe_tries = 0;
+      next_probe_time = now + MTU_REPROBE_INTERVAL;
+    }
+  }
+  probe_MTU = 0;
 }
 
 class AddrInfo {
@@ -233,8 +438,13 @@ Connection::Connection( const char *desired_ip, const char *desired_port ) /* se
     has_remote_addr( false ),
     remote_addr(),
     remote_addr_len( 0 ),
+    candidates(),
     server( true ),
     MTU( DEFAULT_SEND_MTU ),
+    probe_MTU( 0 ),
+    probe_tries( 0 ),
+    probe_rung( 0 ),
+    next_probe_time( 0 ),
     key(),
     session( key ),
     direction( TO_CLIENT ),
@@ -247,7 +457,55 @@ Connection::Connection( const char *desired_ip, const char *desired_port ) /* se
     RTT_hit( false ),
     SRTT( 1000 ),
     RTTVAR( 500 ),
-    send_error()
+    min_RTT( 1000 ),
+    min_RTT_received_at( 0 ),
+    send_error(),
+    receive_queue(),
+    multipath( false ),
+    path_socks(),
+    path_RTT(),
+    udp_gso_state( -1 )
+{
+  setup_server( desired_ip, desired_port );
+}
+
+Connection::Connection( const Base64Key &s_key, const char *desired_ip, const char *desired_port ) /* server restored from a snapshot */
+  : socks(),
+    has_remote_addr( false ),
+    remote_addr(),
+    remote_addr_len( 0 ),
+    candidates(),
+    server( true ),
+    MTU( DEFAULT_SEND_MTU ),
+    probe_MTU( 0 ),
+    probe_tries( 0 ),
+    probe_rung( 0 ),
+    next_probe_time( 0 ),
+    key( s_key ),
+    session( key ),
+    direction( TO_CLIENT ),
+    saved_timestamp( -1 ),
+    saved_timestamp_received_at( 0 ),
+    expected_receiver_seq( 0 ),
+    last_heard( -1 ),
+    last_port_choice( -1 ),
+    last_roundtrip_success( -1 ),
+    RTT_hit( false ),
+    SRTT( 1000 ),
+    RTTVAR( 500 ),
+    min_RTT( 1000 ),
+    min_RTT_received_at( 0 ),
+    send_error(),
+    receive_queue(),
+    multipath( false ),
+    path_socks(),
+    path_RTT(),
+    udp_gso_state( -1 )
+{
+  setup_server( desired_ip, desired_port );
+}
+
+void Connection::setup_server( const char *desired_ip, const char *desired_port )
 {
   setup();
 
@@ -355,8 +613,13 @@ Connection::Connection( const char *key_str, const char *ip, const char *port )
     has_remote_addr( false ),
     remote_addr(),
     remote_addr_len( 0 ),
+    candidates(),
     server( false ),
     MTU( DEFAULT_SEND_MTU ),
+    probe_MTU( 0 ),
+    probe_tries( 0 ),
+    probe_rung( 0 ),
+    next_probe_time( 0 ),
     key( key_str ),
     session( key ),
     direction( TO_SERVER ),
@@ -369,7 +632,14 @@ Connection::Connection( const char *key_str, const char *ip, const char *port )
     RTT_hit( false ),
     SRTT( 1000 ),
     RTTVAR( 500 ),
-    send_error()
+    min_RTT( 1000 ),
+    min_RTT_received_at( 0 ),
+    send_error(),
+    receive_queue(),
+    multipath( false ),
+    path_socks(),
+    path_RTT(),
+    udp_gso_state( -1 )
 {
   setup();
 
@@ -378,17 +648,142 @@ Connection::Connection( const char *key_str, const char *ip, const char *port )
   memset( &hints, 0, sizeof( hints ) );
   hints.ai_family = AF_UNSPEC;
   hints.ai_socktype = SOCK_DGRAM;
-  hints.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;
+  hints.ai_flags = AI_NUMERICSERV;
   AddrInfo ai( ip, port, &hints );
-  fatal_assert( static_cast<size_t>( ai.res->ai_addrlen ) <= sizeof( remote_addr ) );
-  remote_addr_len = ai.res->ai_addrlen;
-  memcpy( &remote_addr.sa, ai.res->ai_addr, remote_addr_len );
+
+  /* Collect every resolved address, IPv6 before IPv4 (RFC 8305's
+     preference), and race them all until the server answers.  The
+     mosh wrapper normally hands us a single numeric IP, so the
+     common case degenerates to exactly one candidate. */
+  for ( int pass = 0; pass < 2; pass++ ) {
+    for ( const struct addrinfo *res = ai.res; res != NULL; res = res->ai_next ) {
+      if ( ( pass == 0 ) != ( res->ai_family == AF_INET6 ) ) {
+	continue;
+      }
+      if ( static_cast<size_t>( res->ai_addrlen ) > sizeof( remote_addr ) ) {
+	continue;
+      }
+      Candidate cand;
+      cand.addr_len = res->ai_addrlen;
+      memcpy( &cand.addr.sa, res->ai_addr, cand.addr_len );
+      candidates.push_back( cand );
+    }
+  }
+
+  fatal_assert( !candidates.empty() );
+
+  remote_addr = candidates.front().addr;
+  remote_addr_len = candidates.front().addr_len;
 
   has_remote_addr = true;
 
+  /* One socket per address family present; the preferred family's
+     socket goes last so sock() targets it. */
+  bool have_family[ 2 ] = { false, false }; /* v6, v4 */
+  for ( std::vector< Candidate >::const_iterator it = candidates.begin();
+	it != candidates.end();
+	it++ ) {
+    have_family[ it->addr.sa.sa_family == AF_INET6 ? 0 : 1 ] = true;
+  }
+  const int other_family = ( remote_addr.sa.sa_family == AF_INET6 ) ? AF_INET : AF_INET6;
+  if ( have_family[ 0 ] && have_family[ 1 ] ) {
+    socks.push_back( Socket( other_family ) );
+  }
   socks.push_back( Socket( remote_addr.sa.sa_family ) );
 
+  for ( std::vector< Candidate >::iterator it = candidates.begin();
+	it != candidates.end();
+	it++ ) {
+    it->sock_fd = ( it->addr.sa.sa_family == remote_addr.sa.sa_family )
+      ? socks.back().fd() : socks.front().fd();
+  }
+
+  if ( candidates.size() == 1 ) {
+    candidates.clear(); /* nothing to race */
+  }
+
   set_MTU( remote_addr.sa.sa_family );
+
+  if ( getenv( "MOSH_MULTIPATH" ) ) {
+    open_interface_paths();
+    multipath = !path_socks.empty();
+  }
+}
+
+/* Open one extra socket bound to each local interface that could
+   plausibly reach the remote host.  Best-effort: an interface we
+   can't bind to is skipped, and if nothing binds we quietly stay
+   single-path. */
+void Connection::open_interface_paths( void )
+{
+#ifdef HAVE_GETIFADDRS
+  struct ifaddrs *interfaces;
+  if ( getifaddrs( &interfaces ) < 0 ) {
+    return;
+  }
+
+  const bool remote_is_loopback =
+    ( remote_addr.sa.sa_family == AF_INET )
+    ? ( ( ntohl( remote_addr.sin.sin_addr.s_addr ) >> 24 ) == 127 )
+    : IN6_IS_ADDR_LOOPBACK( &remote_addr.sin6.sin6_addr );
+
+  for ( struct ifaddrs *ifa = interfaces; ifa != NULL; ifa = ifa->ifa_next ) {
+    if ( ( ifa->ifa_addr == NULL )
+	 || ( ifa->ifa_addr->sa_family != remote_addr.sa.sa_family )
+	 || !( ifa->ifa_flags & IFF_UP ) ) {
+      continue;
+    }
+
+    if ( ( ifa->ifa_flags & IFF_LOOPBACK ) && !remote_is_loopback ) {
+      continue;
+    }
+
+    if ( ifa->ifa_addr->sa_family == AF_INET6
+	 && IN6_IS_ADDR_LINKLOCAL( &( (struct sockaddr_in6 *)ifa->ifa_addr )->sin6_addr ) ) {
+      continue;
+    }
+
+    const socklen_t len = ( ifa->ifa_addr->sa_family == AF_INET )
+      ? sizeof( struct sockaddr_in ) : sizeof( struct sockaddr_in6 );
+
+    try {
+      path_socks.push_back( Socket( ifa->ifa_addr->sa_family, ifa->ifa_addr, len ) );
+    } catch ( const NetworkException & e ) {
+      continue; /* e.g. interface without the right privileges */
+    }
+
+    if ( path_socks.size() >= MAX_PORTS_OPEN ) {
+      break;
+    }
+  }
+
+  freeifaddrs( interfaces );
+#endif
+}
+
+/* Choose the socket whose path has shown the lowest smoothed RTT;
+   fall back to the ordinary socket until we have measurements. */
+int Connection::best_path_fd( void ) const
+{
+  int best_fd = sock();
+  double best_RTT = SRTT;
+
+  std::map< int, double >::const_iterator sample = path_RTT.find( best_fd );
+  if ( sample != path_RTT.end() ) {
+    best_RTT = sample->second;
+  }
+
+  for ( std::deque< Socket >::const_iterator it = path_socks.begin();
+	it != path_socks.end();
+	it++ ) {
+    sample = path_RTT.find( it->fd() );
+    if ( ( sample != path_RTT.end() ) && ( sample->second < best_RTT ) ) {
+      best_fd = it->fd();
+      best_RTT = sample->second;
+    }
+  }
+
+  return best_fd;
 }
 
 void Connection::send( const string & s )
@@ -397,11 +792,14 @@ void Connection::send( const string & s )
     return;
   }
 
-  Packet px = new_packet( s );
+  const LatencyStats::StageTimer timer( LatencyStats::STAGE_SEND );
+  const AllocStats::ScopeTag tag( AllocStats::SUBSYS_NETWORK );
 
-  string p = session.encrypt( px.toMessage() );
+  const string & p = encrypt_payload( s );
 
-  ssize_t bytes_sent = sendto( sock(), p.data(), p.size(), MSG_DONTWAIT,
+  const int send_sock = multipath ? best_path_fd() : sock();
+
+  ssize_t bytes_sent = sendto( send_sock, p.data(), p.size(), MSG_DONTWAIT,
 			       &remote_addr.sa, remote_addr_len );
 
   if ( bytes_sent != static_cast<ssize_t>( p.size() ) ) {
@@ -412,8 +810,249 @@ void Connection::send( const string & s )
     if ( errno == EMSGSIZE ) {
       MTU = DEFAULT_SEND_MTU; /* payload MTU of last resort */
     }
+  } else {
+    /* count logical datagrams only, not multipath/candidate copies,
+       so sent vs. received+lost stays a meaningful identity */
+    TransportStats::counters.packets_sent++;
+    TransportStats::counters.bytes_sent += p.size();
+  }
+
+  if ( multipath && ( p.size() <= MULTIPATH_DUPLICATE_MAX ) ) {
+    /* Race the identical ciphertext down every other path; whichever
+       copy arrives first wins, and the receiver's replay protection
+       discards the stragglers.  Best-effort: a path that fails here
+       just doesn't contribute a copy. */
+    if ( send_sock != sock() ) {
+      sendto( sock(), p.data(), p.size(), MSG_DONTWAIT,
+	      &remote_addr.sa, remote_addr_len );
+    }
+    for ( std::deque< Socket >::const_iterator it = path_socks.begin();
+	  it != path_socks.end();
+	  it++ ) {
+      if ( it->fd() == send_sock ) {
+	continue;
+      }
+      sendto( it->fd(), p.data(), p.size(), MSG_DONTWAIT,
+	      &remote_addr.sa, remote_addr_len );
+    }
+  }
+
+  if ( !candidates.empty() ) {
+    /* Still racing the startup candidates: copy the ciphertext to
+       every address we haven't heard from.  The first authenticated
+       reply ends the race (see process_received). */
+    for ( std::vector< Candidate >::const_iterator it = candidates.begin();
+	  it != candidates.end();
+	  it++ ) {
+      if ( ( it->addr_len == remote_addr_len )
+	   && ( memcmp( &it->addr, &remote_addr, remote_addr_len ) == 0 ) ) {
+	continue; /* the primary sendto() above covered this one */
+      }
+      sendto( it->sock_fd, p.data(), p.size(), MSG_DONTWAIT,
+	      &it->addr.sa, it->addr_len );
+    }
+  }
+
+  post_send_checks();
+}
+
+void Connection::send( const std::vector< string > & msgs )
+{
+  if ( !has_remote_addr ) {
+    return;
+  }
+
+  if ( msgs.size() == 1 ) { /* common case: instruction fits in one fragment */
+    send( msgs.front() );
+    return;
+  }
+
+  /* Keep every fragment of one instruction on a single path, so the
+     server's roaming logic sees a consistent source address. */
+  const int send_sock = multipath ? best_path_fd() : sock();
+
+#ifdef UDP_SEGMENT
+  /* Fragment bursts are equal-sized except for the tail, which is the
+     shape UDP GSO wants: hand the kernel one superpacket to split at
+     line rate instead of one syscall (and one qdisc pass) each. */
+  if ( udp_gso_state != 0 ) {
+    if ( send_gso( msgs, send_sock ) ) {
+      post_send_checks();
+      return;
+    }
+    /* the kernel refused the probe; use the paths below from now on */
+  }
+#endif
+
+  /* encrypt all the fragments first so they can go out back-to-back */
+  std::vector< string > wire;
+  wire.reserve( msgs.size() );
+  for ( std::vector< string >::const_iterator i = msgs.begin();
+	i != msgs.end();
+	i++ ) {
+    wire.push_back( encrypt_payload( *i ) );
+  }
+
+#ifdef HAVE_SENDMMSG
+  /* emit the whole instruction with as few syscalls as possible */
+  static const unsigned int SEND_BATCH = 64;
+  struct mmsghdr headers[ SEND_BATCH ];
+  struct iovec msg_iovecs[ SEND_BATCH ];
+
+  std::vector< string >::size_type offset = 0;
+  while ( offset < wire.size() ) {
+    unsigned int count = wire.size() - offset;
+    if ( count > SEND_BATCH ) {
+      count = SEND_BATCH;
+    }
+
+    memset( headers, 0, count * sizeof( headers[ 0 ] ) );
+    for ( unsigned int i = 0; i < count; i++ ) {
+      msg_iovecs[ i ].iov_base = const_cast<char *>( wire[ offset + i ].data() );
+      msg_iovecs[ i ].iov_len = wire[ offset + i ].size();
+      headers[ i ].msg_hdr.msg_name = &remote_addr.sa;
+      headers[ i ].msg_hdr.msg_namelen = remote_addr_len;
+      headers[ i ].msg_hdr.msg_iov = &msg_iovecs[ i ];
+      headers[ i ].msg_hdr.msg_iovlen = 1;
+    }
+
+    int num_sent = sendmmsg( send_sock, headers, count, MSG_DONTWAIT );
+    if ( num_sent < 0 ) {
+      /* Make sendmmsg() failure available to the frontend. */
+      send_error = "sendmmsg: ";
+      send_error += strerror( errno );
+
+      if ( errno == EMSGSIZE ) {
+	MTU = DEFAULT_SEND_MTU; /* payload MTU of last resort */
+      }
+      break;
+    }
+    for ( int s = 0; s < num_sent; s++ ) {
+      TransportStats::counters.packets_sent++;
+      TransportStats::counters.bytes_sent += wire[ offset + s ].size();
+    }
+    if ( (unsigned int)num_sent < count ) {
+      break; /* socket buffer full; rely on retransmission */
+    }
+    offset += num_sent;
+  }
+#else
+  for ( std::vector< string >::const_iterator i = wire.begin();
+	i != wire.end();
+	i++ ) {
+    ssize_t bytes_sent = sendto( send_sock, i->data(), i->size(), MSG_DONTWAIT,
+				 &remote_addr.sa, remote_addr_len );
+
+    if ( bytes_sent != static_cast<ssize_t>( i->size() ) ) {
+      /* Make sendto() failure available to the frontend. */
+      send_error = "sendto: ";
+      send_error += strerror( errno );
+
+      if ( errno == EMSGSIZE ) {
+	MTU = DEFAULT_SEND_MTU; /* payload MTU of last resort */
+      }
+    } else {
+      TransportStats::counters.packets_sent++;
+      TransportStats::counters.bytes_sent += i->size();
+    }
+  }
+#endif
+
+  post_send_checks();
+}
+
+#ifdef UDP_SEGMENT
+/* Concatenate the encrypted fragments into superpackets and let the
+   kernel split them (UDP generic segmentation offload).  Within one
+   superpacket every segment must have the wire size of the first,
+   except the last, which may be shorter; a fragment that breaks the
+   pattern just starts the next superpacket.  Returns false only when
+   the very first sendmsg() is refused, i.e. the kernel or interface
+   has no GSO path, and the caller should fall back for good. */
+bool Connection::send_gso( const std::vector< string > & msgs, int send_sock )
+{
+  /* kernel limits on one superpacket */
+  static const size_t MAX_SEGMENTS = 64;
+  static const size_t MAX_SUPERPACKET = 65507;
+
+  static string buf; /* capacity persists across bursts; mosh is single-threaded */
+
+  std::vector< string >::size_type i = 0;
+  while ( i < msgs.size() ) {
+    buf.clear();
+    size_t seg_size = 0;
+    size_t count = 0;
+
+    while ( ( i < msgs.size() ) && ( count < MAX_SEGMENTS ) ) {
+      const string & p = encrypt_payload( msgs[ i ] );
+      if ( count == 0 ) {
+	seg_size = p.size();
+      } else if ( ( p.size() > seg_size )
+		  || ( ( p.size() < seg_size ) && ( i + 1 < msgs.size() ) ) ) {
+	break; /* only the final segment may be short */
+      }
+      if ( buf.size() + p.size() > MAX_SUPERPACKET ) {
+	break;
+      }
+      buf += p;
+      count++;
+      i++;
+    }
+
+    struct msghdr header;
+    struct iovec msg_iovec;
+    char cmsg_buf[ CMSG_SPACE( sizeof( uint16_t ) ) ];
+
+    memset( &header, 0, sizeof header );
+    memset( cmsg_buf, 0, sizeof cmsg_buf );
+
+    msg_iovec.iov_base = const_cast<char *>( buf.data() );
+    msg_iovec.iov_len = buf.size();
+
+    header.msg_name = &remote_addr.sa;
+    header.msg_namelen = remote_addr_len;
+    header.msg_iov = &msg_iovec;
+    header.msg_iovlen = 1;
+    header.msg_control = cmsg_buf;
+    header.msg_controllen = sizeof cmsg_buf;
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR( &header );
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN( sizeof( uint16_t ) );
+    const uint16_t net_seg_size = seg_size; /* host order, per udp(7) */
+    memcpy( CMSG_DATA( cmsg ), &net_seg_size, sizeof net_seg_size );
+
+    ssize_t bytes_sent = sendmsg( send_sock, &header, MSG_DONTWAIT );
+
+    if ( bytes_sent != static_cast<ssize_t>( buf.size() ) ) {
+      if ( udp_gso_state == -1 ) {
+	udp_gso_state = 0; /* probe failed; never try again */
+	return false;      /* caller re-encrypts and falls back */
+      }
+
+      /* GSO has worked before, so this is an ordinary send failure:
+	 report it and rely on retransmission for the rest */
+      send_error = "sendmsg: ";
+      send_error += strerror( errno );
+
+      if ( errno == EMSGSIZE ) {
+	MTU = DEFAULT_SEND_MTU; /* payload MTU of last resort */
+      }
+      return true;
+    }
+
+    udp_gso_state = 1;
+    TransportStats::counters.packets_sent += count; /* kernel splits into count segments */
+    TransportStats::counters.bytes_sent += buf.size();
   }
 
+  return true;
+}
+#endif
+
+void Connection::post_send_checks( void )
+{
   uint64_t now = timestamp();
   if ( server ) {
     if ( now - last_heard > SERVER_ASSOCIATION_TIMEOUT ) {
@@ -430,13 +1069,30 @@ void Connection::send( const string & s )
 
 string Connection::recv( void )
 {
+  const LatencyStats::StageTimer timer( LatencyStats::STAGE_RECV );
+  const AllocStats::ScopeTag tag( AllocStats::SUBSYS_NETWORK );
+
+  if ( !receive_queue.empty() ) { /* datagram left over from a batched read */
+    string payload;
+    payload.swap( receive_queue.front() );
+    receive_queue.pop_front();
+    return payload;
+  }
+
   assert( !socks.empty() );
-  for ( std::deque< Socket >::const_iterator it = socks.begin();
-	it != socks.end();
+  const std::vector< int > all_fds = fds(); /* hopping sockets, then multipath sockets */
+  for ( std::vector< int >::const_iterator it = all_fds.begin();
+	it != all_fds.end();
 	it++ ) {
     string payload;
     try {
-      payload = recv_one( it->fd());
+#ifdef HAVE_RECVMMSG
+      recv_batch( *it );
+#else
+      recv_one( *it );
+#endif
+      payload.swap( receive_queue.front() );
+      receive_queue.pop_front();
     } catch ( NetworkException & e ) {
       if ( (e.the_errno == EAGAIN)
 	   || (e.the_errno == EWOULDBLOCK) ) {
@@ -453,14 +1109,22 @@ string Connection::recv( void )
   throw NetworkException( "No packet received" );
 }
 
-string Connection::recv_one( int sock_to_recv )
+/* A GRO-coalesced buffer can carry a whole burst of segments, so it
+   needs room well beyond one datagram's worth. */
+#ifdef UDP_GRO
+static const size_t RECV_BUF_SIZE = 65535;
+#else
+static const size_t RECV_BUF_SIZE = Session::RECEIVE_MTU;
+#endif
+
+void Connection::recv_one( int sock_to_recv )
 {
   /* receive source address, ECN, and payload in msghdr structure */
   Addr packet_remote_addr;
   struct msghdr header;
   struct iovec msg_iovec;
 
-  char msg_payload[ Session::RECEIVE_MTU ];
+  char msg_payload[ RECV_BUF_SIZE ];
   char msg_control[ Session::RECEIVE_MTU ];
 
   /* receive source address */
@@ -486,34 +1150,146 @@ string Connection::recv_one( int sock_to_recv )
     throw NetworkException( "recvmsg", errno );
   }
 
+  process_received( header, received_len, sock_to_recv );
+}
+
+#ifdef HAVE_RECVMMSG
+void Connection::recv_batch( int sock_to_recv )
+{
+  /* Drain the kernel's queue in one syscall instead of one recvmsg()
+     per datagram.  The scratch buffers are static: their contents are
+     copied into strings before we return, and mosh is
+     single-threaded. */
+  static const unsigned int RECV_BATCH = 16;
+  static Addr packet_remote_addr[ RECV_BATCH ];
+  static struct mmsghdr headers[ RECV_BATCH ];
+  static struct iovec msg_iovecs[ RECV_BATCH ];
+  static char msg_payload[ RECV_BATCH ][ RECV_BUF_SIZE ];
+  static char msg_control[ RECV_BATCH ][ Session::RECEIVE_MTU ];
+
+  for ( unsigned int i = 0; i < RECV_BATCH; i++ ) {
+    struct msghdr &header = headers[ i ].msg_hdr;
+
+    /* receive source address */
+    header.msg_name = &packet_remote_addr[ i ];
+    header.msg_namelen = sizeof packet_remote_addr[ i ];
+
+    /* receive payload */
+    msg_iovecs[ i ].iov_base = msg_payload[ i ];
+    msg_iovecs[ i ].iov_len = sizeof msg_payload[ i ];
+    header.msg_iov = &msg_iovecs[ i ];
+    header.msg_iovlen = 1;
+
+    /* receive explicit congestion notification */
+    header.msg_control = msg_control[ i ];
+    header.msg_controllen = sizeof msg_control[ i ];
+
+    /* receive flags */
+    header.msg_flags = 0;
+  }
+
+  int received = recvmmsg( sock_to_recv, headers, RECV_BATCH, MSG_DONTWAIT, NULL );
+
+  if ( received < 0 ) {
+    throw NetworkException( "recvmmsg", errno );
+  }
+
+  /* Process every datagram in order.  If one is corrupt, the
+     exception propagates and the rest of the batch is dropped --
+     equivalent to packet loss, which the transport already
+     tolerates.  Already-queued payloads survive for later recv()
+     calls. */
+  for ( int i = 0; i < received; i++ ) {
+    process_received( headers[ i ].msg_hdr, headers[ i ].msg_len,
+		      sock_to_recv );
+  }
+}
+#endif
+
+void Connection::process_received( struct msghdr &header, ssize_t received_len,
+				   int sock_to_recv )
+{
+  const char *msg_payload = static_cast<char *>( header.msg_iov[ 0 ].iov_base );
+  const Addr &packet_remote_addr = *static_cast<Addr *>( header.msg_name );
+
   if ( header.msg_flags & MSG_TRUNC ) {
     throw NetworkException( "Received oversize datagram", errno );
   }
 
-  /* receive ECN */
+  /* walk the control messages: ECN, and (Linux) the GRO segment size */
   bool congestion_experienced = false;
+  size_t segment_size = received_len;
 
-  struct cmsghdr *ecn_hdr = CMSG_FIRSTHDR( &header );
-  if ( ecn_hdr
-       && ecn_hdr->cmsg_level == IPPROTO_IP
-       && ( ecn_hdr->cmsg_type == IP_TOS
+  for ( struct cmsghdr *chdr = CMSG_FIRSTHDR( &header );
+	chdr != NULL;
+	chdr = CMSG_NXTHDR( &header, chdr ) ) {
+    if ( chdr->cmsg_level == IPPROTO_IP
+	 && ( chdr->cmsg_type == IP_TOS
 #ifdef IP_RECVTOS
-	    || ecn_hdr->cmsg_type == IP_RECVTOS
+	      || chdr->cmsg_type == IP_RECVTOS
 #endif
-	    ) ) {
-    /* got one */
-    uint8_t *ecn_octet_p = (uint8_t *)CMSG_DATA( ecn_hdr );
-    assert( ecn_octet_p );
+	      ) ) {
+      /* got the ECN octet */
+      uint8_t *ecn_octet_p = (uint8_t *)CMSG_DATA( chdr );
+      assert( ecn_octet_p );
 
-    congestion_experienced = (*ecn_octet_p & 0x03) == 0x03;
+      congestion_experienced = (*ecn_octet_p & 0x03) == 0x03;
+    }
+#ifdef UDP_GRO
+    else if ( chdr->cmsg_level == SOL_UDP
+	      && chdr->cmsg_type == UDP_GRO ) {
+      /* the kernel coalesced a burst of datagrams into this buffer */
+      int gro_segment;
+      memcpy( &gro_segment, CMSG_DATA( chdr ), sizeof gro_segment );
+      if ( gro_segment > 0 ) {
+	segment_size = gro_segment;
+      }
+    }
+#endif
   }
 
-  Packet p( session.decrypt( msg_payload, received_len ) );
+  /* Queue each datagram in the buffer; without GRO coalescing there
+     is exactly one.  A corrupt segment throws, dropping the rest of
+     the buffer like any other packet loss. */
+  size_t offset = 0;
+  do {
+    size_t this_len = received_len - offset;
+    if ( this_len > segment_size ) {
+      this_len = segment_size;
+    }
+    receive_queue.push_back( process_datagram( msg_payload + offset, this_len,
+					       packet_remote_addr, header.msg_namelen,
+					       congestion_experienced, sock_to_recv ) );
+    offset += this_len;
+  } while ( offset < (size_t)received_len );
+}
+
+string Connection::process_datagram( const char *msg_payload, size_t payload_len,
+				     const Addr &packet_remote_addr, socklen_t packet_remote_addr_len,
+				     bool congestion_experienced, int sock_to_recv )
+{
+  uint64_t nonce_val;
+  const Span plaintext = session.decrypt_view( msg_payload, payload_len, nonce_val );
+  Packet p( nonce_val, plaintext.data, plaintext.len );
 
   dos_assert( p.direction == (server ? TO_SERVER : TO_CLIENT) ); /* prevent malicious playback to sender */
 
+  TransportStats::counters.packets_received++;
+  TransportStats::counters.bytes_received += payload_len;
+  if ( congestion_experienced ) {
+    TransportStats::counters.ecn_marks++;
+  }
+
   if ( p.seq < expected_receiver_seq ) { /* don't use (but do return) out-of-order packets for timestamp or targeting */
-    return p.payload;
+    TransportStats::counters.packets_late++;
+    string ret;
+    ret.swap( p.payload ); /* p is dead; don't copy the payload out of it */
+    return ret;
+  }
+  if ( ( expected_receiver_seq != 0 ) && ( p.seq > expected_receiver_seq ) ) {
+    /* gap in the sequence space: datagrams lost (or still in flight;
+       late arrivals are counted separately above) */
+    TransportStats::counters.packets_lost += p.seq - expected_receiver_seq;
   }
   expected_receiver_seq = p.seq + 1; /* this is security-sensitive because a replay attack could otherwise
 					screw up the timestamp and targeting */
@@ -548,6 +1324,26 @@ string Connection::recv_one( int sock_to_recv )
 	RTTVAR = (1 - beta) * RTTVAR + ( beta * fabs( SRTT - R ) );
 	SRTT = (1 - alpha) * SRTT + ( alpha * R );
       }
+
+      TransportStats::record_rtt( sock_to_recv, R );
+
+      /* track the propagation-delay floor over a sliding window */
+      uint64_t now_ms = timestamp();
+      if ( ( R <= min_RTT )
+	   || ( now_ms - min_RTT_received_at > MIN_RTT_WINDOW ) ) {
+	min_RTT = R;
+	min_RTT_received_at = now_ms;
+      }
+
+      if ( multipath ) {
+	/* per-path smoothed RTT, for choosing where to send large frames */
+	std::map< int, double >::iterator path = path_RTT.find( sock_to_recv );
+	if ( path == path_RTT.end() ) {
+	  path_RTT[ sock_to_recv ] = R;
+	} else {
+	  path->second = ( 1 - 1.0 / 8.0 ) * path->second + ( 1.0 / 8.0 ) * R;
+	}
+      }
     }
   }
 
@@ -556,21 +1352,51 @@ string Connection::recv_one( int sock_to_recv )
   last_heard = timestamp();
 
   if ( server && /* only client can roam */
-       ( remote_addr_len != header.msg_namelen ||
+       ( remote_addr_len != packet_remote_addr_len ||
 	 memcmp( &remote_addr, &packet_remote_addr, remote_addr_len ) != 0 ) ) {
     remote_addr = packet_remote_addr;
-    remote_addr_len = header.msg_namelen;
+    remote_addr_len = packet_remote_addr_len;
     char host[ NI_MAXHOST ], serv[ NI_MAXSERV ];
     int errcode = getnameinfo( &remote_addr.sa, remote_addr_len,
 			       host, sizeof( host ), serv, sizeof( serv ),
 			       NI_DGRAM | NI_NUMERICHOST | NI_NUMERICSERV );
     if ( errcode != 0 ) {
-      throw NetworkException( std::string( "recv_one: getnameinfo: " ) + gai_strerror( errcode ), 0 );
+      throw NetworkException( std::string( "process_datagram: getnameinfo: " ) + gai_strerror( errcode ), 0 );
     }
     fprintf( stderr, "Server now attached to client at %s:%s\n",
 	     host, serv );
+
+    /* the new path's MTU may be anything; fall back and re-probe */
+    set_MTU( remote_addr.sa.sa_family );
   }
-  return p.payload;
+
+  if ( !server && !candidates.empty() ) {
+    /* First authenticated reply ends the startup race: the answering
+       address becomes the remote, and its socket moves to the back of
+       the deque so sock() keeps targeting the winning family. */
+    remote_addr = packet_remote_addr;
+    remote_addr_len = packet_remote_addr_len;
+
+    if ( sock_to_recv != sock() ) {
+      for ( std::deque< Socket >::iterator it = socks.begin();
+	    it != socks.end();
+	    it++ ) {
+	if ( it->fd() == sock_to_recv ) {
+	  Socket winner( *it );
+	  socks.erase( it );
+	  socks.push_back( winner );
+	  break;
+	}
+      }
+    }
+
+    set_MTU( remote_addr.sa.sa_family );
+    candidates.clear();
+  }
+
+  string ret;
+  ret.swap( p.payload ); /* p is dead; don't copy the payload out of it */
+  return ret;
 }
 
 std::string Connection::port( void ) const
@@ -35,6 +35,7 @@
 
 #include <stdint.h>
 #include <deque>
+#include <map>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <string>
@@ -49,7 +50,19 @@
 using namespace Crypto;
 
 namespace Network {
-  static const unsigned int MOSH_PROTOCOL_VERSION = 2; /* bumped for echo-ack */
+  static const unsigned int MOSH_PROTOCOL_VERSION = 5; /* bumped for delta-coded state numbers */
+
+  /* Zigzag coding, so small deltas of either sign become short
+     varints on the wire.  Deltas are taken mod 2^64; the decoder
+     inverts them exactly. */
+  inline uint64_t zigzag( uint64_t delta )
+  {
+    return ( delta << 1 ) ^ ( 0 - ( delta >> 63 ) );
+  }
+  inline uint64_t unzigzag( uint64_t z )
+  {
+    return ( z >> 1 ) ^ ( 0 - ( z & 1 ) );
+  }
 
   uint64_t timestamp( void );
   uint16_t timestamp16( void );
@@ -88,7 +101,10 @@ namespace Network {
     {}
     
     Packet( const Message & message );
-    
+
+    /* from a decrypted view; avoids an intermediate Message string */
+    Packet( uint64_t nonce_val, const char *text, size_t text_len );
+
     Message toMessage( void );
   };
 
@@ -144,16 +160,30 @@ namespace Network {
 
     static const int CONGESTION_TIMESTAMP_PENALTY = 500; /* ms */
 
+    static const unsigned int MIN_RTT_WINDOW = 10000; /* ms the propagation-delay floor stays valid */
+
+    /* path MTU probing (cf. RFC 8899) */
+    static const int MTU_PROBE_TRIES = 3; /* lost or inconclusive probes before giving up on a rung */
+    static const unsigned int MTU_REPROBE_INTERVAL = 600000; /* ms before retrying a failed rung */
+
+    /* Only duplicate small payloads across paths; racing a bulk frame
+       down a slow cellular link just fills its buffer. */
+    static const size_t MULTIPATH_DUPLICATE_MAX = 512; /* bytes */
+
     bool try_bind( const char *addr, int port_low, int port_high );
+    void setup_server( const char *desired_ip, const char *desired_port );
 
     class Socket
     {
     private:
       int _fd;
 
+      void set_options( int family );
+
     public:
       int fd( void ) const { return _fd; }
       Socket( int family );
+      Socket( int family, const struct sockaddr *local_addr, socklen_t local_addr_len ); /* bound to one interface */
       ~Socket();
 
       Socket( const Socket & other );
@@ -165,10 +195,29 @@ namespace Network {
     Addr remote_addr;
     socklen_t remote_addr_len;
 
+    /* Startup address racing (cf. RFC 8305): every address the client
+       resolved is targeted until the server's first authenticated
+       reply picks the winner.  Emptied on adoption; always empty on
+       the server and when only one address resolved. */
+    class Candidate {
+    public:
+      Addr addr;
+      socklen_t addr_len;
+      int sock_fd; /* socket of the matching address family */
+      Candidate() : addr(), addr_len( 0 ), sock_fd( -1 ) {}
+    };
+    std::vector< Candidate > candidates;
+
     bool server;
 
     int MTU; /* application datagram MTU */
 
+    /* path MTU probing state; see probe_payload_size() */
+    int probe_MTU; /* ciphertext size of the probe in flight; 0 = none */
+    int probe_tries; /* failures at the current rung */
+    int probe_rung; /* index into the probe size ladder */
+    uint64_t next_probe_time;
+
     Base64Key key;
     Session session;
 
@@ -187,10 +236,17 @@ namespace Network {
     double SRTT;
     double RTTVAR;
 
+    /* windowed minimum RTT: the propagation-delay floor, used to
+       distinguish a standing queue from actual path latency */
+    double min_RTT;
+    uint64_t min_RTT_received_at;
+
     /* Error from send()/sendto(). */
     string send_error;
 
-    Packet new_packet( const string &s_payload );
+    /* returns a view of the session's wire buffer, valid until the
+       next encryption */
+    const string & encrypt_payload( const string &s_payload );
 
     void hop_port( void );
 
@@ -198,7 +254,39 @@ namespace Network {
 
     void prune_sockets( void );
 
-    string recv_one( int sock_to_recv );
+    void recv_one( int sock_to_recv );
+    void recv_batch( int sock_to_recv );
+    void process_received( struct msghdr &header, ssize_t received_len,
+			   int sock_to_recv );
+    string process_datagram( const char *msg_payload, size_t payload_len,
+			     const Addr &packet_remote_addr, socklen_t packet_remote_addr_len,
+			     bool congestion_experienced, int sock_to_recv );
+
+    bool send_gso( const std::vector< string > & msgs, int send_sock );
+
+    /* payloads drained from the kernel in one batch but not yet
+       handed to the transport layer */
+    std::deque< string > receive_queue;
+
+    /* client-only multipath: one extra socket bound to each local
+       interface, all aimed at the same remote.  Small payloads are
+       duplicated across every path (the receiver's replay protection
+       drops the stragglers); large frames go down whichever path has
+       shown the lowest RTT. */
+    bool multipath;
+    std::deque< Socket > path_socks; /* kept apart from socks so port
+					hopping doesn't prune them */
+    std::map< int, double > path_RTT; /* fd => smoothed RTT */
+
+    void open_interface_paths( void );
+    int best_path_fd( void ) const;
+
+    /* Linux UDP generic segmentation offload: one sendmsg() carries a
+       whole fragment burst that the kernel splits into datagrams.
+       Probed on first use: -1 untried, 0 refused, 1 works. */
+    int udp_gso_state;
+
+    void post_send_checks( void );
 
     void set_MTU( int family );
 
@@ -207,20 +295,40 @@ namespace Network {
     static const int ADDED_BYTES = 8 /* seqno/nonce */ + 4 /* timestamps */;
 
     Connection( const char *desired_ip, const char *desired_port ); /* server */
+    Connection( const Base64Key &s_key, const char *desired_ip, const char *desired_port ); /* server restored from a snapshot */
     Connection( const char *key_str, const char *ip, const char *port ); /* client */
 
     void send( const string & s );
+    void send( const std::vector< string > & msgs );
     string recv( void );
+    bool pending_payload( void ) const { return !receive_queue.empty(); }
     const std::vector< int > fds( void ) const;
     int get_MTU( void ) const { return MTU; }
 
     std::string port( void ) const;
     string get_key( void ) const { return key.printable_key(); }
     bool get_has_remote_addr( void ) const { return has_remote_addr; }
+    bool is_server( void ) const { return server; }
+
+    /* ICMP-less path MTU discovery: when a probe is due,
+       probe_payload_size() names the padded instruction size the
+       transport should hand to send_probe(), which emits it with
+       don't-fragment set.  The transport judges delivery (only the
+       probe carries its state number, so an acknowledgment of exactly
+       that number proves the size fits the path) and reports back
+       through probe_result(). */
+    size_t probe_payload_size( void );
+    bool send_probe( const string & s );
+    void probe_result( bool arrived );
 
     uint64_t timeout( void ) const;
     double get_SRTT( void ) const { return SRTT; }
 
+    /* for session snapshot/restore */
+    uint64_t get_expected_receiver_seq( void ) const { return expected_receiver_seq; }
+    void set_expected_receiver_seq( uint64_t seq ) { expected_receiver_seq = seq; }
+    double get_min_RTT( void ) const { return min_RTT; }
+
     const Addr &get_remote_addr( void ) const { return remote_addr; }
     socklen_t get_remote_addr_len( void ) const { return remote_addr_len; }
 
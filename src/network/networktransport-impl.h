@@ -35,6 +35,8 @@
 
 #include "networktransport.h"
 
+#include "allocstats.h"
+#include "latencystats.h"
 #include "transportsender-impl.h"
 
 using namespace Network;
@@ -67,8 +69,55 @@ Transport<MyState, RemoteState>::Transport( MyState &initial_state, RemoteState
   /* client */
 }
 
+template <class MyState, class RemoteState>
+Transport<MyState, RemoteState>::Transport( MyState &initial_state, RemoteState &initial_remote,
+					    uint64_t sent_num, uint64_t remote_num,
+					    const Crypto::Base64Key &key,
+					    const char *desired_ip, const char *desired_port )
+  : connection( key, desired_ip, desired_port ),
+    sender( &connection, initial_state ),
+    received_states( 1, TimestampedState<RemoteState>( timestamp(), remote_num, initial_remote ) ),
+    receiver_quench_timer( 0 ),
+    last_receiver_state( initial_remote ),
+    fragments(),
+    verbose( 0 )
+{
+  /* server restored from a snapshot: initial_state is the state the
+     client last acknowledged, so diffs continue to apply cleanly */
+  sender.fast_forward_num( sent_num );
+  sender.set_ack_num( remote_num );
+}
+
+template <class MyState, class RemoteState>
+Transport<MyState, RemoteState>::Transport( MyState &initial_state, RemoteState &initial_remote,
+					    uint64_t sent_num, uint64_t remote_num,
+					    const char *key_str, const char *ip, const char *port )
+  : connection( key_str, ip, port ),
+    sender( &connection, initial_state ),
+    received_states( 1, TimestampedState<RemoteState>( timestamp(), remote_num, initial_remote ) ),
+    receiver_quench_timer( 0 ),
+    last_receiver_state( initial_remote ),
+    fragments(),
+    verbose( 0 )
+{
+  /* client restored from a snapshot: pick the numbering back up so the
+     surviving server recognizes our states and acks */
+  sender.fast_forward_num( sent_num );
+  sender.set_ack_num( remote_num );
+}
+
 template <class MyState, class RemoteState>
 void Transport<MyState, RemoteState>::recv( void )
+{
+  /* A batched read can leave datagrams queued behind the one just
+     returned; process them all before going back to select. */
+  do {
+    recv_datagram();
+  } while ( connection.pending_payload() );
+}
+
+template <class MyState, class RemoteState>
+void Transport<MyState, RemoteState>::recv_datagram( void )
 {
   string s( connection.recv() );
   Fragment frag( s );
@@ -80,13 +129,21 @@ void Transport<MyState, RemoteState>::recv( void )
       throw NetworkException( "mosh protocol version mismatch", 0 );
     }
 
+    /* undo the delta coding of the state numbers (see
+       TransportSender::send_in_fragments) */
+    const uint64_t new_num = inst.ack_num() + unzigzag( inst.new_num() );
+    const uint64_t old_num = new_num - inst.old_num();
+    inst.set_new_num( new_num );
+    inst.set_old_num( old_num );
+    inst.set_throwaway_num( old_num - inst.throwaway_num() );
+
     sender.process_acknowledgment_through( inst.ack_num() );
 
     /* inform network layer of roundtrip (end-to-end-to-end) connectivity */
     connection.set_last_roundtrip_success( sender.get_sent_state_acked_timestamp() );
 
     /* first, make sure we don't already have the new state */
-    for ( typename list< TimestampedState<RemoteState> >::iterator i = received_states.begin();
+    for ( typename std::list< TimestampedState<RemoteState> >::iterator i = received_states.begin();
 	  i != received_states.end();
 	  i++ ) {
       if ( inst.new_num() == i->num ) {
@@ -96,7 +153,7 @@ void Transport<MyState, RemoteState>::recv( void )
     
     /* now, make sure we do have the old state */
     bool found = 0;
-    typename list< TimestampedState<RemoteState> >::iterator reference_state = received_states.begin();
+    typename std::list< TimestampedState<RemoteState> >::iterator reference_state = received_states.begin();
     while ( reference_state != received_states.end() ) {
       if ( inst.old_num() == reference_state->num ) {
 	found = true;
@@ -130,37 +187,46 @@ void Transport<MyState, RemoteState>::recv( void )
       }
     }
 
-    /* apply diff to reference state */
-    TimestampedState<RemoteState> new_state = *reference_state;
-    new_state.timestamp = timestamp();
-    new_state.num = inst.new_num();
+    /* Copy the reference state straight into its sorted place in the
+       queue and apply the diff there, so the applied state is built
+       in place instead of copied in.  (Duplicate nums were filtered
+       above, so insertion goes after any equal num.) */
+    typename std::list< TimestampedState<RemoteState> >::iterator insert_pos = received_states.begin();
+    while ( ( insert_pos != received_states.end() )
+	    && ( insert_pos->num < inst.new_num() ) ) {
+      insert_pos++;
+    }
+    const bool out_of_order = ( insert_pos != received_states.end() );
+
+    typename std::list< TimestampedState<RemoteState> >::iterator new_it
+      = received_states.insert( insert_pos, *reference_state );
+    new_it->timestamp = timestamp();
+    new_it->num = inst.new_num();
 
     if ( !inst.diff().empty() ) {
-      new_state.state.apply_string( inst.diff() );
+      const LatencyStats::StageTimer timer( LatencyStats::STAGE_APPLY );
+      const AllocStats::ScopeTag tag( AllocStats::SUBSYS_TERMINAL );
+      new_it->state.apply_string( inst.diff() );
     }
 
-    /* Insert new state in sorted place */
-    for ( typename list< TimestampedState<RemoteState> >::iterator i = received_states.begin();
-	  i != received_states.end();
-	  i++ ) {
-      if ( i->num > new_state.num ) {
-	received_states.insert( i, new_state );
-	if ( verbose ) {
-	  fprintf( stderr, "[%u] Received OUT-OF-ORDER state %d [ack %d]\n",
-		   (unsigned int)(timestamp() % 100000), (int)new_state.num, (int)inst.ack_num() );
-	}
-	return;
+    if ( out_of_order ) {
+      if ( verbose ) {
+	fprintf( stderr, "[%u] Received OUT-OF-ORDER state %d [ack %d]\n",
+		 (unsigned int)(timestamp() % 100000), (int)new_it->num, (int)inst.ack_num() );
       }
+      return;
     }
     if ( verbose ) {
       fprintf( stderr, "[%u] Received state %d [coming from %d, ack %d]\n",
-	       (unsigned int)(timestamp() % 100000), (int)new_state.num, (int)inst.old_num(), (int)inst.ack_num() );
+	       (unsigned int)(timestamp() % 100000), (int)new_it->num, (int)inst.old_num(), (int)inst.ack_num() );
     }
-    received_states.push_back( new_state );
     sender.set_ack_num( received_states.back().num );
 
-    sender.remote_heard( new_state.timestamp );
-    if ( !inst.diff().empty() ) {
+    sender.remote_heard( new_it->timestamp );
+    if ( !inst.diff().empty()
+	 || ( inst.chaff().size() > PADDING_BUCKET_MAX ) ) {
+      /* padding past the top bucket marks a path MTU probe, whose
+	 sender is waiting on our ack for the verdict */
       sender.set_data_ack();
     }
   }
@@ -170,9 +236,9 @@ void Transport<MyState, RemoteState>::recv( void )
 template <class MyState, class RemoteState>
 void Transport<MyState, RemoteState>::process_throwaway_until( uint64_t throwaway_num )
 {
-  typename list< TimestampedState<RemoteState> >::iterator i = received_states.begin();
+  typename std::list< TimestampedState<RemoteState> >::iterator i = received_states.begin();
   while ( i != received_states.end() ) {
-    typename list< TimestampedState<RemoteState> >::iterator inext = i;
+    typename std::list< TimestampedState<RemoteState> >::iterator inext = i;
     inext++;
     if ( i->num < throwaway_num ) {
       received_states.erase( i );
@@ -192,7 +258,7 @@ string Transport<MyState, RemoteState>::get_remote_diff( void )
 
   const RemoteState *oldest_receiver_state = &received_states.front().state;
 
-  for ( typename list< TimestampedState<RemoteState> >::reverse_iterator i = received_states.rbegin();
+  for ( typename std::list< TimestampedState<RemoteState> >::reverse_iterator i = received_states.rbegin();
 	i != received_states.rend();
 	i++ ) {
     i->state.subtract( oldest_receiver_state );
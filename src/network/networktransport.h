@@ -56,10 +56,11 @@ namespace Network {
     TransportSender<MyState> sender;
 
     /* helper methods for recv() */
+    void recv_datagram( void );
     void process_throwaway_until( uint64_t throwaway_num );
 
     /* simple receiver */
-    list< TimestampedState<RemoteState> > received_states;
+    std::list< TimestampedState<RemoteState> > received_states;
     uint64_t receiver_quench_timer;
     RemoteState last_receiver_state; /* the state we were in when user last queried state */
     FragmentAssembly fragments;
@@ -70,10 +71,25 @@ namespace Network {
 	       const char *desired_ip, const char *desired_port );
     Transport( MyState &initial_state, RemoteState &initial_remote,
 	       const char *key_str, const char *ip, const char *port );
+    Transport( MyState &initial_state, RemoteState &initial_remote,
+	       uint64_t sent_num, uint64_t remote_num,
+	       const Crypto::Base64Key &key,
+	       const char *desired_ip, const char *desired_port ); /* server restored from a snapshot */
+    Transport( MyState &initial_state, RemoteState &initial_remote,
+	       uint64_t sent_num, uint64_t remote_num,
+	       const char *key_str, const char *ip, const char *port ); /* client restored from a snapshot */
 
     /* Send data or an ack if necessary. */
     void tick( void ) { sender.tick(); }
 
+    /* Probe the peer immediately, e.g. after waking from sleep. */
+    void wake( void ) { sender.wake(); }
+
+    /* Read-only observers: fan our instruction stream out to an
+       additional connection (not owned) whose input is ignored. */
+    void add_mirror( Connection *c ) { sender.add_mirror( c ); }
+    void mirror_recv( void ) { sender.mirror_recv(); }
+
     /* Returns the number of ms to wait until next possible event. */
     int wait_time( void ) { return sender.wait_time(); }
 
@@ -109,6 +125,9 @@ namespace Network {
     void set_verbose( unsigned int s_verbose ) { sender.set_verbose( s_verbose ); verbose = s_verbose; }
 
     void set_send_delay( int new_delay ) { sender.set_send_delay( new_delay ); }
+    void set_padding( bool s_padding ) { sender.set_padding( s_padding ); }
+    void set_lowmem( bool s_lowmem ) { sender.set_lowmem( s_lowmem ); }
+    void set_tap( RecordingTap *s_tap ) { sender.set_tap( s_tap ); }
 
     uint64_t get_sent_state_acked_timestamp( void ) const { return sender.get_sent_state_acked_timestamp(); }
     uint64_t get_sent_state_acked( void ) const { return sender.get_sent_state_acked(); }
@@ -120,6 +139,11 @@ namespace Network {
     socklen_t get_remote_addr_len( void ) const { return connection.get_remote_addr_len(); }
 
     std::string &get_send_error( void ) { return connection.get_send_error(); }
+
+    /* for session snapshot/restore */
+    const MyState & get_acked_state( void ) const { return sender.get_acked_state(); }
+    uint64_t get_expected_receiver_seq( void ) const { return connection.get_expected_receiver_seq(); }
+    void set_expected_receiver_seq( uint64_t seq ) { connection.set_expected_receiver_seq( seq ); }
   };
 }
 
@@ -0,0 +1,103 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#include <stdio.h>
+
+#include "recordingtap.h"
+#include "byteorder.h"
+
+using namespace Network;
+
+static const char RECORDING_MAGIC[ 8 ] = { 'M', 'O', 'S', 'H', 'T', 'A', 'P', '1' };
+
+/* ms between sync flushes, so a killed server loses at most a few
+   seconds of the log */
+static const uint64_t RECORDING_FLUSH_INTERVAL = 5000;
+
+bool RecordingTap::open( const char *path, const string &header )
+{
+  file = gzopen( path, "wb" );
+  if ( file == NULL ) {
+    return false;
+  }
+
+  write_bytes( RECORDING_MAGIC, sizeof( RECORDING_MAGIC ) );
+  write_uint64( header.size() );
+  write_bytes( header.data(), header.size() );
+
+  return is_open();
+}
+
+RecordingTap::~RecordingTap()
+{
+  if ( file != NULL ) {
+    gzclose( file );
+  }
+}
+
+/* A write failure (e.g. the log's filesystem filling up) abandons the
+   recording rather than disturbing the session. */
+void RecordingTap::write_bytes( const char *data, size_t len )
+{
+  if ( ( file == NULL ) || ( len == 0 ) ) {
+    return;
+  }
+
+  if ( gzwrite( file, data, len ) != (int)len ) {
+    fprintf( stderr, "Write to session recording failed; recording stopped.\n" );
+    gzclose( file );
+    file = NULL;
+  }
+}
+
+void RecordingTap::write_uint64( uint64_t val )
+{
+  uint64_t net = htobe64( val );
+  write_bytes( (const char *)&net, sizeof( net ) );
+}
+
+void RecordingTap::record( uint64_t the_timestamp, const string &diff )
+{
+  if ( file == NULL ) {
+    return;
+  }
+
+  write_uint64( the_timestamp );
+  write_uint64( diff.size() );
+  write_bytes( diff.data(), diff.size() );
+
+  if ( ( file != NULL )
+       && ( the_timestamp - last_flush >= RECORDING_FLUSH_INTERVAL ) ) {
+    gzflush( file, Z_SYNC_FLUSH );
+    last_flush = the_timestamp;
+  }
+}
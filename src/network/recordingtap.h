@@ -0,0 +1,74 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#ifndef RECORDING_TAP_HPP
+#define RECORDING_TAP_HPP
+
+#include <string>
+#include <stdint.h>
+#include <zlib.h>
+
+namespace Network {
+  using std::string;
+
+  /* Session recorder fed from the sender's diff stream.  Each record
+     is the diff between consecutive sent states, so replaying the
+     records in order through apply_string() on a fresh state
+     reproduces the session; the capture cost is one buffered write
+     per sent frame.  The file is a gzip stream opening with a magic
+     string and a caller-supplied header (mosh-server stores the
+     initial terminal size there), followed by framed records of
+     (timestamp in ms, length, diff bytes), integers big-endian.
+     See src/examples/replay.cc for the playback side. */
+  class RecordingTap {
+  private:
+    gzFile file;
+    uint64_t last_flush;
+
+    void write_uint64( uint64_t val );
+    void write_bytes( const char *data, size_t len );
+
+  public:
+    RecordingTap() : file( NULL ), last_flush( 0 ) {}
+    ~RecordingTap();
+
+    bool open( const char *path, const string &header );
+    bool is_open( void ) const { return file != NULL; }
+    void record( uint64_t the_timestamp, const string &diff );
+
+    /* nonexistent methods to satisfy -Weffc++ */
+    RecordingTap( const RecordingTap & );
+    RecordingTap & operator=( const RecordingTap & );
+  };
+}
+
+#endif
@@ -37,6 +37,7 @@
 #include "transportinstruction.pb.h"
 #include "compressor.h"
 #include "fatal_assert.h"
+#include "transportstats.h"
 
 using namespace Network;
 using namespace TransportBuffers;
@@ -61,8 +62,8 @@ string Fragment::tostring( void )
   
   ret += network_order_string( id );
 
-  fatal_assert( !( fragment_num & 0x8000 ) ); /* effective limit on size of a terminal screen change or buffered user input */
-  uint16_t combined_fragment_num = ( final << 15 ) | fragment_num;
+  fatal_assert( !( fragment_num & 0xC000 ) ); /* effective limit on size of a terminal screen change or buffered user input */
+  uint16_t combined_fragment_num = ( final << 15 ) | ( parity << 14 ) | fragment_num;
   ret += network_order_string( combined_fragment_num );
 
   assert( ret.size() == frag_header_len );
@@ -72,33 +73,54 @@ string Fragment::tostring( void )
   return ret;
 }
 
-Fragment::Fragment( const string &x )
-  : id( -1 ), fragment_num( -1 ), final( false ), initialized( true ),
+Fragment::Fragment( string &x )
+  : id( -1 ), fragment_num( -1 ), final( false ), parity( false ), initialized( true ),
     contents()
 {
   fatal_assert( x.size() >= frag_header_len );
-  contents = string( x.begin() + frag_header_len, x.end() );
 
   uint64_t data64;
-  uint16_t *data16 = (uint16_t *)x.data();
+  uint16_t data16;
   memcpy( &data64, x.data(), sizeof( data64 ) );
+  memcpy( &data16, x.data() + sizeof( data64 ), sizeof( data16 ) );
   id = be64toh( data64 );
-  fragment_num = be16toh( data16[ 4 ] );
+  fragment_num = be16toh( data16 );
   final = ( fragment_num & 0x8000 ) >> 15;
-  fragment_num &= 0x7FFF;
+  parity = ( fragment_num & 0x4000 ) >> 14;
+  fragment_num &= 0x3FFF;
+
+  /* take the payload in place; erasing the header is a memmove, not
+     a reallocation */
+  contents.swap( x );
+  contents.erase( 0, frag_header_len );
 }
 
 bool FragmentAssembly::add_fragment( Fragment &frag )
 {
   /* see if this is a totally new packet */
   if ( current_id != frag.id ) {
+    if ( ( fragments_arrived > 0 ) || parity_fragment.initialized ) {
+      /* a partially-assembled instruction is displaced; its missing
+	 fragments were lost (or are still straggling in) */
+      TransportStats::counters.assemblies_abandoned++;
+    }
     fragments.clear();
-    fragments.resize( frag.fragment_num + 1 );
-    fragments.at( frag.fragment_num ) = frag;
-    fragments_arrived = 1;
+    parity_fragment = Fragment();
+    fragments_arrived = 0;
     fragments_total = -1; /* unknown */
     current_id = frag.id;
- } else { /* not a new packet */
+  }
+
+  if ( frag.parity ) {
+    /* the parity fragment also announces the data fragment count */
+    if ( parity_fragment.initialized ) {
+      /* make sure new version is same as what we already have */
+      assert( parity_fragment == frag );
+    } else {
+      parity_fragment = frag;
+      fragments_total = frag.fragment_num;
+    }
+  } else {
     /* see if we already have this fragment */
     if ( (fragments.size() > frag.fragment_num)
 	 && (fragments.at( frag.fragment_num ).initialized) ) {
@@ -111,12 +133,12 @@ bool FragmentAssembly::add_fragment( Fragment &frag )
       fragments.at( frag.fragment_num ) = frag;
       fragments_arrived++;
     }
-  }
 
-  if ( frag.final ) {
-    fragments_total = frag.fragment_num + 1;
-    assert( (int)fragments.size() <= fragments_total );
-    fragments.resize( fragments_total );
+    if ( frag.final ) {
+      fragments_total = frag.fragment_num + 1;
+      assert( (int)fragments.size() <= fragments_total );
+      fragments.resize( fragments_total );
+    }
   }
 
   if ( fragments_total != -1 ) {
@@ -124,7 +146,63 @@ bool FragmentAssembly::add_fragment( Fragment &frag )
   }
 
   /* see if we're done */
-  return fragments_arrived == fragments_total;
+  if ( fragments_arrived == fragments_total ) {
+    return true;
+  }
+
+  /* a single missing data fragment can be rebuilt from the parity fragment */
+  if ( parity_fragment.initialized
+       && ( fragments_total != -1 )
+       && ( fragments_arrived == fragments_total - 1 ) ) {
+    recover_missing();
+    return true;
+  }
+
+  return false;
+}
+
+/* XOR the parity fragment with every data fragment that did arrive,
+   leaving the one that didn't: a length word followed by its payload. */
+void FragmentAssembly::recover_missing( void )
+{
+  fragments.resize( fragments_total );
+
+  int missing = -1;
+  for ( int i = 0; i < fragments_total; i++ ) {
+    if ( !fragments.at( i ).initialized ) {
+      missing = i;
+      break;
+    }
+  }
+  fatal_assert( missing >= 0 );
+
+  string block = parity_fragment.contents;
+  fatal_assert( block.size() >= sizeof( uint16_t ) );
+
+  for ( int i = 0; i < fragments_total; i++ ) {
+    if ( i == missing ) {
+      continue;
+    }
+    const string &payload = fragments.at( i ).contents;
+    fatal_assert( sizeof( uint16_t ) + payload.size() <= block.size() );
+    uint16_t net_len = htobe16( payload.size() );
+    block[ 0 ] ^= ( (char *)&net_len )[ 0 ];
+    block[ 1 ] ^= ( (char *)&net_len )[ 1 ];
+    for ( size_t j = 0; j < payload.size(); j++ ) {
+      block[ sizeof( uint16_t ) + j ] ^= payload[ j ];
+    }
+  }
+
+  uint16_t net_len;
+  memcpy( &net_len, block.data(), sizeof( net_len ) );
+  size_t missing_len = be16toh( net_len );
+  fatal_assert( sizeof( uint16_t ) + missing_len <= block.size() );
+
+  fragments.at( missing ) = Fragment( current_id, missing,
+				      missing == fragments_total - 1,
+				      string( block, sizeof( uint16_t ), missing_len ) );
+  fragments_arrived++;
+  TransportStats::counters.fragments_recovered++;
 }
 
 Instruction FragmentAssembly::get_assembly( void )
@@ -133,30 +211,59 @@ Instruction FragmentAssembly::get_assembly( void )
 
   string encoded;
 
-  for ( int i = 0; i < fragments_total; i++ ) {
-    assert( fragments.at( i ).initialized );
-    encoded += fragments.at( i ).contents;
+  if ( fragments_total == 1 ) {
+    /* the common case: take the single fragment's contents without
+       reassembling a concatenation */
+    assert( fragments.at( 0 ).initialized );
+    encoded.swap( fragments.at( 0 ).contents );
+  } else {
+    size_t total_len = 0;
+    for ( int i = 0; i < fragments_total; i++ ) {
+      assert( fragments.at( i ).initialized );
+      total_len += fragments.at( i ).contents.size();
+    }
+    encoded.reserve( total_len );
+    for ( int i = 0; i < fragments_total; i++ ) {
+      encoded += fragments.at( i ).contents;
+    }
   }
 
+  /* parse straight out of the decompressor's scratch buffer */
   Instruction ret;
-  fatal_assert( ret.ParseFromString( get_compressor().uncompress_str( encoded ) ) );
+  size_t plaintext_len = 0;
+  const unsigned char *plaintext = compressor.uncompress_view( encoded, plaintext_len );
+  fatal_assert( ret.ParseFromArray( plaintext, plaintext_len ) );
 
   fragments.clear();
+  parity_fragment = Fragment();
   fragments_arrived = 0;
   fragments_total = -1;
 
   return ret;
 }
 
+/* see header */
+void Fragmenter::trim( void )
+{
+  const size_t cap = 16384;
+  if ( serialize_scratch.capacity() > cap ) {
+    string().swap( serialize_scratch );
+  }
+  vector<string>().swap( wire_fragments );
+  compressor.trim( cap );
+}
+
 bool Fragment::operator==( const Fragment &x ) const
 {
   return ( id == x.id ) && ( fragment_num == x.fragment_num ) && ( final == x.final )
-    && ( initialized == x.initialized ) && ( contents == x.contents );
+    && ( parity == x.parity ) && ( initialized == x.initialized ) && ( contents == x.contents );
 }
 
-vector<Fragment> Fragmenter::make_fragments( const Instruction &inst, size_t MTU )
+const vector<string> & Fragmenter::make_fragments( const Instruction &inst, size_t MTU )
 {
-  MTU -= Fragment::frag_header_len;
+  /* Reserve room for the header, and for the length word that pads
+     every slice to a common block size in the parity fragment. */
+  MTU -= Fragment::frag_header_len + sizeof( uint16_t );
   if ( (inst.old_num() != last_instruction.old_num())
        || (inst.new_num() != last_instruction.new_num())
        || (inst.ack_num() != last_instruction.ack_num())
@@ -167,33 +274,96 @@ vector<Fragment> Fragmenter::make_fragments( const Instruction &inst, size_t MTU
     next_instruction_id++;
   }
 
+  /* old_num and new_num are delta-coded against ack_num on the wire,
+     so they only pin down the same pair of states when ack_num also
+     matches */
   if ( (inst.old_num() == last_instruction.old_num())
-       && (inst.new_num() == last_instruction.new_num()) ) {
+       && (inst.new_num() == last_instruction.new_num())
+       && (inst.ack_num() == last_instruction.ack_num()) ) {
     assert( inst.diff() == last_instruction.diff() );
   }
 
   last_instruction = inst;
   last_MTU = MTU;
 
-  string payload = get_compressor().compress_str( inst.SerializeAsString() );
+  /* Serialize and compress once, then frame each fragment in place:
+     header bytes followed by a slice of the payload, with no
+     intermediate Fragment object or repeated substringing.  The
+     compressed payload stays in the compressor's scratch buffer. */
+  inst.SerializeToString( &serialize_scratch );
+  size_t payload_len = 0;
+  const char *payload = reinterpret_cast<const char *>(
+    compressor.compress_view( serialize_scratch, payload_len ) );
+
+  const uint64_t net_id = htobe64( next_instruction_id );
+
+  size_t offset = 0;
+  size_t num_fragments = 0;
   uint16_t fragment_num = 0;
-  vector<Fragment> ret;
 
-  while ( !payload.empty() ) {
-    string this_fragment;
-    bool final = false;
+  do {
+    size_t this_len = payload_len - offset;
+    bool final = true;
 
-    if ( payload.size() > MTU ) {
-      this_fragment = string( payload.begin(), payload.begin() + MTU );
-      payload = string( payload.begin() + MTU, payload.end() );
-    } else {
-      this_fragment = payload;
-      payload.clear();
-      final = true;
+    if ( this_len > MTU ) {
+      this_len = MTU;
+      final = false;
+    }
+
+    fatal_assert( !( fragment_num & 0xC000 ) ); /* effective limit on size of a terminal screen change or buffered user input */
+    const uint16_t net_fragment_num = htobe16( ( final << 15 ) | fragment_num );
+
+    if ( wire_fragments.size() <= num_fragments ) {
+      wire_fragments.push_back( string() );
+    }
+    string &wire = wire_fragments[ num_fragments++ ];
+    wire.clear();
+    wire.reserve( Fragment::frag_header_len + this_len );
+    wire.append( (const char *)&net_id, sizeof( net_id ) );
+    wire.append( (const char *)&net_fragment_num, sizeof( net_fragment_num ) );
+    wire.append( payload + offset, this_len );
+
+    offset += this_len;
+    fragment_num++;
+  } while ( offset < payload_len );
+
+  /* If the instruction spans multiple datagrams, add an XOR parity
+     fragment so the receiver can rebuild any single lost fragment
+     instead of waiting out a retransmission timeout.  Each data slice
+     contributes a block of its 16-bit length followed by its payload,
+     zero-padded to the length of the longest slice. */
+  if ( num_fragments >= 2 ) {
+    string block( sizeof( uint16_t ) + MTU, '\0' );
+
+    offset = 0;
+    for ( size_t i = 0; i < num_fragments; i++ ) {
+      const size_t this_len = wire_fragments[ i ].size() - Fragment::frag_header_len;
+      uint16_t net_len = htobe16( this_len );
+      block[ 0 ] ^= ( (char *)&net_len )[ 0 ];
+      block[ 1 ] ^= ( (char *)&net_len )[ 1 ];
+      for ( size_t j = 0; j < this_len; j++ ) {
+	block[ sizeof( uint16_t ) + j ] ^= payload[ offset + j ];
+      }
+      offset += this_len;
+    }
+
+    const uint16_t net_fragment_num = htobe16( ( 1 << 14 ) | (uint16_t)num_fragments );
+
+    if ( wire_fragments.size() <= num_fragments ) {
+      wire_fragments.push_back( string() );
     }
+    string &wire = wire_fragments[ num_fragments++ ];
+    wire.clear();
+    wire.reserve( Fragment::frag_header_len + block.size() );
+    wire.append( (const char *)&net_id, sizeof( net_id ) );
+    wire.append( (const char *)&net_fragment_num, sizeof( net_fragment_num ) );
+    wire.append( block );
+  }
 
-    ret.push_back( Fragment( next_instruction_id, fragment_num++, final, this_fragment ) );
+  /* drop strings left over from a larger previous instruction */
+  if ( wire_fragments.size() > num_fragments ) {
+    wire_fragments.resize( num_fragments );
   }
 
-  return ret;
+  return wire_fragments;
 }
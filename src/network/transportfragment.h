@@ -37,6 +37,7 @@
 #include <vector>
 #include <string>
 
+#include "compressor.h"
 #include "transportinstruction.pb.h"
 
 namespace Network {
@@ -50,23 +51,26 @@ namespace Network {
     static const size_t frag_header_len = sizeof( uint64_t ) + sizeof( uint16_t );
 
     uint64_t id;
-    uint16_t fragment_num;
+    uint16_t fragment_num; /* for a parity fragment, the number of data fragments it protects */
     bool final;
+    bool parity;
 
     bool initialized;
 
     string contents;
 
     Fragment()
-      : id( -1 ), fragment_num( -1 ), final( false ), initialized( false ), contents()
+      : id( -1 ), fragment_num( -1 ), final( false ), parity( false ), initialized( false ), contents()
     {}
 
     Fragment( uint64_t s_id, uint16_t s_fragment_num, bool s_final, const string & s_contents )
-      : id( s_id ), fragment_num( s_fragment_num ), final( s_final ), initialized( true ),
+      : id( s_id ), fragment_num( s_fragment_num ), final( s_final ), parity( false ), initialized( true ),
 	contents( s_contents )
     {}
 
-    Fragment( const string &x );
+    /* Consumes the wire string: the payload is taken by swap, not
+       copied. */
+    Fragment( string &x );
 
     string tostring( void );
 
@@ -77,11 +81,18 @@ namespace Network {
   {
   private:
     vector<Fragment> fragments;
+    Fragment parity_fragment;
     uint64_t current_id;
     int fragments_arrived, fragments_total;
 
+    /* per-assembly decompression context: assemblies on different
+       transports (or threads) never share scratch */
+    Compressor compressor;
+
+    void recover_missing( void );
+
   public:
-    FragmentAssembly() : fragments(), current_id( -1 ), fragments_arrived( 0 ), fragments_total( -1 ) {}
+    FragmentAssembly() : fragments(), parity_fragment(), current_id( -1 ), fragments_arrived( 0 ), fragments_total( -1 ), compressor() {}
     bool add_fragment( Fragment &inst );
     Instruction get_assembly( void );
   };
@@ -93,14 +104,37 @@ namespace Network {
     Instruction last_instruction;
     size_t last_MTU;
 
+    /* reused across calls so the capacity of the serialization
+       scratch and of each fragment string persists: a steady-state
+       instruction fragments without allocating */
+    string serialize_scratch;
+    vector<string> wire_fragments;
+
+    /* per-fragmenter compression context, like the scratch above */
+    Compressor compressor;
+
   public:
-    Fragmenter() : next_instruction_id( 0 ), last_instruction(), last_MTU( -1 )
+    /* s_initial_id lets a secondary instruction stream (e.g. observer
+       catch-ups) keep its ids out of the primary stream's range */
+    Fragmenter( uint64_t s_initial_id = 0 )
+      : next_instruction_id( s_initial_id ), last_instruction(), last_MTU( -1 ),
+	serialize_scratch(), wire_fragments(), compressor()
     {
       last_instruction.set_old_num( -1 );
       last_instruction.set_new_num( -1 );
     }
-    vector<Fragment> make_fragments( const Instruction &inst, size_t MTU );
+    /* Returns the wire representation of each fragment: the header
+       is written in place ahead of its slice of the serialized
+       instruction, ready for encryption without further framing.
+       The result is valid until the next call. */
+    const vector<string> & make_fragments( const Instruction &inst, size_t MTU );
     uint64_t last_ack_sent( void ) const { return last_instruction.ack_num(); }
+    uint64_t last_instruction_id( void ) const { return next_instruction_id; }
+
+    /* Return outsized scratch to the allocator (bounded-memory hosts):
+       a single large diff otherwise pins its high-water mark for the
+       life of the session. */
+    void trim( void );
   };
   
 }
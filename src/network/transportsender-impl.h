@@ -34,13 +34,15 @@
 #define TRANSPORT_SENDER_IMPL_HPP
 
 #include <algorithm>
-#include <list>
+#include <deque>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
 #include "transportsender.h"
 #include "transportfragment.h"
+#include "allocstats.h"
+#include "latencystats.h"
 
 #include <limits.h>
 
@@ -51,8 +53,14 @@ TransportSender<MyState>::TransportSender( Connection *s_connection, MyState &in
   : connection( s_connection ), 
     current_state( initial_state ),
     sent_states( 1, TimestampedState<MyState>( timestamp(), 0, initial_state ) ),
-    assumed_receiver_state( sent_states.begin() ),
+    assumed_receiver_state( 0 ),
+    diff_cache(),
     fragmenter(),
+    mirrors(),
+    mirror_fragmenter( uint64_t( 1 ) << 63 ),
+    probe_fragmenter( uint64_t( 1 ) << 62 ),
+    probe_num( 0 ),
+    probe_sent_time( 0 ),
     next_ack_time( timestamp() ),
     next_send_time( timestamp() ),
     verbose( 0 ),
@@ -64,17 +72,48 @@ TransportSender<MyState>::TransportSender( Connection *s_connection, MyState &in
     SEND_MINDELAY( 8 ),
     last_heard( 0 ),
     prng(),
-    mindelay_clock( -1 )
+    pad_pool(),
+    padding( true ),
+    lowmem( false ),
+    tap( NULL ),
+    mindelay_clock( -1 ),
+    last_pending_start( 0 ),
+    adaptive_mindelay( 0 ),
+    delivery_rate( 0 ),
+    last_frame_bytes( 0 ),
+    unacked_frames()
 {
 }
 
-/* Try to send roughly two frames per RTT, bounded by limits on frame rate */
+/* Try to send roughly two frames per RTT, bounded by limits on frame
+   rate.  The measured path behavior adjusts this in both directions:
+   a standing queue (SRTT above the windowed RTT floor) or a frame
+   bigger than the delivery rate can drain stretches the interval,
+   while an unloaded path is allowed beneath the old fixed floor. */
 template <class MyState>
 unsigned int TransportSender<MyState>::send_interval( void ) const
 {
   int SEND_INTERVAL = lrint( ceil( connection->get_SRTT() / 2.0 ) );
-  if ( SEND_INTERVAL < SEND_INTERVAL_MIN ) {
-    SEND_INTERVAL = SEND_INTERVAL_MIN;
+
+  const double queueing_delay = connection->get_SRTT() - connection->get_min_RTT();
+  if ( queueing_delay > QUEUEING_DELAY_LIMIT ) {
+    /* our own frames are probably what's sitting in the buffer;
+       give the queue a chance to drain */
+    SEND_INTERVAL += lrint( ceil( queueing_delay ) );
+  }
+
+  if ( ( delivery_rate > 0 ) && ( last_frame_bytes > 0 ) ) {
+    const int drain_time = lrint( ceil( last_frame_bytes / delivery_rate ) );
+    if ( drain_time > SEND_INTERVAL ) {
+      SEND_INTERVAL = drain_time;
+    }
+  }
+
+  const int interval_min = ( queueing_delay > QUEUEING_DELAY_LIMIT )
+    ? SEND_INTERVAL_MIN : SEND_INTERVAL_MIN_UNLOADED;
+
+  if ( SEND_INTERVAL < interval_min ) {
+    SEND_INTERVAL = interval_min;
   } else if ( SEND_INTERVAL > SEND_INTERVAL_MAX ) {
     SEND_INTERVAL = SEND_INTERVAL_MAX;
   }
@@ -101,15 +140,26 @@ void TransportSender<MyState>::calculate_timers( void )
   if ( !(current_state == sent_states.back().state) ) {
     if ( mindelay_clock == uint64_t( -1 ) ) {
       mindelay_clock = now;
+
+      /* adapt the collection delay to the arrival rate (see header) */
+      const uint64_t gap = now - last_pending_start;
+      if ( gap >= uint64_t( MINDELAY_IDLE_TIMEOUT ) ) {
+	adaptive_mindelay = 0;
+      } else if ( gap <= uint64_t( MINDELAY_RAMP_GAP ) ) {
+	adaptive_mindelay = SEND_MINDELAY;
+      } else if ( adaptive_mindelay > 0 ) {
+	adaptive_mindelay /= 2;
+      }
+      last_pending_start = now;
     }
 
-    next_send_time = std::max( mindelay_clock + SEND_MINDELAY,
+    next_send_time = std::max( mindelay_clock + adaptive_mindelay,
 			       sent_states.back().timestamp + send_interval() );
-  } else if ( !(current_state == assumed_receiver_state->state)
+  } else if ( !(current_state == sent_states[ assumed_receiver_state ].state)
 	      && (last_heard + ACTIVE_RETRY_TIMEOUT > now) ) {
     next_send_time = sent_states.back().timestamp + send_interval();
     if ( mindelay_clock != uint64_t( -1 ) ) {
-      next_send_time = std::max( next_send_time, mindelay_clock + SEND_MINDELAY );
+      next_send_time = std::max( next_send_time, mindelay_clock + adaptive_mindelay );
     }
   } else if ( !(current_state == sent_states.front().state )
 	      && (last_heard + ACTIVE_RETRY_TIMEOUT > now) ) {
@@ -141,6 +191,20 @@ int TransportSender<MyState>::wait_time( void )
     return INT_MAX;
   }
 
+  /* A fully-acked idle server schedules no wakeup of its own: the
+     client's ACK_INTERVAL keepalive is the one timer the session
+     needs, and the socket activity it causes wakes us with
+     next_ack_time already due, so the answering ack goes right out.
+     (The client can't do the same; its keepalive is what holds NAT
+     bindings open and resets the server's association timeout.) */
+  if ( connection->is_server()
+       && ( next_send_time == uint64_t( -1 ) )
+       && !pending_data_ack
+       && !shutdown_in_progress
+       && ( ack_num != uint64_t( -1 ) ) ) {
+    return INT_MAX;
+  }
+
   if ( next_wakeup > now ) {
     return next_wakeup - now;
   } else {
@@ -158,6 +222,12 @@ void TransportSender<MyState>::tick( void )
     return;
   }
 
+  if ( !mirrors.empty() ) {
+    mirror_tick();
+  }
+
+  maybe_send_probe();
+
   uint64_t now = timestamp();
 
   if ( (now < next_ack_time)
@@ -166,23 +236,29 @@ void TransportSender<MyState>::tick( void )
   }
 
   /* Determine if a new diff or empty ack needs to be sent */
-    
-  string diff = current_state.diff_from( assumed_receiver_state->state );
 
-  attempt_prospective_resend_optimization( diff );
+  string diff;
+  if ( !(current_state == sent_states[ assumed_receiver_state ].state) ) {
+    /* Serialize lazily: when the assumed receiver state already
+       matches, the diff is empty by construction and need not be
+       generated at all. */
+    diff = diff_from_sent_state( assumed_receiver_state );
 
-  if ( verbose ) {
-    /* verify diff has round-trip identity (modulo Unicode fallback rendering) */
-    MyState newstate( assumed_receiver_state->state );
-    newstate.apply_string( diff );
-    if ( current_state.compare( newstate ) ) {
-      fprintf( stderr, "Warning, round-trip Instruction verification failed!\n" );
-    }
-    /* Also verify that both the original frame and generated frame have the same initial diff. */
-    std::string current_diff( current_state.init_diff() );
-    std::string new_diff( newstate.init_diff() );
-    if ( current_diff != new_diff ) {
-      fprintf( stderr, "Warning, target state Instruction verification failed!\n" );
+    attempt_prospective_resend_optimization( diff );
+
+    if ( verbose ) {
+      /* verify diff has round-trip identity (modulo Unicode fallback rendering) */
+      MyState newstate( sent_states[ assumed_receiver_state ].state );
+      newstate.apply_string( diff );
+      if ( current_state.compare( newstate ) ) {
+	fprintf( stderr, "Warning, round-trip Instruction verification failed!\n" );
+      }
+      /* Also verify that both the original frame and generated frame have the same initial diff. */
+      std::string current_diff( current_state.init_diff() );
+      std::string new_diff( newstate.init_diff() );
+      if ( current_diff != new_diff ) {
+	fprintf( stderr, "Warning, target state Instruction verification failed!\n" );
+      }
     }
   }
 
@@ -227,17 +303,66 @@ void TransportSender<MyState>::send_empty_ack( void )
 template <class MyState>
 void TransportSender<MyState>::add_sent_state( uint64_t the_timestamp, uint64_t num, MyState &state )
 {
+  const AllocStats::ScopeTag tag( AllocStats::SUBSYS_STATESYNC ); /* the copy of state */
   sent_states.push_back( TimestampedState<MyState>( the_timestamp, num, state ) );
-  if ( sent_states.size() > 32 ) { /* limit on state queue */
-    typename sent_states_type::iterator last = sent_states.end();
-    for ( int i = 0; i < 16; i++ ) { last--; }
-    sent_states.erase( last ); /* erase state from middle of queue */
+  const typename sent_states_type::size_type limit = state_queue_limit();
+  if ( sent_states.size() > limit ) { /* limit on state queue */
+    /* erase state from middle of queue */
+    typename sent_states_type::size_type erase_idx = sent_states.size() - limit / 2;
+    sent_states.erase( sent_states.begin() + erase_idx );
+    if ( (assumed_receiver_state >= erase_idx) && (assumed_receiver_state > 0) ) {
+      assumed_receiver_state--;
+    }
   }
 }
 
+/* Memoized diff of current_state against a sent state.  Rationalizing
+   subtracts the same acknowledged prefix from every state, so the diff
+   between any surviving pair is unaffected and the cache can live
+   across ticks until current_state itself is touched. */
+template <class MyState>
+const string & TransportSender<MyState>::diff_from_sent_state( typename std::deque< TimestampedState<MyState> >::size_type idx )
+{
+  const uint64_t source_num = sent_states[ idx ].num;
+  typename diff_cache_type::iterator i = diff_cache.find( source_num );
+  if ( i == diff_cache.end() ) {
+    const LatencyStats::StageTimer timer( LatencyStats::STAGE_DIFF );
+    const AllocStats::ScopeTag tag( AllocStats::SUBSYS_STATESYNC );
+    if ( diff_cache.size() > state_queue_limit() ) { /* match limit on state queue */
+      diff_cache.clear();
+    }
+    string new_diff( current_state.diff_from( sent_states[ idx ].state ) );
+    i = diff_cache.insert( std::make_pair( source_num, string() ) ).first;
+    i->second.swap( new_diff ); /* steal the diff instead of copying it into the map */
+  }
+  return i->second;
+}
+
 template <class MyState>
 void TransportSender<MyState>::send_to_receiver( const string & diff )
 {
+  /* Preempt a flood-sized frame with the echo ack it would carry.
+     An instruction too big for one datagram reaches the receiver only
+     once every fragment has, so during an output flood the tiny state
+     change confirming the user's keystrokes would queue behind -- and
+     share fate with -- a multi-fragment screen update.  Send the ack
+     first as a state of its own (the last sent framebuffer plus the
+     new echo ack): it fits in one datagram and applies the moment it
+     lands, so predictions clear even while the big frame is still in
+     flight.  The frame right behind it supersedes the extra state and
+     the collapse below reclaims it. */
+  if ( !shutdown_in_progress
+       && ( assumed_receiver_state == sent_states.size() - 1 )
+       && ( diff.size() > size_t( connection->get_MTU() - Network::Connection::ADDED_BYTES
+				  - Crypto::Session::ADDED_BYTES ) )
+       && current_state.echo_ack_newer_than( sent_states.back().state ) ) {
+    const uint64_t echo_num = sent_states.back().num + 1;
+    MyState echo_state( current_state.echo_ack_state( sent_states.back().state ) );
+    const string echo_diff( echo_state.diff_from( sent_states.back().state ) );
+    add_sent_state( timestamp(), echo_num, echo_state );
+    send_in_fragments( echo_diff, echo_num );
+  }
+
   uint64_t new_num;
   if ( current_state == sent_states.back().state ) { /* previously sent */
     new_num = sent_states.back().num;
@@ -250,9 +375,29 @@ void TransportSender<MyState>::send_to_receiver( const string & diff )
     new_num = uint64_t( -1 );
   }
 
+  if ( ( tap != NULL ) && tap->is_open()
+       && !( current_state == sent_states.back().state ) ) {
+    /* record the chain diff before the collapse below can pop its base */
+    const string & chain_diff = diff_from_sent_state( sent_states.size() - 1 );
+    if ( !chain_diff.empty() ) {
+      tap->record( timestamp(), chain_diff );
+    }
+  }
+
   if ( new_num == sent_states.back().num ) {
     sent_states.back().timestamp = timestamp();
   } else {
+    /* Collapse intermediate states that are already obsolete: never
+       acknowledged, no longer the assumed receiver state, and
+       superseded by the state we're about to send.  During an output
+       flood this keeps the queue from filling with states whose only
+       remaining cost is rationalization.  (Acks for a collapsed num
+       are ignored, the same as for states culled from the middle of
+       a full queue.) */
+    while ( ( sent_states.size() > 1 )
+	    && ( assumed_receiver_state < sent_states.size() - 1 ) ) {
+      sent_states.pop_back();
+    }
     add_sent_state( timestamp(), new_num, current_state );
   }
 
@@ -260,8 +405,7 @@ void TransportSender<MyState>::send_to_receiver( const string & diff )
 
   /* successfully sent, probably */
   /* ("probably" because the FIRST size-exceeded datagram doesn't get an error) */
-  assumed_receiver_state = sent_states.end();
-  assumed_receiver_state--;
+  assumed_receiver_state = sent_states.size() - 1;
   next_ack_time = timestamp() + ACK_INTERVAL;
   next_send_time = uint64_t(-1);
 }
@@ -273,21 +417,16 @@ void TransportSender<MyState>::update_assumed_receiver_state( void )
 
   /* start from what is known and give benefit of the doubt to unacknowledged states
      transmitted recently enough ago */
-  assumed_receiver_state = sent_states.begin();
-
-  typename list< TimestampedState<MyState> >::iterator i = sent_states.begin();
-  i++;
+  assumed_receiver_state = 0;
 
-  while ( i != sent_states.end() ) {
-    assert( now >= i->timestamp );
+  for ( typename sent_states_type::size_type i = 1; i < sent_states.size(); i++ ) {
+    assert( now >= sent_states[ i ].timestamp );
 
-    if ( uint64_t(now - i->timestamp) < connection->timeout() + ACK_DELAY ) {
+    if ( uint64_t(now - sent_states[ i ].timestamp) < connection->timeout() + ACK_DELAY ) {
       assumed_receiver_state = i;
     } else {
       return;
     }
-
-    i++;
   }
 }
 
@@ -298,22 +437,47 @@ void TransportSender<MyState>::rationalize_states( void )
 
   current_state.subtract( known_receiver_state );
 
-  for ( typename list< TimestampedState<MyState> >::reverse_iterator i = sent_states.rbegin();
+  for ( typename sent_states_type::reverse_iterator i = sent_states.rbegin();
 	i != sent_states.rend();
 	i++ ) {
     i->state.subtract( known_receiver_state );
   }
 }
 
+/* Pad the instruction out to the next size bucket (64, 128, 256,
+   512 bytes), so an eavesdropper sees a handful of frame lengths
+   instead of one per keystroke pattern.  The pad bytes are slices of
+   a random pool drawn once per session: no per-packet entropy, but
+   still incompressible, so the bucket survives the fragmenter's
+   compression pass.  Frames already beyond the top bucket are sent
+   bare; fragmentation quantizes those to the MTU on its own. */
 template <class MyState>
-const string TransportSender<MyState>::make_chaff( void )
+const string TransportSender<MyState>::make_chaff( size_t serialized_len )
 {
-  const size_t CHAFF_MAX = 16;
-  const size_t chaff_len = prng.uint8() % (CHAFF_MAX + 1);
+  if ( !padding ) {
+    return string();
+  }
+
+  if ( pad_pool.empty() ) {
+    char pool[ PADDING_BUCKET_MAX ];
+    prng.fill( pool, sizeof pool );
+    pad_pool = string( pool, sizeof pool );
+  }
+
+  /* account for the chaff field's own tag and length varint */
+  const size_t field_overhead = 3;
+
+  size_t bucket = PADDING_BUCKET_MIN;
+  while ( ( bucket < PADDING_BUCKET_MAX )
+	  && ( bucket < serialized_len + field_overhead ) ) {
+    bucket *= 2;
+  }
+
+  if ( serialized_len + field_overhead >= bucket ) {
+    return string(); /* past the top bucket */
+  }
 
-  char chaff[ CHAFF_MAX ];
-  prng.fill( chaff, chaff_len );
-  return string( chaff, chaff_len );
+  return pad_pool.substr( 0, bucket - serialized_len - field_overhead );
 }
 
 template <class MyState>
@@ -321,59 +485,206 @@ void TransportSender<MyState>::send_in_fragments( const string & diff, uint64_t
 {
   Instruction inst;
 
+  const uint64_t old_num = sent_states[ assumed_receiver_state ].num;
+  const uint64_t throwaway_num = sent_states.front().num;
+
+  /* The state numbers are delta-coded (mod 2^64) so their varints stay
+     short for the life of a session: old_num against new_num,
+     throwaway_num against old_num, and new_num zigzagged against the
+     peer's counter in ack_num.  Undone in recv_datagram(). */
   inst.set_protocol_version( MOSH_PROTOCOL_VERSION );
-  inst.set_old_num( assumed_receiver_state->num );
-  inst.set_new_num( new_num );
+  inst.set_old_num( new_num - old_num );
+  inst.set_new_num( zigzag( new_num - ack_num ) );
   inst.set_ack_num( ack_num );
-  inst.set_throwaway_num( sent_states.front().num );
+  inst.set_throwaway_num( old_num - throwaway_num );
   inst.set_diff( diff );
-  inst.set_chaff( make_chaff() );
+  inst.set_chaff( make_chaff( inst.ByteSizeLong() ) );
 
   if ( new_num == uint64_t(-1) ) {
     shutdown_tries++;
   }
 
-  vector<Fragment> fragments = fragmenter.make_fragments( inst, connection->get_MTU()
-							  - Network::Connection::ADDED_BYTES
-							  - Crypto::Session::ADDED_BYTES );
-  for ( vector<Fragment>::iterator i = fragments.begin();
-        i != fragments.end();
-        i++ ) {
-    connection->send( i->tostring() );
-
-    if ( verbose ) {
+  const vector<string> & payloads = fragmenter.make_fragments( inst, connection->get_MTU()
+						       - Network::Connection::ADDED_BYTES
+						       - Crypto::Session::ADDED_BYTES );
+  if ( verbose ) {
+    for ( vector<string>::size_type i = 0; i < payloads.size(); i++ ) {
       fprintf( stderr, "[%u] Sent [%d=>%d] id %d, frag %d ack=%d, throwaway=%d, len=%d, frame rate=%.2f, timeout=%d, srtt=%.1f\n",
-	       (unsigned int)(timestamp() % 100000), (int)inst.old_num(), (int)inst.new_num(), (int)i->id, (int)i->fragment_num,
-	       (int)inst.ack_num(), (int)inst.throwaway_num(), (int)i->contents.size(),
+	       (unsigned int)(timestamp() % 100000), (int)old_num, (int)new_num,
+	       (int)fragmenter.last_instruction_id(), (int)i,
+	       (int)ack_num, (int)throwaway_num,
+	       (int)( payloads[ i ].size() - Fragment::frag_header_len ),
 	       1000.0 / (double)send_interval(),
 	       (int)connection->timeout(), connection->get_SRTT() );
     }
+  }
 
+  /* all fragments of the instruction go out in one batch */
+  connection->send( payloads );
+
+  /* fan the same fragments out to any observers: one diff and
+     serialization, one extra encrypt+send per mirror.  (Connection
+     ignores the send until the observer has made contact.) */
+  for ( typename std::vector< Mirror >::iterator m = mirrors.begin();
+	m != mirrors.end();
+	m++ ) {
+    m->connection->send( payloads );
+  }
+
+  /* record the frame size for the delivery-rate estimator */
+  uint64_t frame_bytes = 0;
+  for ( vector<string>::size_type i = 0; i < payloads.size(); i++ ) {
+    frame_bytes += payloads[ i ].size();
+  }
+  last_frame_bytes = frame_bytes;
+  if ( new_num != uint64_t( -1 ) ) {
+    unacked_frames[ new_num ] = std::make_pair( frame_bytes, timestamp() );
+    if ( unacked_frames.size() > 64 ) { /* unacknowledged during an outage */
+      unacked_frames.erase( unacked_frames.begin() );
+    }
   }
 
   pending_data_ack = false;
+
+  if ( lowmem ) {
+    /* a large frame must not pin its scratch for the whole session */
+    fragmenter.trim();
+  }
+}
+
+/* Path MTU discovery (cf. RFC 8899): when the connection wants to try
+   a larger datagram, send an empty instruction padded out to the
+   candidate size and marked don't-fragment.  The probe gets a state
+   number of its own; process_acknowledgment_through() renders the
+   verdict. */
+template <class MyState>
+void TransportSender<MyState>::maybe_send_probe( void )
+{
+  uint64_t now = timestamp();
+
+  if ( probe_num != 0 ) {
+    if ( now - probe_sent_time >= uint64_t( MTU_PROBE_TIMEOUT ) ) {
+      connection->probe_result( false ); /* presumed lost */
+      probe_num = 0;
+    }
+    return;
+  }
+
+  if ( shutdown_in_progress ) {
+    return;
+  }
+
+  /* The probe's empty diff is only truthful when the receiver is
+     caught up (the same precondition as an empty ack); otherwise the
+     numbered state it announces would not match what the receiver
+     reconstructs.  Quiet moments are when we want to probe anyway. */
+  if ( !( current_state == sent_states[ assumed_receiver_state ].state ) ) {
+    return;
+  }
+
+  const size_t target_len = connection->probe_payload_size();
+  if ( target_len == 0 ) {
+    return;
+  }
+
+  const uint64_t new_num = sent_states.back().num + 1;
+  const uint64_t old_num = sent_states[ assumed_receiver_state ].num;
+  const uint64_t throwaway_num = sent_states.front().num;
+
+  Instruction inst;
+  inst.set_protocol_version( MOSH_PROTOCOL_VERSION );
+  inst.set_old_num( new_num - old_num );
+  inst.set_new_num( zigzag( new_num - ack_num ) );
+  inst.set_ack_num( ack_num );
+  inst.set_throwaway_num( old_num - throwaway_num );
+  inst.set_diff( "" );
+
+  /* Pad with random (incompressible) bytes, with margin for the field
+     and compression overhead; the size actually emitted is what gets
+     verified, so the margin only needs to keep us under the target. */
+  const size_t base_len = inst.ByteSizeLong();
+  if ( target_len <= base_len + 64 ) {
+    return;
+  }
+  string chaff( target_len - base_len - 64, '\0' );
+  prng.fill( &chaff[ 0 ], chaff.size() );
+  inst.set_chaff( chaff );
+
+  /* the probe must go out as a single datagram: fragment at its own size */
+  const vector<string> & payloads = probe_fragmenter.make_fragments( inst, target_len
+								     + Fragment::frag_header_len
+								     + sizeof( uint16_t ) );
+  if ( payloads.size() != 1 ) {
+    return; /* too big to be one datagram; not a usable probe */
+  }
+
+  if ( !connection->send_probe( payloads.front() ) ) {
+    return;
+  }
+
+  add_sent_state( now, new_num, current_state );
+  probe_num = new_num;
+  probe_sent_time = now;
+
+  /* The probe carries our ack, so it stands in for the scheduled
+     empty ack.  Without this the keepalive would bump the state
+     number past the probe's and make its verdict inconclusive. */
+  next_ack_time = now + ACK_INTERVAL;
 }
 
 template <class MyState>
 void TransportSender<MyState>::process_acknowledgment_through( uint64_t ack_num )
 {
+  /* Verdict on an outstanding path MTU probe: only the probe carried
+     probe_num, so an acknowledgment of exactly that number means the
+     probe-sized datagram traversed the path.  An ack that jumps past
+     it is inconclusive -- acks name the newest state received, not
+     every state -- and the probe is retried rather than trusted. */
+  if ( ( probe_num != 0 ) && ( ack_num >= probe_num ) ) {
+    connection->probe_result( ack_num == probe_num );
+    probe_num = 0;
+  }
+
+  /* Sample the delivery rate from the frames this ack covers: bytes
+     sent over the time they took to be acknowledged.  Rise quickly to
+     a faster estimate; decay slowly from a stale one. */
+  uint64_t now = timestamp();
+  while ( !unacked_frames.empty()
+	  && ( unacked_frames.begin()->first <= ack_num ) ) {
+    const uint64_t frame_bytes = unacked_frames.begin()->second.first;
+    const uint64_t sent_at = unacked_frames.begin()->second.second;
+    if ( now > sent_at ) {
+      const double sample = double( frame_bytes ) / double( now - sent_at );
+      if ( sample > delivery_rate ) {
+	delivery_rate = sample;
+      } else {
+	delivery_rate = 0.875 * delivery_rate + 0.125 * sample;
+      }
+    }
+    unacked_frames.erase( unacked_frames.begin() );
+  }
+
   /* Ignore ack if we have culled the state it's acknowledging */
 
-  typename sent_states_type::iterator i;
-  for ( i = sent_states.begin(); i != sent_states.end(); i++ ) {
-    if ( i->num == ack_num ) {
-      break;
+  /* states are kept in increasing order of num, so binary-search */
+  typename sent_states_type::size_type lo = 0, hi = sent_states.size();
+  while ( lo < hi ) {
+    typename sent_states_type::size_type mid = lo + ( hi - lo ) / 2;
+    if ( sent_states[ mid ].num < ack_num ) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
     }
   }
 
-  if ( i != sent_states.end() ) {
-    for ( i = sent_states.begin(); i != sent_states.end(); ) {
-      typename sent_states_type::iterator i_next = i;
-      i_next++;
-      if ( i->num < ack_num ) {
-	sent_states.erase( i );
+  if ( (lo < sent_states.size())
+       && (sent_states[ lo ].num == ack_num) ) {
+    /* prune all states before the acknowledged one */
+    while ( sent_states.front().num < ack_num ) {
+      sent_states.pop_front();
+      if ( assumed_receiver_state > 0 ) {
+	assumed_receiver_state--;
       }
-      i = i_next;
     }
   }
   assert( !sent_states.empty() );
@@ -406,11 +717,23 @@ void TransportSender<MyState>::set_ack_num( uint64_t s_ack_num )
 template <class MyState>
 void TransportSender<MyState>::attempt_prospective_resend_optimization( string &proposed_diff )
 {
-  if ( assumed_receiver_state == sent_states.begin() ) {
+  if ( assumed_receiver_state == 0 ) {
+    return;
+  }
+
+  if ( lowmem ) {
+    return; /* not worth a second cached diff on a constrained host */
+  }
+
+  if ( proposed_diff.size() >= 1000 ) {
+    /* A flood-sized frame: a resend diff from an older state would
+       cover strictly more changes, so don't pay to serialize one we
+       would never adopt. */
     return;
   }
 
-  string resend_diff = current_state.diff_from( sent_states.front().state );
+  /* the memoized diff stays put in the cache; no need for a copy here */
+  const string & resend_diff = diff_from_sent_state( 0 );
 
   /* We do a prophylactic resend if it would make the diff shorter,
      or if it would lengthen it by no more than 100 bytes and still be
@@ -419,9 +742,117 @@ void TransportSender<MyState>::attempt_prospective_resend_optimization( string &
   if ( (resend_diff.size() <= proposed_diff.size())
        || ( (resend_diff.size() < 1000)
 	    && (resend_diff.size() - proposed_diff.size() < 100) ) ) {
-    assumed_receiver_state = sent_states.begin();
+    assumed_receiver_state = 0;
     proposed_diff = resend_diff;
   }
 }
 
+/* Datagrams from an observer are read only for their acknowledgment
+   number -- the newest primary-stream state the observer holds.  The
+   rest of a read-only link's input is ignored. */
+template <class MyState>
+void TransportSender<MyState>::mirror_recv( void )
+{
+  for ( typename std::vector< Mirror >::iterator m = mirrors.begin();
+	m != mirrors.end();
+	m++ ) {
+    while ( true ) {
+      string s;
+      try {
+	s = m->connection->recv();
+      } catch ( NetworkException & e ) {
+	break; /* nothing more to read on this connection */
+      } catch ( CryptoException & e ) {
+	continue; /* unauthenticated datagram; drop it */
+      }
+
+      try {
+	Fragment frag( s );
+	if ( m->fragments.add_fragment( frag ) ) {
+	  const Instruction inst( m->fragments.get_assembly() );
+	  /* ack_num rides raw through the delta coding */
+	  if ( ( inst.protocol_version() == MOSH_PROTOCOL_VERSION )
+	       && ( inst.ack_num() > m->acked_num ) ) {
+	    m->acked_num = inst.ack_num();
+	  }
+	}
+      } catch ( CryptoException & e ) {
+	continue; /* malformed fragment; drop it */
+      }
+    }
+  }
+}
+
+/* An observer needs a catch-up frame when its newest acked state
+   predates everything we still hold: the fanned-out diffs can no
+   longer reference anything it has, so left alone it would stall. */
+template <class MyState>
+void TransportSender<MyState>::mirror_tick( void )
+{
+  if ( shutdown_in_progress ) {
+    return;
+  }
+
+  uint64_t now = timestamp();
+  for ( typename std::vector< Mirror >::iterator m = mirrors.begin();
+	m != mirrors.end();
+	m++ ) {
+    if ( !m->connection->get_has_remote_addr() ) {
+      continue; /* observer hasn't made contact yet */
+    }
+    if ( ( m->acked_num >= sent_states.front().num )
+	 || ( now < m->next_catchup_time ) ) {
+      continue;
+    }
+    send_catchup( *m );
+    m->next_catchup_time = now + MIRROR_CATCHUP_INTERVAL;
+  }
+}
+
+/* One observer-only frame from a state the observer holds to our
+   newest sent state.  If we still hold the observer's state, the diff
+   is exact; otherwise fall back to init_diff, which repaints
+   everything that differs from a fresh state (anything that happens
+   to match one is healed by later updates). */
+template <class MyState>
+void TransportSender<MyState>::send_catchup( Mirror &mirror )
+{
+  const TimestampedState<MyState> & newest = sent_states.back();
+  const uint64_t new_num = newest.num;
+  const uint64_t old_num = mirror.acked_num;
+
+  string diff;
+  typename sent_states_type::const_iterator source = sent_states.begin();
+  while ( ( source != sent_states.end() ) && ( source->num != old_num ) ) {
+    source++;
+  }
+
+  {
+    const LatencyStats::StageTimer timer( LatencyStats::STAGE_DIFF );
+    const AllocStats::ScopeTag tag( AllocStats::SUBSYS_STATESYNC );
+    if ( source != sent_states.end() ) {
+      diff = newest.state.diff_from( source->state );
+    } else {
+      diff = newest.state.init_diff();
+    }
+  }
+
+  /* same delta coding as send_in_fragments */
+  Instruction inst;
+  inst.set_protocol_version( MOSH_PROTOCOL_VERSION );
+  inst.set_old_num( new_num - old_num );
+  inst.set_new_num( zigzag( new_num - ack_num ) );
+  inst.set_ack_num( ack_num );
+  inst.set_throwaway_num( 0 ); /* decodes to old_num: the observer may
+				  discard anything below the state we
+				  diffed from */
+  inst.set_diff( diff );
+  inst.set_chaff( make_chaff( inst.ByteSizeLong() ) );
+
+  const vector<string> & payloads = mirror_fragmenter.make_fragments( inst, mirror.connection->get_MTU()
+								      - Network::Connection::ADDED_BYTES
+								      - Crypto::Session::ADDED_BYTES );
+  mirror.connection->send( payloads );
+}
+
 #endif
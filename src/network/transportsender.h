@@ -35,26 +35,40 @@
 #define TRANSPORT_SENDER_HPP
 
 #include <string>
-#include <list>
+#include <deque>
+#include <map>
 
 #include "network.h"
 #include "transportinstruction.pb.h"
 #include "transportstate.h"
 #include "transportfragment.h"
+#include "recordingtap.h"
 #include "prng.h"
 
 namespace Network {
-  using std::list;
+  using std::deque;
   using std::pair;
   using namespace TransportBuffers;
 
   /* timing parameters */
   const int SEND_INTERVAL_MIN = 20; /* ms between frames */
+  const int SEND_INTERVAL_MIN_UNLOADED = 8; /* ms between frames when the path shows no queueing */
   const int SEND_INTERVAL_MAX = 250; /* ms between frames */
+  const int QUEUEING_DELAY_LIMIT = 25; /* ms of delay above the RTT floor before we back off */
   const int ACK_INTERVAL = 3000; /* ms between empty acks */
   const int ACK_DELAY = 100; /* ms before delayed ack */
   const int SHUTDOWN_RETRIES = 16; /* number of shutdown packets to send before giving up */
   const int ACTIVE_RETRY_TIMEOUT = 10000; /* attempt to resend at frame rate */
+  const int MIRROR_CATCHUP_INTERVAL = 1000; /* ms between catch-up frames to a lagging observer */
+  const int MTU_PROBE_TIMEOUT = 5000; /* ms before an unacknowledged path MTU probe is presumed lost */
+  const int MINDELAY_IDLE_TIMEOUT = 250; /* ms of quiet before the collection delay resets to zero */
+  const int MINDELAY_RAMP_GAP = 20; /* events closer together than this restore full batching */
+
+  /* padding buckets for instruction length (see make_chaff); also how
+     the receiver recognizes a path MTU probe, which is padded past the
+     top bucket and deserves a prompt ack */
+  const size_t PADDING_BUCKET_MIN = 64;
+  const size_t PADDING_BUCKET_MAX = 512;
 
   template <class MyState>
   class TransportSender
@@ -68,23 +82,73 @@ namespace Network {
     void send_empty_ack( void );
     void send_in_fragments( const string & diff, uint64_t new_num );
     void add_sent_state( uint64_t the_timestamp, uint64_t num, MyState &state );
+    const string & diff_from_sent_state( typename std::deque< TimestampedState<MyState> >::size_type idx );
 
     /* state of sender */
     Connection *connection;
 
     MyState current_state;
 
-    typedef list< TimestampedState<MyState> > sent_states_type;
+    /* a deque so that states are indexable (they are kept in
+       increasing order of num) and ack pruning pops from the front */
+    typedef deque< TimestampedState<MyState> > sent_states_type;
     sent_states_type sent_states;
     /* first element: known, acknowledged receiver state */
     /* last element: last sent state */
 
-    /* somewhere in the middle: the assumed state of the receiver */
-    typename sent_states_type::iterator assumed_receiver_state;
+    /* somewhere in the middle: the assumed state of the receiver.
+       An index, not an iterator, so it survives pushes and pruning. */
+    typename sent_states_type::size_type assumed_receiver_state;
+
+    /* memoized diffs of current_state against sent states, keyed by
+       state num (nums are never reused); flushed whenever
+       current_state may have changed.  Repeated ticks over a quiet
+       network reuse the serialized diff instead of re-walking the
+       state. */
+    typedef std::map< uint64_t, string > diff_cache_type;
+    diff_cache_type diff_cache;
 
     /* for fragment creation */
     Fragmenter fragmenter;
 
+    /* Read-only observers: each mirror connection receives a copy of
+       every outgoing fragment burst, so N observers cost N encrypted
+       sends off one diff/serialization/fragmentation.  The observer's
+       own instructions are parsed only for their ack_num, which tells
+       us when it has fallen off the primary stream and needs a
+       catch-up frame. */
+    class Mirror {
+    public:
+      Connection *connection; /* not owned */
+      FragmentAssembly fragments; /* to read the observer's acks */
+      uint64_t acked_num;
+      uint64_t next_catchup_time;
+      Mirror( Connection *s_connection )
+	: connection( s_connection ), fragments(),
+	  acked_num( 0 ), next_catchup_time( 0 )
+      {}
+    };
+    std::vector< Mirror > mirrors;
+    /* catch-up instructions get their own id space, clear of the
+       primary stream's, so the observer's reassembly never conflates
+       the two */
+    Fragmenter mirror_fragmenter;
+
+    void mirror_tick( void );
+    void send_catchup( Mirror &mirror );
+
+    /* Path MTU probe in flight: the state number the probe carries
+       and when it went out.  Only the probe carries this num, so an
+       acknowledgment of exactly probe_num proves the probe's size
+       traversed the path.  Probes get their own fragmenter (and id
+       space) so they never disturb the primary stream's resend
+       detection. */
+    Fragmenter probe_fragmenter;
+    uint64_t probe_num;
+    uint64_t probe_sent_time;
+
+    void maybe_send_probe( void );
+
     /* timing state */
     uint64_t next_ack_time;
     uint64_t next_send_time;
@@ -104,12 +168,48 @@ namespace Network {
 
     uint64_t last_heard; /* last time received new state */
 
-    /* chaff to disguise instruction length */
+    /* Padding to disguise instruction length: the serialized
+       instruction is rounded up to the next size bucket with slices
+       of a pool of random bytes drawn once at startup.  Random (and
+       thus incompressible) contents are required because the chaff
+       field rides through the fragmenter's compressor; a run of
+       zeros would deflate away along with the bucket boundary. */
     PRNG prng;
-    const string make_chaff( void );
+    string pad_pool;
+    bool padding;
+    const string make_chaff( size_t serialized_len );
+
+    /* Bounded-memory mode for constrained hosts: keep only a handful
+       of sent states, return oversized scratch to the allocator after
+       each send, and skip the prospective-resend optimization (whose
+       only cost is an extra cached diff).  Trades some retransmit
+       efficiency for a hard ceiling on resident size. */
+    bool lowmem;
+    unsigned int state_queue_limit( void ) const { return lowmem ? 4 : 32; }
+
+    /* Session recording: each new sent state appends its diff from
+       the previous sent state, so the log replays in order from the
+       initial state.  Usually this is the memoized diff being sent
+       anyway, so the capture cost is one buffered write. */
+    RecordingTap *tap; /* not owned */
 
     uint64_t mindelay_clock; /* time of first pending change to current state */
 
+    /* Adaptive collection delay: SEND_MINDELAY exists to coalesce
+       keystrokes, but the first event after a pause has nothing to
+       coalesce with, so it goes out undelayed.  The full delay comes
+       back only while events arrive close enough together that
+       waiting would actually batch them. */
+    uint64_t last_pending_start; /* when the previous pending period began */
+    unsigned int adaptive_mindelay; /* current collection delay, <= SEND_MINDELAY */
+
+    /* delivery-rate estimate, for pacing frames to what the path can
+       actually drain instead of blasting full-size diffs into a queue */
+    double delivery_rate; /* bytes per ms; 0 until the first sample */
+    uint64_t last_frame_bytes;
+    typedef std::map< uint64_t, pair< uint64_t, uint64_t > > unacked_frame_type; /* num => (bytes, send time) */
+    unacked_frame_type unacked_frames;
+
   public:
     /* constructor */
     TransportSender( Connection *s_connection, MyState &initial_state );
@@ -132,17 +232,37 @@ namespace Network {
     /* Received something */
     void remote_heard( uint64_t ts ) { last_heard = ts; }
 
+    /* Attach a read-only observer connection (not owned). */
+    void add_mirror( Connection *c ) { mirrors.push_back( Mirror( c ) ); }
+
+    /* Drain and inspect datagrams from the observer connections. */
+    void mirror_recv( void );
+
+    /* Send a probe right away, e.g. after waking from sleep; timers
+       scheduled before the sleep may be far in the future */
+    void wake( void )
+    {
+      next_send_time = timestamp();
+      next_ack_time = next_send_time;
+    }
+
     /* Starts shutdown sequence */
     void start_shutdown( void ) { if ( !shutdown_in_progress ) { shutdown_start = timestamp(); shutdown_in_progress = true; } }
 
     /* Misc. getters and setters */
     /* Cannot modify current_state while shutdown in progress */
-    MyState &get_current_state( void ) { assert( !shutdown_in_progress ); return current_state; }
+    MyState &get_current_state( void )
+    {
+      assert( !shutdown_in_progress );
+      diff_cache.clear(); /* caller may mutate the state */
+      return current_state;
+    }
     void set_current_state( const MyState &x )
     {
       assert( !shutdown_in_progress );
       current_state = x;
       current_state.reset_input();
+      diff_cache.clear();
     }
     void set_verbose( unsigned int s_verbose ) { verbose = s_verbose; }
 
@@ -153,10 +273,27 @@ namespace Network {
     uint64_t get_sent_state_acked( void ) const { return sent_states.front().num; }
     uint64_t get_sent_state_last( void ) const { return sent_states.back().num; }
 
+    /* for session snapshot/restore */
+    const MyState & get_acked_state( void ) const { return sent_states.front().state; }
+    void fast_forward_num( uint64_t num )
+    {
+      assert( sent_states.size() == 1 );
+      sent_states.front().num = num;
+    }
+
     bool shutdown_ack_timed_out( void ) const;
 
     void set_send_delay( int new_delay ) { SEND_MINDELAY = new_delay; }
 
+    /* for trusted networks where padding bytes are not worth the cost */
+    void set_padding( bool s_padding ) { padding = s_padding; }
+
+    /* for embedded hosts where a memory ceiling beats retransmit efficiency */
+    void set_lowmem( bool s_lowmem ) { lowmem = s_lowmem; }
+
+    /* Attach a session recording tap (not owned). */
+    void set_tap( RecordingTap *s_tap ) { tap = s_tap; }
+
     unsigned int send_interval( void ) const;
 
     /* nonexistent methods to satisfy -Weffc++ */
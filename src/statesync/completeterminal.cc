@@ -32,30 +32,101 @@
 
 #include "completeterminal.h"
 #include "fatal_assert.h"
+#include "allocstats.h"
+#include "latencystats.h"
+#include "byteorder.h"
 
 #include "hostinput.pb.h"
 
 #include <limits.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 using namespace Parser;
 using namespace Terminal;
 using namespace HostBuffers;
 
+/* printable ASCII other than DEL: always one Print action in ground state */
+static bool printable_run_octet( char c )
+{
+  const unsigned char uc = c;
+  return (uc >= 0x20) && (uc <= 0x7E);
+}
+
+/* Length of the printable-ASCII run starting at offset "begin".  Scans
+   16 octets at a time where vector extensions are available; control
+   and non-ASCII octets (< 0x20 or >= 0x7F) terminate the run. */
+static size_t printable_run_length( const string &str, size_t begin )
+{
+  const size_t len = str.size();
+  size_t i = begin;
+
+#if defined(__SSE2__)
+  const char *data = str.data();
+  while ( i + 16 <= len ) {
+    const __m128i chunk = _mm_loadu_si128( (const __m128i *)( data + i ) );
+    /* signed compares: octets >= 0x80 are negative and fail both */
+    const __m128i printable = _mm_and_si128( _mm_cmpgt_epi8( chunk, _mm_set1_epi8( 0x1F ) ),
+					     _mm_cmplt_epi8( chunk, _mm_set1_epi8( 0x7F ) ) );
+    const int nonprintable_mask = _mm_movemask_epi8( printable ) ^ 0xFFFF;
+    if ( nonprintable_mask ) {
+      return i + __builtin_ctz( nonprintable_mask ) - begin;
+    }
+    i += 16;
+  }
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  const char *data = str.data();
+  while ( i + 16 <= len ) {
+    const uint8x16_t chunk = vld1q_u8( (const uint8_t *)( data + i ) );
+    const uint8x16_t printable = vandq_u8( vcgeq_u8( chunk, vdupq_n_u8( 0x20 ) ),
+					   vcleq_u8( chunk, vdupq_n_u8( 0x7E ) ) );
+    if ( vminvq_u8( printable ) == 0 ) {
+      break; /* locate the offending octet below */
+    }
+    i += 16;
+  }
+#endif
+
+  while ( (i < len) && printable_run_octet( str[ i ] ) ) {
+    i++;
+  }
+  return i - begin;
+}
+
 string Complete::act( const string &str )
 {
-  for ( unsigned int i = 0; i < str.size(); i++ ) {
+  const LatencyStats::StageTimer timer( LatencyStats::STAGE_ACT );
+  const AllocStats::ScopeTag tag( AllocStats::SUBSYS_TERMINAL );
+
+  const size_t len = str.size();
+  size_t i = 0;
+  while ( i < len ) {
+    /* fast path: a run of printable ASCII in the ground state prints
+       one single-width cell per octet, so it can bypass the FSM and
+       be applied to the row in bulk */
+    if ( printable_run_octet( str[ i ] ) && parser.is_ground() ) {
+      const size_t run_len = printable_run_length( str, i );
+      terminal.print_run( str.data() + i, run_len );
+      i += run_len;
+      continue;
+    }
+
     /* parse octet into up to three actions */
     parser.input( str[ i ], actions );
-    
-    /* apply actions to terminal and delete them */
-    for ( Actions::iterator it = actions.begin();
+
+    /* apply actions to terminal */
+    for ( Actions::const_iterator it = actions.begin();
 	  it != actions.end();
 	  it++ ) {
-      Action &act = **it;
-      act.act_on_terminal( &terminal );
+      it->act_on_terminal( &terminal );
     }
     actions.clear();
+    i++;
   }
 
   return terminal.read_octets_to_host();
@@ -68,6 +139,253 @@ string Complete::act( const Action &act )
   return terminal.read_octets_to_host();
 }
 
+string Complete::paste( const string &str )
+{
+  terminal.paste( str );
+  return terminal.read_octets_to_host();
+}
+
+/* Binary row-delta wire format (CAP_ROWDELTA), inside RowDelta.rows:
+   for each changed row:
+     uint16 row index, uint16 range count
+     per range: uint16 first column, uint16 cell count
+     per cell: uint8 contents length, uint8 flags (wide/fallback/wrap),
+               uint64 packed renditions, contents octets
+   All integers big-endian.  The receiver writes the cells straight
+   into its framebuffer instead of re-parsing escape sequences. */
+
+static void append_net16( string &out, uint16_t x )
+{
+  uint16_t net = htobe16( x );
+  out.append( (const char *)&net, sizeof( net ) );
+}
+
+static void append_net64( string &out, uint64_t x )
+{
+  uint64_t net = htobe64( x );
+  out.append( (const char *)&net, sizeof( net ) );
+}
+
+static uint16_t read_net16( const string &in, size_t &offset )
+{
+  uint16_t net;
+  fatal_assert( offset + sizeof( net ) <= in.size() );
+  memcpy( &net, in.data() + offset, sizeof( net ) );
+  offset += sizeof( net );
+  return be16toh( net );
+}
+
+static uint64_t read_net64( const string &in, size_t &offset )
+{
+  uint64_t net;
+  fatal_assert( offset + sizeof( net ) <= in.size() );
+  memcpy( &net, in.data() + offset, sizeof( net ) );
+  offset += sizeof( net );
+  return be64toh( net );
+}
+
+/* A row delta can represent the difference only if everything except
+   row contents and cursor position is unchanged. */
+static bool row_delta_applicable( const Framebuffer &existing, const Framebuffer &target )
+{
+  return ( existing.ds.get_width() == target.ds.get_width() )
+    && ( existing.ds.get_height() == target.ds.get_height() )
+    && existing.ds.equal_except_cursor( target.ds )
+    && ( existing.get_window_title() == target.get_window_title() )
+    && ( existing.get_clipboard() == target.get_clipboard() )
+    && ( existing.get_bell_count() == target.get_bell_count() );
+}
+
+static string encode_row_delta( const Framebuffer &existing, const Framebuffer &target )
+{
+  const int height = target.ds.get_height();
+  const int width = target.ds.get_width();
+  string out;
+
+  for ( int y = 0; y < height; y++ ) {
+    const Row *old_row = existing.get_row( y );
+    const Row *new_row = target.get_row( y );
+    if ( ( old_row == new_row )
+	 || ( ( old_row->fingerprint() == new_row->fingerprint() )
+	      && old_row->contents_equal( *new_row ) ) ) {
+      continue;
+    }
+
+    /* coalesce changed cells into ranges */
+    vector< std::pair<int, int> > ranges; /* first column, cell count */
+    int x = 0;
+    while ( x < width ) {
+      if ( old_row->cells[ x ] == new_row->cells[ x ] ) {
+	x++;
+	continue;
+      }
+      const int start = x;
+      while ( ( x < width ) && !( old_row->cells[ x ] == new_row->cells[ x ] ) ) {
+	x++;
+      }
+      ranges.push_back( std::make_pair( start, x - start ) );
+    }
+
+    append_net16( out, y );
+    append_net16( out, ranges.size() );
+
+    for ( vector< std::pair<int, int> >::const_iterator r = ranges.begin();
+	  r != ranges.end();
+	  r++ ) {
+      append_net16( out, r->first );
+      append_net16( out, r->second );
+      for ( int col = r->first; col < r->first + r->second; col++ ) {
+	const Cell &cell = new_row->cells[ col ];
+	out.push_back( (char)cell.get_contents_size() );
+	out.push_back( (char)( cell.get_wide()
+			       | ( cell.get_fallback() << 1 )
+			       | ( cell.get_wrap() << 2 ) ) );
+	append_net64( out, cell.get_renditions().packed() );
+	out.append( cell.get_contents(), cell.get_contents_size() );
+      }
+    }
+  }
+
+  return out;
+}
+
+/* Scrollback wire format (CAP_SCROLLHISTORY), inside ScrollHistory.rows:
+   for each evicted row, oldest first:
+     uint16 cell count
+     per cell: same encoding as the row delta above
+   The receiver cannot be trusted to replay the scroll itself: row
+   deltas write cells in place, and escape-sequence diffs scroll only
+   when the frame diff happens to use the scroll optimization.  So the
+   sender ships the evicted rows explicitly, and the receiver skips any
+   it already captured by replaying a scroll. */
+
+static const size_t SCROLLHISTORY_MAX_ROWS = 128; /* keep any one instruction small */
+
+static string encode_scrollback_rows( const Framebuffer &fb, uint64_t gap )
+{
+  const Framebuffer::rows_type &history = fb.get_scrollback();
+  size_t n = gap;
+  if ( n > history.size() ) {
+    n = history.size();
+  }
+  if ( n > SCROLLHISTORY_MAX_ROWS ) {
+    n = SCROLLHISTORY_MAX_ROWS;
+  }
+
+  string out;
+  for ( Framebuffer::rows_type::const_iterator i = history.end() - n;
+	i != history.end();
+	i++ ) {
+    const Row &row = **i;
+    append_net16( out, row.cells.size() );
+    for ( Row::cells_type::const_iterator c = row.cells.begin();
+	  c != row.cells.end();
+	  c++ ) {
+      out.push_back( (char)c->get_contents_size() );
+      out.push_back( (char)( c->get_wide()
+			     | ( c->get_fallback() << 1 )
+			     | ( c->get_wrap() << 2 ) ) );
+      append_net64( out, c->get_renditions().packed() );
+      out.append( c->get_contents(), c->get_contents_size() );
+    }
+  }
+  return out;
+}
+
+void Complete::apply_scrollhistory( const HostBuffers::ScrollHistory &sh )
+{
+  Framebuffer &fb = terminal.get_fb();
+
+  std::vector<Framebuffer::row_pointer> decoded;
+  const string &rows = sh.rows();
+  size_t offset = 0;
+  while ( offset < rows.size() ) {
+    const int width = read_net16( rows, offset );
+    Framebuffer::row_pointer row = make_shared<Row>( width, 0 );
+
+    for ( int col = 0; col < width; col++ ) {
+      fatal_assert( offset + 2 <= rows.size() );
+      const size_t contents_len = (uint8_t)rows[ offset ];
+      const uint8_t flags = (uint8_t)rows[ offset + 1 ];
+      offset += 2;
+      const uint64_t packed_renditions = read_net64( rows, offset );
+      fatal_assert( contents_len <= Cell::CONTENTS_CAP );
+      fatal_assert( offset + contents_len <= rows.size() );
+
+      Cell &cell = row->cells.at( col );
+      cell.set_contents( rows.data() + offset, contents_len );
+      offset += contents_len;
+      cell.set_wide( flags & 1 );
+      cell.set_fallback( flags & 2 );
+      cell.set_wrap( flags & 4 );
+      cell.get_renditions().load_packed( packed_renditions );
+    }
+
+    decoded.push_back( row );
+  }
+
+  /* The encoded rows cover eviction counts [final_count - decoded.size(),
+     final_count).  An earlier hostbytes instruction in the same diff may
+     have scrolled some of them into our ring already; skip those. */
+  const uint64_t start = sh.final_count() - decoded.size();
+  size_t skip = 0;
+  if ( fb.get_scrollback_count() > start ) {
+    skip = fb.get_scrollback_count() - start;
+  }
+  for ( size_t i = skip; i < decoded.size(); i++ ) {
+    fb.append_scrollback_row( decoded[ i ] );
+  }
+
+  /* the sender's count is authoritative; a window larger than
+     SCROLLHISTORY_MAX_ROWS leaves a gap rather than falling behind */
+  fb.set_scrollback_count( sh.final_count() );
+}
+
+void Complete::apply_rowdelta( const HostBuffers::RowDelta &rd )
+{
+  Framebuffer &fb = terminal.get_fb();
+  const int height = fb.ds.get_height();
+  const int width = fb.ds.get_width();
+
+  const string &rows = rd.rows();
+  size_t offset = 0;
+  while ( offset < rows.size() ) {
+    const int y = read_net16( rows, offset );
+    const int num_ranges = read_net16( rows, offset );
+    fatal_assert( y < height );
+    Row *row = fb.get_mutable_row( y );
+
+    for ( int r = 0; r < num_ranges; r++ ) {
+      const int start = read_net16( rows, offset );
+      const int count = read_net16( rows, offset );
+      fatal_assert( start + count <= width );
+
+      for ( int col = start; col < start + count; col++ ) {
+	fatal_assert( offset + 2 <= rows.size() );
+	const size_t contents_len = (uint8_t)rows[ offset ];
+	const uint8_t flags = (uint8_t)rows[ offset + 1 ];
+	offset += 2;
+	const uint64_t packed_renditions = read_net64( rows, offset );
+	fatal_assert( contents_len <= Cell::CONTENTS_CAP );
+	fatal_assert( offset + contents_len <= rows.size() );
+
+	Cell &cell = row->cells.at( col );
+	cell.set_contents( rows.data() + offset, contents_len );
+	offset += contents_len;
+	cell.set_wide( flags & 1 );
+	cell.set_fallback( flags & 2 );
+	cell.set_wrap( flags & 4 );
+	cell.get_renditions().load_packed( packed_renditions );
+      }
+    }
+  }
+
+  if ( rd.has_cursor_row() && rd.has_cursor_col() ) {
+    fb.ds.move_row( rd.cursor_row() );
+    fb.ds.move_col( rd.cursor_col() );
+  }
+}
+
 /* interface for Network::Transport */
 string Complete::diff_from( const Complete &existing ) const
 {
@@ -80,19 +398,73 @@ string Complete::diff_from( const Complete &existing ) const
   }
 
   if ( !(existing.get_fb() == get_fb()) ) {
-    if ( (existing.get_fb().ds.get_width() != terminal.get_fb().ds.get_width())
-	 || (existing.get_fb().ds.get_height() != terminal.get_fb().ds.get_height()) ) {
-      Instruction *new_res = output.add_instruction();
-      new_res->MutableExtension( resize )->set_width( terminal.get_fb().ds.get_width() );
-      new_res->MutableExtension( resize )->set_height( terminal.get_fb().ds.get_height() );
+    const Framebuffer &existing_fb = existing.get_fb();
+    const Framebuffer &fb = terminal.get_fb();
+    const bool resized = ( existing_fb.ds.get_width() != fb.ds.get_width() )
+      || ( existing_fb.ds.get_height() != fb.ds.get_height() );
+
+    bool delta_sent = false;
+    if ( peer_capabilities & CAP_ROWDELTA ) {
+      if ( !resized && row_delta_applicable( existing_fb, fb ) ) {
+	string rows = encode_row_delta( existing_fb, fb );
+	if ( !rows.empty()
+	     || ( existing_fb.ds.get_cursor_row() != fb.ds.get_cursor_row() )
+	     || ( existing_fb.ds.get_cursor_col() != fb.ds.get_cursor_col() ) ) {
+	  Instruction *new_inst = output.add_instruction();
+	  HostBuffers::RowDelta *rd = new_inst->MutableExtension( rowdelta );
+	  rd->set_cursor_row( fb.ds.get_cursor_row() );
+	  rd->set_cursor_col( fb.ds.get_cursor_col() );
+	  rd->set_rows( rows );
+	}
+	delta_sent = true;
+      } else if ( resized ) {
+	/* Model the resize the receiver will apply itself and diff
+	   row contents against that, so dragging a corner ships the
+	   handful of cells the application redrew instead of
+	   repainting the whole screen through the escape-sequence
+	   path.  Framebuffer::resize is deterministic and runs
+	   identically on both sides, so the model is exact. */
+	Framebuffer reference( existing_fb );
+	reference.resize( fb.ds.get_width(), fb.ds.get_height() );
+	if ( row_delta_applicable( reference, fb ) ) {
+	  Instruction *new_res = output.add_instruction();
+	  new_res->MutableExtension( resize )->set_width( fb.ds.get_width() );
+	  new_res->MutableExtension( resize )->set_height( fb.ds.get_height() );
+
+	  /* always carry the cursor: the resize snapped it */
+	  Instruction *new_inst = output.add_instruction();
+	  HostBuffers::RowDelta *rd = new_inst->MutableExtension( rowdelta );
+	  rd->set_cursor_row( fb.ds.get_cursor_row() );
+	  rd->set_cursor_col( fb.ds.get_cursor_col() );
+	  rd->set_rows( encode_row_delta( reference, fb ) );
+	  delta_sent = true;
+	}
+      }
+    }
+    if ( !delta_sent ) {
+      if ( resized ) {
+	Instruction *new_res = output.add_instruction();
+	new_res->MutableExtension( resize )->set_width( fb.ds.get_width() );
+	new_res->MutableExtension( resize )->set_height( fb.ds.get_height() );
+      }
+      string update = display.new_frame( true, existing_fb, fb );
+      if ( !update.empty() ) {
+	Instruction *new_inst = output.add_instruction();
+	new_inst->MutableExtension( hostbytes )->set_hoststring( update );
+      }
     }
-    string update = display.new_frame( true, existing.get_fb(), terminal.get_fb() );
-    if ( !update.empty() ) {
-      Instruction *new_inst = output.add_instruction();
-      new_inst->MutableExtension( hostbytes )->set_hoststring( update );
+
+    if ( ( peer_capabilities & CAP_SCROLLHISTORY )
+	 && ( fb.get_scrollback_count() > existing_fb.get_scrollback_count() ) ) {
+      /* ship the rows that fell off the top since the reference state */
+      Instruction *new_hist = output.add_instruction();
+      HostBuffers::ScrollHistory *sh = new_hist->MutableExtension( scrollhistory );
+      sh->set_final_count( fb.get_scrollback_count() );
+      sh->set_rows( encode_scrollback_rows( fb, fb.get_scrollback_count()
+					    - existing_fb.get_scrollback_count() ) );
     }
   }
-  
+
   return output.SerializeAsString();
 }
 
@@ -110,6 +482,10 @@ void Complete::apply_string( const string & diff )
     if ( input.instruction( i ).HasExtension( hostbytes ) ) {
       string terminal_to_host = act( input.instruction( i ).GetExtension( hostbytes ).hoststring() );
       assert( terminal_to_host.empty() ); /* server never interrogates client terminal */
+    } else if ( input.instruction( i ).HasExtension( rowdelta ) ) {
+      apply_rowdelta( input.instruction( i ).GetExtension( rowdelta ) );
+    } else if ( input.instruction( i ).HasExtension( scrollhistory ) ) {
+      apply_scrollhistory( input.instruction( i ).GetExtension( scrollhistory ) );
     } else if ( input.instruction( i ).HasExtension( resize ) ) {
       act( Resize( input.instruction( i ).GetExtension( resize ).width(),
 				      input.instruction( i ).GetExtension( resize ).height() ) );
@@ -130,24 +506,24 @@ bool Complete::operator==( Complete const &x ) const
 bool Complete::set_echo_ack( uint64_t now )
 {
   bool ret = false;
-  uint64_t newest_echo_ack = 0;
-
-  for ( input_history_type::const_iterator i = input_history.begin();
-        i != input_history.end();
-        i++ ) {
-    if ( i->second <= now - ECHO_TIMEOUT ) {
-      newest_echo_ack = i->first;
-    }
+  /* start from the current ack: it must never regress, and a session
+     restored from a snapshot has an ack but no input history yet */
+  uint64_t newest_echo_ack = echo_ack;
+
+  /* Arrival times are monotone, so the entries old enough to ack form
+     a prefix of the ring.  Pop all of them but the newest, which
+     becomes the ack point and stays at the head so wait_time() can
+     see when the next entry falls due. */
+  while ( ( input_history_len >= 2 )
+	  && ( input_history[ ( input_history_head + 1 ) % INPUT_HISTORY_CAP ].arrival_time
+	       <= now - ECHO_TIMEOUT ) ) {
+    input_history_head = ( input_history_head + 1 ) % INPUT_HISTORY_CAP;
+    input_history_len--;
   }
 
-  for ( input_history_type::iterator i = input_history.begin();
-	i != input_history.end(); ) {
-    input_history_type::iterator i_next = i;
-    i_next++;
-    if ( i->first < newest_echo_ack ) {
-      input_history.erase( i );
-    }
-    i = i_next;
+  if ( input_history_len
+       && ( input_history[ input_history_head ].arrival_time <= now - ECHO_TIMEOUT ) ) {
+    newest_echo_ack = input_history[ input_history_head ].frame_num;
   }
 
   if ( echo_ack != newest_echo_ack ) {
@@ -161,19 +537,30 @@ bool Complete::set_echo_ack( uint64_t now )
 
 void Complete::register_input_frame( uint64_t n, uint64_t now )
 {
-  input_history.push_back( std::make_pair( n, now ) );
+  unsigned int slot;
+  if ( input_history_len == INPUT_HISTORY_CAP ) {
+    /* overwrite the newest entry; the ack for the frame it replaces
+       just rides along with this one */
+    slot = ( input_history_head + input_history_len - 1 ) % INPUT_HISTORY_CAP;
+  } else {
+    slot = ( input_history_head + input_history_len ) % INPUT_HISTORY_CAP;
+    input_history_len++;
+  }
+  input_history[ slot ].frame_num = n;
+  input_history[ slot ].arrival_time = now;
 }
 
 int Complete::wait_time( uint64_t now ) const
 {
-  if ( input_history.size() < 2 ) {
+  if ( input_history_len < 2 ) {
     return INT_MAX;
   }
 
-  input_history_type::const_iterator it = input_history.begin();
-  it++;
-
-  uint64_t next_echo_ack_time = it->second + ECHO_TIMEOUT;
+  /* the head is the last-acked frame; the entry after it is the next
+     one owed an echo ack */
+  uint64_t next_echo_ack_time
+    = input_history[ ( input_history_head + 1 ) % INPUT_HISTORY_CAP ].arrival_time
+    + ECHO_TIMEOUT;
   if ( next_echo_ack_time <= now ) {
     return 0;
   }
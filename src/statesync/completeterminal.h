@@ -33,7 +33,6 @@
 #ifndef COMPLETE_TERMINAL_HPP
 #define COMPLETE_TERMINAL_HPP
 
-#include <list>
 #include <stdint.h>
 
 #include "parser.h"
@@ -41,6 +40,8 @@
 
 /* This class represents the complete terminal -- a UTF8Parser feeding Actions to an Emulator. */
 
+namespace HostBuffers { class RowDelta; class ScrollHistory; }
+
 namespace Terminal {
   class Complete {
   private:
@@ -53,21 +54,54 @@ namespace Terminal {
     // outside calls to act() to keep horrible things from happening.
     Parser::Actions actions;
 
-    typedef std::list< std::pair<uint64_t, uint64_t> > input_history_type;
-    input_history_type input_history;
+    /* Fixed-capacity ring of (input frame number, arrival time),
+       oldest at the head.  A flat array keeps echo-ack bookkeeping
+       off the heap, and copying a Complete into sent_states copies
+       it memberwise instead of walking list nodes.  Sixteen slots
+       outlast any realistic burst of input frames within
+       ECHO_TIMEOUT; if a burst overflows anyway, the newest slot is
+       overwritten, which only defers the ack for the frame it
+       replaces. */
+    static const unsigned int INPUT_HISTORY_CAP = 16;
+    class InputMark {
+    public:
+      uint64_t frame_num;
+      uint64_t arrival_time;
+      InputMark() : frame_num( 0 ), arrival_time( 0 ) {}
+    };
+    InputMark input_history[ INPUT_HISTORY_CAP ];
+    unsigned int input_history_head; /* index of oldest entry */
+    unsigned int input_history_len;
     uint64_t echo_ack;
 
+    /* features the peer has advertised (not part of the synchronized
+       state; affects only how diffs are encoded) */
+    uint32_t peer_capabilities;
+
+    void apply_rowdelta( const HostBuffers::RowDelta &rd );
+    void apply_scrollhistory( const HostBuffers::ScrollHistory &sh );
+
     static const int ECHO_TIMEOUT = 50; /* for late ack */
 
   public:
+    /* binary row deltas instead of escape-sequence diffs */
+    static const uint32_t CAP_ROWDELTA = 1;
+    /* receive rows scrolled off the top, for local scrollback */
+    static const uint32_t CAP_SCROLLHISTORY = 2;
+
     Complete( size_t width, size_t height ) : parser(), terminal( width, height ), display( false ),
-					      actions(), input_history(), echo_ack( 0 ) {}
+					      actions(), input_history(),
+					      input_history_head( 0 ), input_history_len( 0 ),
+					      echo_ack( 0 ),
+					      peer_capabilities( 0 ) {}
     
     std::string act( const std::string &str );
     std::string act( const Parser::Action &act );
+    std::string paste( const std::string &str );
 
     const Framebuffer & get_fb( void ) const { return terminal.get_fb(); }
     void reset_input( void ) { parser.reset_input(); }
+    void set_peer_capabilities( uint32_t caps ) { peer_capabilities |= caps; }
     uint64_t get_echo_ack( void ) const { return echo_ack; }
     bool set_echo_ack( uint64_t now );
     void register_input_frame( uint64_t n, uint64_t now );
@@ -80,6 +114,18 @@ namespace Terminal {
     void apply_string( const std::string & diff );
     bool operator==( const Complete &x ) const;
 
+    /* Echo-ack preemption (see TransportSender::send_to_receiver):
+       whether we hold a newer echo ack than an already-sent state, and
+       a copy of that state carrying our ack, whose diff from it is one
+       small instruction. */
+    bool echo_ack_newer_than( const Complete &existing ) const { return echo_ack > existing.echo_ack; }
+    Complete echo_ack_state( const Complete &existing ) const
+    {
+      Complete ret( existing );
+      ret.echo_ack = echo_ack;
+      return ret;
+    }
+
     bool compare( const Complete &other ) const;
   };
 }
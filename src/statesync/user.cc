@@ -76,24 +76,53 @@ string UserStream::diff_from( const UserStream &existing ) const
     switch ( my_it->type ) {
     case UserByteType:
       {
-	char the_byte = my_it->userbyte.c;
+	/* Coalesce the whole run of keystrokes into one bytes field,
+	   sized up front, instead of paying the protobuf field
+	   overhead (and a mutable-extension lookup) per key. */
+	deque<UserEvent>::const_iterator run_end = my_it;
+	size_t run_len = 0;
+	while ( ( run_end != actions.end() ) && ( run_end->type == UserByteType ) ) {
+	  run_end++;
+	  run_len++;
+	}
+
+	string *keys;
 	/* can we combine this with a previous Keystroke? */
 	if ( (output.instruction_size() > 0)
 	     && (output.instruction( output.instruction_size() - 1 ).HasExtension( keystroke )) ) {
-	  output.mutable_instruction( output.instruction_size() - 1 )->MutableExtension( keystroke )->mutable_keys()->append( string( &the_byte, 1 ) );
+	  keys = output.mutable_instruction( output.instruction_size() - 1 )->MutableExtension( keystroke )->mutable_keys();
 	} else {
-	  Instruction *new_inst = output.add_instruction();
-	  new_inst->MutableExtension( keystroke )->set_keys( &the_byte, 1 );
+	  keys = output.add_instruction()->MutableExtension( keystroke )->mutable_keys();
+	}
+	keys->reserve( keys->size() + run_len );
+	for ( ; my_it != run_end; my_it++ ) {
+	  keys->push_back( my_it->userbyte.c );
 	}
       }
-      break;
+      continue; /* my_it is already past the run */
     case ResizeType:
       {
+	/* only the last of a run of resizes matters to the server */
+	while ( ( my_it + 1 != actions.end() ) && ( ( my_it + 1 )->type == ResizeType ) ) {
+	  my_it++;
+	}
 	Instruction *new_inst = output.add_instruction();
 	new_inst->MutableExtension( resize )->set_width( my_it->resize.width );
 	new_inst->MutableExtension( resize )->set_height( my_it->resize.height );
       }
       break;
+    case CapabilityType:
+      {
+	Instruction *new_inst = output.add_instruction();
+	new_inst->MutableExtension( capability )->set_flags( my_it->capability );
+      }
+      break;
+    case PasteType:
+      {
+	Instruction *new_inst = output.add_instruction();
+	new_inst->MutableExtension( bulkpaste )->set_payload( my_it->paste );
+      }
+      break;
     default:
       assert( !"unexpected event type" );
       break;
@@ -119,20 +148,27 @@ void UserStream::apply_string( const string &diff )
     } else if ( input.instruction( i ).HasExtension( resize ) ) {
       actions.push_back( UserEvent( Resize( input.instruction( i ).GetExtension( resize ).width(),
 					    input.instruction( i ).GetExtension( resize ).height() ) ) );
+    } else if ( input.instruction( i ).HasExtension( capability ) ) {
+      actions.push_back( UserEvent( input.instruction( i ).GetExtension( capability ).flags() ) );
+    } else if ( input.instruction( i ).HasExtension( bulkpaste ) ) {
+      actions.push_back( UserEvent( input.instruction( i ).GetExtension( bulkpaste ).payload() ) );
     }
   }
 }
 
 const Parser::Action &UserStream::get_action( unsigned int i ) const
 {
+  static const Parser::Ignore nothing = Parser::Ignore();
   switch( actions[ i ].type ) {
   case UserByteType:
     return actions[ i ].userbyte;
   case ResizeType:
     return actions[ i ].resize;
+  case CapabilityType: /* negotiation event; nothing for the terminal to do */
+  case PasteType: /* handled in bulk, not as a Parser::Action */
+    return nothing;
   default:
     assert( !"unexpected action type" );
-    static const Parser::Ignore nothing = Parser::Ignore();
     return nothing;
   }
 }
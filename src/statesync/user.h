@@ -37,6 +37,7 @@
 #include <list>
 #include <string>
 #include <assert.h>
+#include <stdint.h>
 
 #include "parseraction.h"
 
@@ -47,7 +48,9 @@ namespace Network {
 
   enum UserEventType {
     UserByteType = 0,
-    ResizeType = 1
+    ResizeType = 1,
+    CapabilityType = 2,
+    PasteType = 3
   };
 
   class UserEvent
@@ -56,15 +59,19 @@ namespace Network {
     UserEventType type;
     Parser::UserByte userbyte;
     Parser::Resize resize;
+    uint32_t capability; /* protocol-feature bitmask advertised to server */
+    string paste; /* bulk pasted data, bypassing per-byte handling */
 
-    UserEvent( const Parser::UserByte & s_userbyte ) : type( UserByteType ), userbyte( s_userbyte ), resize( -1, -1 ) {}
-    UserEvent( const Parser::Resize & s_resize ) : type( ResizeType ), userbyte( 0 ), resize( s_resize ) {}
+    UserEvent( const Parser::UserByte & s_userbyte ) : type( UserByteType ), userbyte( s_userbyte ), resize( -1, -1 ), capability( 0 ), paste() {}
+    UserEvent( const Parser::Resize & s_resize ) : type( ResizeType ), userbyte( 0 ), resize( s_resize ), capability( 0 ), paste() {}
+    explicit UserEvent( uint32_t s_capability ) : type( CapabilityType ), userbyte( 0 ), resize( -1, -1 ), capability( s_capability ), paste() {}
+    explicit UserEvent( const string & s_paste ) : type( PasteType ), userbyte( 0 ), resize( -1, -1 ), capability( 0 ), paste( s_paste ) {}
 
   private:
     UserEvent();
 
   public:
-    bool operator==( const UserEvent &x ) const { return ( type == x.type ) && ( userbyte == x.userbyte ) && ( resize == x.resize ); }
+    bool operator==( const UserEvent &x ) const { return ( type == x.type ) && ( userbyte == x.userbyte ) && ( resize == x.resize ) && ( capability == x.capability ) && ( paste == x.paste ); }
   };
 
   class UserStream
@@ -77,10 +84,15 @@ namespace Network {
     
     void push_back( const Parser::UserByte & s_userbyte ) { actions.push_back( UserEvent( s_userbyte ) ); }
     void push_back( const Parser::Resize & s_resize ) { actions.push_back( UserEvent( s_resize ) ); }
-    
+    void push_capability( uint32_t caps ) { actions.push_back( UserEvent( caps ) ); }
+    void push_paste( const string & s_paste ) { actions.push_back( UserEvent( s_paste ) ); }
+
     bool empty( void ) const { return actions.empty(); }
     size_t size( void ) const { return actions.size(); }
     const Parser::Action &get_action( unsigned int i ) const;
+    UserEventType get_event_type( unsigned int i ) const { return actions[ i ].type; }
+    uint32_t get_capability( unsigned int i ) const { assert( actions[ i ].type == CapabilityType ); return actions[ i ].capability; }
+    const string & get_paste( unsigned int i ) const { assert( actions[ i ].type == PasteType ); return actions[ i ].paste; }
     
     /* interface for Network::Transport */
     void subtract( const UserStream *prefix );
@@ -89,6 +101,10 @@ namespace Network {
     void apply_string( const string &diff );
     bool operator==( const UserStream &x ) const { return actions == x.actions; }
 
+    /* the input direction has no echo acks to preempt with */
+    bool echo_ack_newer_than( const UserStream & ) const { return false; }
+    UserStream echo_ack_state( const UserStream &existing ) const { return existing; }
+
     bool compare( const UserStream & ) { return false; }
   };
 }
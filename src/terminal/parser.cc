@@ -37,15 +37,14 @@
 #include <stdint.h>
 
 #include "parser.h"
+#include "locale_utils.h"
 
 const Parser::StateFamily Parser::family;
 
-static void append_or_delete( Parser::ActionPointer act,
-			      Parser::Actions &vec )
+static void append_if_real( const Parser::Action &act,
+			    Parser::Actions &vec )
 {
-  assert( act );
-
-  if ( !act->ignore() ) {
+  if ( !act.ignore() ) {
     vec.push_back( act );
   }
 }
@@ -55,19 +54,22 @@ void Parser::Parser::input( wchar_t ch, Actions &ret )
   Transition tx = state->input( ch );
 
   if ( tx.next_state != NULL ) {
-    append_or_delete( state->exit(), ret );
+    append_if_real( state->exit(), ret );
   }
 
-  append_or_delete( tx.action, ret );
+  append_if_real( tx.action, ret );
 
   if ( tx.next_state != NULL ) {
-    append_or_delete( tx.next_state->enter(), ret );
+    append_if_real( tx.next_state->enter(), ret );
     state = tx.next_state;
   }
 }
 
 Parser::UTF8Parser::UTF8Parser()
-  : parser(), buf_len( 0 )
+  : parser(), buf_len( 0 ),
+    utf8_locale( is_utf8_locale() ),
+    decoder_cp( 0 ), decoder_remaining( 0 ),
+    decoder_next_min( 0x80 ), decoder_next_max( 0xBF )
 {
   assert( BUF_SIZE >= (size_t)MB_CUR_MAX );
   buf[0] = '\0';
@@ -75,14 +77,75 @@ Parser::UTF8Parser::UTF8Parser()
 
 void Parser::UTF8Parser::input( char c, Actions &ret )
 {
-  assert( buf_len < BUF_SIZE );
-
   /* 1-byte UTF-8 character, aka ASCII?  Cheat. */
-  if ( buf_len == 0 && static_cast<unsigned char>(c) <= 0x7f ) {
+  if ( buf_len == 0 && decoder_remaining == 0
+       && static_cast<unsigned char>(c) <= 0x7f ) {
     parser.input( static_cast<wchar_t>(c), ret );
     return;
   }
 
+  if ( utf8_locale ) {
+    input_utf8( c, ret );
+  } else {
+    input_mbrtowc( c, ret );
+  }
+}
+
+/* Incremental UTF-8 decoder, skipping the locale-dispatching mbrtowc().
+   Ill-formed input is replaced with U+FFFD per Unicode 6.0, section 3.9,
+   "Best Practices for using U+FFFD": a maximal subpart of an ill-formed
+   sequence is replaced as a unit, and the offending octet is then
+   reconsidered as the start of a new sequence.  Surrogates, codepoints
+   beyond U+10FFFF, and overlong encodings are excluded by bounding the
+   first continuation octet per lead octet. */
+void Parser::UTF8Parser::input_utf8( char c, Actions &ret )
+{
+  const unsigned char uc = c;
+
+  if ( decoder_remaining == 0 ) {
+    /* lead octet (ASCII was handled by the cheat above) */
+    if ( (0xC2 <= uc) && (uc <= 0xDF) ) {
+      decoder_cp = uc & 0x1F;
+      decoder_remaining = 1;
+      decoder_next_min = 0x80;
+      decoder_next_max = 0xBF;
+    } else if ( (0xE0 <= uc) && (uc <= 0xEF) ) {
+      decoder_cp = uc & 0x0F;
+      decoder_remaining = 2;
+      decoder_next_min = (uc == 0xE0) ? 0xA0 : 0x80;
+      decoder_next_max = (uc == 0xED) ? 0x9F : 0xBF;
+    } else if ( (0xF0 <= uc) && (uc <= 0xF4) ) {
+      decoder_cp = uc & 0x07;
+      decoder_remaining = 3;
+      decoder_next_min = (uc == 0xF0) ? 0x90 : 0x80;
+      decoder_next_max = (uc == 0xF4) ? 0x8F : 0xBF;
+    } else {
+      /* bare continuation octet, or invalid lead (0xC0, 0xC1, 0xF5-0xFF) */
+      parser.input( (wchar_t) 0xFFFD, ret );
+    }
+    return;
+  }
+
+  if ( (decoder_next_min <= uc) && (uc <= decoder_next_max) ) {
+    decoder_cp = ( decoder_cp << 6 ) | ( uc & 0x3F );
+    decoder_next_min = 0x80;
+    decoder_next_max = 0xBF;
+    if ( --decoder_remaining == 0 ) {
+      parser.input( (wchar_t) decoder_cp, ret );
+    }
+    return;
+  }
+
+  /* ill-formed: replace the partial sequence and retry this octet */
+  decoder_remaining = 0;
+  parser.input( (wchar_t) 0xFFFD, ret );
+  input( c, ret );
+}
+
+void Parser::UTF8Parser::input_mbrtowc( char c, Actions &ret )
+{
+  assert( buf_len < BUF_SIZE );
+
   buf[ buf_len++ ] = c;
 
   /* This function will only work in a UTF-8 locale. */
@@ -60,6 +60,12 @@ namespace Parser {
 
     void input( wchar_t ch, Actions &actions );
 
+    /* true when the next character would be handled by the ground state */
+    bool is_ground( void ) const
+    {
+      return state == &family.s_Ground;
+    }
+
     void reset_input( void )
     {
       state = &family.s_Ground;
@@ -76,16 +82,33 @@ namespace Parser {
     char buf[ BUF_SIZE ];
     size_t buf_len;
 
+    /* Streaming decoder state, used instead of mbrtowc() when the
+       locale's charset is known to be UTF-8 at construction. */
+    bool utf8_locale;
+    uint32_t decoder_cp;                /* accumulated codepoint */
+    unsigned int decoder_remaining;     /* continuation octets still expected */
+    unsigned char decoder_next_min, decoder_next_max; /* bounds on next octet */
+
+    void input_utf8( char c, Actions &actions );
+    void input_mbrtowc( char c, Actions &actions );
+
   public:
     UTF8Parser();
 
     void input( char c, Actions &actions );
 
+    /* true when no multibyte sequence is pending and the FSM is in ground */
+    bool is_ground( void ) const
+    {
+      return ( buf_len == 0 ) && ( decoder_remaining == 0 ) && parser.is_ground();
+    }
+
     void reset_input( void )
     {
       parser.reset_input();
       buf[0] = '\0';
       buf_len = 0;
+      decoder_remaining = 0;
     }
   };
 }
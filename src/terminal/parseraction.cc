@@ -38,63 +38,72 @@
 
 using namespace Parser;
 
-void Print::act_on_terminal( Terminal::Emulator *emu ) const
+void Action::act_on_terminal( Terminal::Emulator *emu ) const
 {
-  emu->print( this );
+  switch ( type ) {
+  case PRINT:
+    emu->print( this );
+    break;
+  case EXECUTE:
+    emu->execute( this );
+    break;
+  case CLEAR:
+    emu->dispatch.clear( this );
+    break;
+  case PARAM:
+    emu->dispatch.newparamchar( this );
+    break;
+  case COLLECT:
+    emu->dispatch.collect( this );
+    break;
+  case CSI_DISPATCH:
+    emu->CSI_dispatch( this );
+    break;
+  case ESC_DISPATCH:
+    emu->Esc_dispatch( this );
+    break;
+  case OSC_PUT:
+    emu->dispatch.OSC_put( this );
+    break;
+  case OSC_START:
+    emu->dispatch.OSC_start( this );
+    break;
+  case OSC_END:
+    emu->OSC_end( this );
+    break;
+  case USER_BYTE:
+    emu->dispatch.terminal_to_host.append( emu->user.input( this,
+							    emu->fb.ds.application_mode_cursor_keys ) );
+    break;
+  case RESIZE:
+    emu->resize( width, height );
+    break;
+  case IGNORE: case HOOK: case PUT: case UNHOOK:
+  default:
+    /* no effect on the terminal */
+    break;
+  }
 }
 
-void Execute::act_on_terminal( Terminal::Emulator *emu ) const
+std::string Action::name( void ) const
 {
-  emu->execute( this );
-}
-
-void Clear::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->dispatch.clear( this );
-}
-
-void Param::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->dispatch.newparamchar( this );
-}
-
-void Collect::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->dispatch.collect( this );
-}
-
-void CSI_Dispatch::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->CSI_dispatch( this );
-}
-
-void Esc_Dispatch::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->Esc_dispatch( this );
-}
-
-void OSC_Put::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->dispatch.OSC_put( this );
-}
-
-void OSC_Start::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->dispatch.OSC_start( this );
-}
-
-void OSC_End::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->OSC_end( this );
-}
-
-void UserByte::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->dispatch.terminal_to_host.append( emu->user.input( this,
-							  emu->fb.ds.application_mode_cursor_keys ) );
-}
-
-void Resize::act_on_terminal( Terminal::Emulator *emu ) const
-{
-  emu->resize( width, height );
+  switch ( type ) {
+  case IGNORE:       return std::string( "Ignore" );
+  case PRINT:        return std::string( "Print" );
+  case EXECUTE:      return std::string( "Execute" );
+  case CLEAR:        return std::string( "Clear" );
+  case COLLECT:      return std::string( "Collect" );
+  case PARAM:        return std::string( "Param" );
+  case ESC_DISPATCH: return std::string( "Esc_Dispatch" );
+  case CSI_DISPATCH: return std::string( "CSI_Dispatch" );
+  case HOOK:         return std::string( "Hook" );
+  case PUT:          return std::string( "Put" );
+  case UNHOOK:       return std::string( "Unhook" );
+  case OSC_START:    return std::string( "OSC_Start" );
+  case OSC_PUT:      return std::string( "OSC_Put" );
+  case OSC_END:      return std::string( "OSC_End" );
+  case USER_BYTE:    return std::string( "UserByte" );
+  case RESIZE:       return std::string( "Resize" );
+  default:           return std::string( "unknown" );
+  }
 }
@@ -36,106 +36,110 @@
 #include <string>
 #include <vector>
 
-#include "shared.h"
-
 namespace Terminal {
   class Emulator;
 }
 
 namespace Parser {
+  // An Action is a plain value: a type tag plus the union of every
+  // action's data.  Actions used to be a virtual class hierarchy held
+  // by shared_ptr, which meant at least one heap allocation and
+  // refcount round-trip per parsed octet; storing them by value lets
+  // the parse loop run allocation-free (the Actions vector reuses its
+  // capacity across calls).
   class Action
   {
   public:
+    enum Type {
+      IGNORE, PRINT, EXECUTE, CLEAR, COLLECT, PARAM,
+      ESC_DISPATCH, CSI_DISPATCH, HOOK, PUT, UNHOOK,
+      OSC_START, OSC_PUT, OSC_END, USER_BYTE, RESIZE
+    };
+
+    Type type;
     wchar_t ch;
     bool char_present;
+    char c; /* UserByte: the user-source byte.  We don't try to interpret the charset */
+    size_t width, height; /* Resize */
 
-    virtual std::string name( void ) = 0;
+    std::string name( void ) const;
 
-    virtual void act_on_terminal( Terminal::Emulator * ) const {};
+    void act_on_terminal( Terminal::Emulator * ) const;
 
-    virtual bool ignore() const { return false; }
+    bool ignore( void ) const { return type == IGNORE; }
 
-    Action() : ch( -1 ), char_present( false ) {};
-    virtual ~Action() {};
+    Action( Type s_type = IGNORE )
+      : type( s_type ), ch( -1 ), char_present( false ),
+	c( 0 ), width( 0 ), height( 0 )
+    {}
   };
 
-  typedef shared::shared_ptr<Action> ActionPointer;
-  typedef std::vector<ActionPointer> Actions;
+  typedef std::vector<Action> Actions;
 
+  // The classes below add no data members; they are convenience
+  // constructors, and existing code can keep saying
+  // Parser::UserByte( c ) etc.  They slice down to Action harmlessly.
   class Ignore : public Action {
   public:
-    std::string name( void ) { return std::string( "Ignore" ); }
-    bool ignore() const { return true; }
+    Ignore() : Action( IGNORE ) {}
   };
   class Print : public Action {
   public:
-    std::string name( void ) { return std::string( "Print" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    Print() : Action( PRINT ) {}
   };
   class Execute : public Action {
   public:
-    std::string name( void ) { return std::string( "Execute" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    Execute() : Action( EXECUTE ) {}
   };
   class Clear : public Action {
   public:
-    std::string name( void ) { return std::string( "Clear" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    Clear() : Action( CLEAR ) {}
   };
   class Collect : public Action {
   public:
-    std::string name( void ) { return std::string( "Collect" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    Collect() : Action( COLLECT ) {}
   };
   class Param : public Action {
   public:
-    std::string name( void ) { return std::string( "Param" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    Param() : Action( PARAM ) {}
   };
   class Esc_Dispatch : public Action {
   public:
-    std::string name( void ) { return std::string( "Esc_Dispatch" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    Esc_Dispatch() : Action( ESC_DISPATCH ) {}
   };
   class CSI_Dispatch : public Action {
   public:
-    std::string name( void ) { return std::string( "CSI_Dispatch" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    CSI_Dispatch() : Action( CSI_DISPATCH ) {}
   };
   class Hook : public Action {
-  public: std::string name( void ) { return std::string( "Hook" ); }
+  public:
+    Hook() : Action( HOOK ) {}
   };
   class Put : public Action {
-  public: std::string name( void ) { return std::string( "Put" ); }
+  public:
+    Put() : Action( PUT ) {}
   };
   class Unhook : public Action {
-  public: std::string name( void ) { return std::string( "Unhook" ); }
+  public:
+    Unhook() : Action( UNHOOK ) {}
   };
   class OSC_Start : public Action {
   public:
-    std::string name( void ) { return std::string( "OSC_Start" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    OSC_Start() : Action( OSC_START ) {}
   };
   class OSC_Put : public Action {
   public:
-    std::string name( void ) { return std::string( "OSC_Put" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    OSC_Put() : Action( OSC_PUT ) {}
   };
   class OSC_End : public Action {
   public:
-    std::string name( void ) { return std::string( "OSC_End" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
+    OSC_End() : Action( OSC_END ) {}
   };
 
   class UserByte : public Action {
     /* user keystroke -- not part of the host-source state machine*/
   public:
-    char c; /* The user-source byte. We don't try to interpret the charset */
-
-    std::string name( void ) { return std::string( "UserByte" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
-
-    UserByte( int s_c ) : c( s_c ) {}
+    UserByte( int s_c ) : Action( USER_BYTE ) { c = s_c; }
 
     bool operator==( const UserByte &other ) const
     {
@@ -146,15 +150,11 @@ namespace Parser {
   class Resize : public Action {
     /* resize event -- not part of the host-source state machine*/
   public:
-    size_t width, height;
-
-    std::string name( void ) { return std::string( "Resize" ); }
-    void act_on_terminal( Terminal::Emulator *emu ) const;
-
-    Resize( size_t s_width, size_t s_height )
-      : width( s_width ),
-	height( s_height )
-    {}
+    Resize( size_t s_width, size_t s_height ) : Action( RESIZE )
+    {
+      width = s_width;
+      height = s_height;
+    }
 
     bool operator==( const Resize &other ) const
     {
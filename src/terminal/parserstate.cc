@@ -42,7 +42,7 @@ Transition State::anywhere_rule( wchar_t ch ) const
        || ((0x80 <= ch) && (ch <= 0x8F))
        || ((0x91 <= ch) && (ch <= 0x97))
        || (ch == 0x99) || (ch == 0x9A) ) {
-    return Transition( shared::make_shared<Execute>(), &family->s_Ground );
+    return Transition( Execute(), &family->s_Ground );
   } else if ( ch == 0x9C ) {
     return Transition( &family->s_Ground );
   } else if ( ch == 0x1B ) {
@@ -57,24 +57,22 @@ Transition State::anywhere_rule( wchar_t ch ) const
     return Transition( &family->s_CSI_Entry );
   }
 
-  return Transition(( State * )NULL, ActionPointer() ); /* don't allocate an Ignore action */
+  return Transition(); /* Ignore, no transition */
 }
 
-Transition State::input( wchar_t ch ) const
+void State::compute_table( void )
 {
-  /* Check for immediate transitions. */
-  Transition anywhere = anywhere_rule( ch );
-  if ( anywhere.next_state ) {
-    anywhere.action->char_present = true;
-    anywhere.action->ch = ch;
-    return anywhere;
-  }
-  /* Normal X.364 state machine. */
-  /* Parse high Unicode codepoints like 'A'. */
-  Transition ret = this->input_state_rule( ch >= 0xA0 ? 0x41 : ch );
-  ret.action->char_present = true;
-  ret.action->ch = ch;
-  return ret;
+  for ( int i = 0; i < 256; i++ ) {
+    /* Check for immediate transitions. */
+    Transition tx = anywhere_rule( i );
+    if ( !tx.next_state ) {
+      /* Normal X.364 state machine. */
+      /* Parse high Unicode codepoints like 'A'. */
+      tx = this->input_state_rule( i >= 0xA0 ? 0x41 : i );
+    }
+    table[ i ].action_type = tx.action.type;
+    table[ i ].next_state = tx.next_state;
+  }
 }
 
 static bool C0_prime( wchar_t ch )
@@ -93,29 +91,29 @@ static bool GLGR ( wchar_t ch )
 Transition Ground::input_state_rule( wchar_t ch ) const
 {
   if ( C0_prime( ch ) ) {
-    return Transition( shared::make_shared< Execute >() );
+    return Transition( Execute() );
   }
 
   if ( GLGR( ch ) ) {
-    return Transition( shared::make_shared< Print >() );
+    return Transition( Print() );
   }
 
   return Transition();
 }
 
-ActionPointer Escape::enter( void ) const
+Action Escape::enter( void ) const
 {
-  return shared::make_shared< Clear >();
+  return Clear();
 }
 
 Transition Escape::input_state_rule( wchar_t ch ) const
 {
   if ( C0_prime( ch ) ) {
-    return Transition( shared::make_shared< Execute >() );
+    return Transition( Execute() );
   }
 
   if ( (0x20 <= ch) && (ch <= 0x2F) ) {
-    return Transition( shared::make_shared< Collect >(), &family->s_Escape_Intermediate );
+    return Transition( Collect(), &family->s_Escape_Intermediate );
   }
 
   if ( ( (0x30 <= ch) && (ch <= 0x4F) )
@@ -124,7 +122,7 @@ Transition Escape::input_state_rule( wchar_t ch ) const
        || ( ch == 0x5A )
        || ( ch == 0x5C )
        || ( (0x60 <= ch) && (ch <= 0x7E) ) ) {
-    return Transition( shared::make_shared< Esc_Dispatch >(), &family->s_Ground );
+    return Transition( Esc_Dispatch(), &family->s_Ground );
   }
 
   if ( ch == 0x5B ) {
@@ -149,42 +147,42 @@ Transition Escape::input_state_rule( wchar_t ch ) const
 Transition Escape_Intermediate::input_state_rule( wchar_t ch ) const
 {
   if ( C0_prime( ch ) ) {
-    return Transition( shared::make_shared< Execute >() );
+    return Transition( Execute() );
   }
 
   if ( (0x20 <= ch) && (ch <= 0x2F) ) {
-    return Transition( shared::make_shared< Collect >() );
+    return Transition( Collect() );
   }
 
   if ( (0x30 <= ch) && (ch <= 0x7E) ) {
-    return Transition( shared::make_shared< Esc_Dispatch >(), &family->s_Ground );
+    return Transition( Esc_Dispatch(), &family->s_Ground );
   }
 
   return Transition();
 }
 
-ActionPointer CSI_Entry::enter( void ) const
+Action CSI_Entry::enter( void ) const
 {
-  return shared::make_shared< Clear >();
+  return Clear();
 }
 
 Transition CSI_Entry::input_state_rule( wchar_t ch ) const
 {
   if ( C0_prime( ch ) ) {
-    return Transition( shared::make_shared< Execute >() );
+    return Transition( Execute() );
   }
 
   if ( (0x40 <= ch) && (ch <= 0x7E) ) {
-    return Transition( shared::make_shared< CSI_Dispatch >(), &family->s_Ground );
+    return Transition( CSI_Dispatch(), &family->s_Ground );
   }
 
   if ( ( (0x30 <= ch) && (ch <= 0x39) )
        || ( ch == 0x3B ) ) {
-    return Transition( shared::make_shared< Param >(), &family->s_CSI_Param );
+    return Transition( Param(), &family->s_CSI_Param );
   }
 
   if ( (0x3C <= ch) && (ch <= 0x3F) ) {
-    return Transition( shared::make_shared< Collect >(), &family->s_CSI_Param );
+    return Transition( Collect(), &family->s_CSI_Param );
   }
 
   if ( ch == 0x3A ) {
@@ -192,7 +190,7 @@ Transition CSI_Entry::input_state_rule( wchar_t ch ) const
   }
 
   if ( (0x20 <= ch) && (ch <= 0x2F) ) {
-    return Transition( shared::make_shared< Collect >(), &family->s_CSI_Intermediate );
+    return Transition( Collect(), &family->s_CSI_Intermediate );
   }
 
   return Transition();
@@ -201,11 +199,11 @@ Transition CSI_Entry::input_state_rule( wchar_t ch ) const
 Transition CSI_Param::input_state_rule( wchar_t ch ) const
 {
   if ( C0_prime( ch ) ) {
-    return Transition( shared::make_shared< Execute >() );
+    return Transition( Execute() );
   }
 
   if ( ( (0x30 <= ch) && (ch <= 0x39) ) || ( ch == 0x3B ) ) {
-    return Transition( shared::make_shared< Param >() );
+    return Transition( Param() );
   }
 
   if ( ( ch == 0x3A ) || ( (0x3C <= ch) && (ch <= 0x3F) ) ) {
@@ -213,11 +211,11 @@ Transition CSI_Param::input_state_rule( wchar_t ch ) const
   }
 
   if ( (0x20 <= ch) && (ch <= 0x2F) ) {
-    return Transition( shared::make_shared< Collect >(), &family->s_CSI_Intermediate );
+    return Transition( Collect(), &family->s_CSI_Intermediate );
   }
 
   if ( (0x40 <= ch) && (ch <= 0x7E) ) {
-    return Transition( shared::make_shared< CSI_Dispatch >(), &family->s_Ground );
+    return Transition( CSI_Dispatch(), &family->s_Ground );
   }
 
   return Transition();
@@ -226,15 +224,15 @@ Transition CSI_Param::input_state_rule( wchar_t ch ) const
 Transition CSI_Intermediate::input_state_rule( wchar_t ch ) const
 {
   if ( C0_prime( ch ) ) {
-    return Transition( shared::make_shared< Execute >() );
+    return Transition( Execute() );
   }
 
   if ( (0x20 <= ch) && (ch <= 0x2F) ) {
-    return Transition( shared::make_shared< Collect >() );
+    return Transition( Collect() );
   }
 
   if ( (0x40 <= ch) && (ch <= 0x7E) ) {
-    return Transition( shared::make_shared< CSI_Dispatch >(), &family->s_Ground );
+    return Transition( CSI_Dispatch(), &family->s_Ground );
   }
 
   if ( (0x30 <= ch) && (ch <= 0x3F) ) {
@@ -247,7 +245,7 @@ Transition CSI_Intermediate::input_state_rule( wchar_t ch ) const
 Transition CSI_Ignore::input_state_rule( wchar_t ch ) const
 {
   if ( C0_prime( ch ) ) {
-    return Transition( shared::make_shared< Execute >() );
+    return Transition( Execute() );
   }
 
   if ( (0x40 <= ch) && (ch <= 0x7E) ) {
@@ -257,15 +255,15 @@ Transition CSI_Ignore::input_state_rule( wchar_t ch ) const
   return Transition();
 }
 
-ActionPointer DCS_Entry::enter( void ) const
+Action DCS_Entry::enter( void ) const
 {
-  return shared::make_shared< Clear >();
+  return Clear();
 }
 
 Transition DCS_Entry::input_state_rule( wchar_t ch ) const
 {
   if ( (0x20 <= ch) && (ch <= 0x2F) ) {
-    return Transition( shared::make_shared< Collect >(), &family->s_DCS_Intermediate );
+    return Transition( Collect(), &family->s_DCS_Intermediate );
   }
 
   if ( ch == 0x3A ) {
@@ -273,11 +271,11 @@ Transition DCS_Entry::input_state_rule( wchar_t ch ) const
   }
 
   if ( ( (0x30 <= ch) && (ch <= 0x39) ) || ( ch == 0x3B ) ) {
-    return Transition( shared::make_shared< Param >(), &family->s_DCS_Param );
+    return Transition( Param(), &family->s_DCS_Param );
   }
 
   if ( (0x3C <= ch) && (ch <= 0x3F) ) {
-    return Transition( shared::make_shared< Collect >(), &family->s_DCS_Param );
+    return Transition( Collect(), &family->s_DCS_Param );
   }
 
   if ( (0x40 <= ch) && (ch <= 0x7E) ) {
@@ -290,7 +288,7 @@ Transition DCS_Entry::input_state_rule( wchar_t ch ) const
 Transition DCS_Param::input_state_rule( wchar_t ch ) const
 {
   if ( ( (0x30 <= ch) && (ch <= 0x39) ) || ( ch == 0x3B ) ) {
-    return Transition( shared::make_shared< Param >() );
+    return Transition( Param() );
   }
 
   if ( ( ch == 0x3A ) || ( (0x3C <= ch) && (ch <= 0x3F) ) ) {
@@ -298,7 +296,7 @@ Transition DCS_Param::input_state_rule( wchar_t ch ) const
   }
 
   if ( (0x20 <= ch) && (ch <= 0x2F) ) {
-    return Transition( shared::make_shared< Collect >(), &family->s_DCS_Intermediate );
+    return Transition( Collect(), &family->s_DCS_Intermediate );
   }
 
   if ( (0x40 <= ch) && (ch <= 0x7E) ) {
@@ -311,7 +309,7 @@ Transition DCS_Param::input_state_rule( wchar_t ch ) const
 Transition DCS_Intermediate::input_state_rule( wchar_t ch ) const
 {
   if ( (0x20 <= ch) && (ch <= 0x2F) ) {
-    return Transition( shared::make_shared< Collect >() );
+    return Transition( Collect() );
   }
 
   if ( (0x40 <= ch) && (ch <= 0x7E) ) {
@@ -325,20 +323,20 @@ Transition DCS_Intermediate::input_state_rule( wchar_t ch ) const
   return Transition();
 }
 
-ActionPointer DCS_Passthrough::enter( void ) const
+Action DCS_Passthrough::enter( void ) const
 {
-  return shared::make_shared< Hook >();
+  return Hook();
 }
 
-ActionPointer DCS_Passthrough::exit( void ) const
+Action DCS_Passthrough::exit( void ) const
 {
-  return shared::make_shared< Unhook >();
+  return Unhook();
 }
 
 Transition DCS_Passthrough::input_state_rule( wchar_t ch ) const
 {
   if ( C0_prime( ch ) || ( (0x20 <= ch) && (ch <= 0x7E) ) ) {
-    return Transition( shared::make_shared< Put >() );
+    return Transition( Put() );
   }
 
   if ( ch == 0x9C ) {
@@ -357,20 +355,20 @@ Transition DCS_Ignore::input_state_rule( wchar_t ch ) const
   return Transition();
 }
 
-ActionPointer OSC_String::enter( void ) const
+Action OSC_String::enter( void ) const
 {
-  return shared::make_shared< OSC_Start >();
+  return OSC_Start();
 }
 
-ActionPointer OSC_String::exit( void ) const
+Action OSC_String::exit( void ) const
 {
-  return shared::make_shared< OSC_End >();
+  return OSC_End();
 }
 
 Transition OSC_String::input_state_rule( wchar_t ch ) const
 {
   if ( (0x20 <= ch) && (ch <= 0x7F) ) {
-    return Transition( shared::make_shared< OSC_Put >() );
+    return Transition( OSC_Put() );
   }
 
   if ( (ch == 0x9C) || (ch == 0x07) ) { /* 0x07 is xterm non-ANSI variant */
@@ -47,13 +47,39 @@ namespace Parser {
   private:
     Transition anywhere_rule( wchar_t ch ) const;
 
+    // Dense transition table, generated once per state when the
+    // StateFamily is constructed.  It merges the anywhere rule with
+    // this state's own rule, so the per-character cost of input() is
+    // one indexed load instead of a virtual call and range checks.
+    struct TableEntry {
+      Action::Type action_type;
+      State *next_state;
+    };
+    TableEntry table[ 256 ];
+
   public:
     void setfamily( StateFamily *s_family ) { family = s_family; }
-    Transition input( wchar_t ch ) const;
-    virtual ActionPointer enter( void ) const { return shared::make_shared< Ignore >(); }
-    virtual ActionPointer exit( void ) const { return shared::make_shared< Ignore >(); }
-
-    State() : family( NULL ) {};
+    void compute_table( void );
+    Transition input( wchar_t ch ) const
+    {
+      /* The table covers 0x00..0xFF; higher codepoints behave like 'A',
+	 matching the old rule for parsing high Unicode codepoints. */
+      const TableEntry &entry = table[ ch < 0xA0 ? ch : 0x41 ];
+      Transition ret( Action( entry.action_type ), entry.next_state );
+      ret.action.char_present = true;
+      ret.action.ch = ch;
+      return ret;
+    }
+    virtual Action enter( void ) const { return Action(); }
+    virtual Action exit( void ) const { return Action(); }
+
+    State() : family( NULL )
+    {
+      for ( int i = 0; i < 256; i++ ) {
+	table[ i ].action_type = Action::IGNORE;
+	table[ i ].next_state = NULL;
+      }
+    };
     virtual ~State() {};
 
     State( const State & );
@@ -65,7 +91,7 @@ namespace Parser {
   };
 
   class Escape : public State {
-    ActionPointer enter( void ) const;
+    Action enter( void ) const;
     Transition input_state_rule( wchar_t ch ) const;
   };
 
@@ -74,7 +100,7 @@ namespace Parser {
   };
 
   class CSI_Entry : public State {
-    ActionPointer enter( void ) const;
+    Action enter( void ) const;
     Transition input_state_rule( wchar_t ch ) const;
   };
   class CSI_Param : public State {
@@ -88,7 +114,7 @@ namespace Parser {
   };
   
   class DCS_Entry : public State {
-    ActionPointer enter( void ) const;
+    Action enter( void ) const;
     Transition input_state_rule( wchar_t ch ) const;
   };
   class DCS_Param : public State {
@@ -98,18 +124,18 @@ namespace Parser {
     Transition input_state_rule( wchar_t ch ) const;
   };
   class DCS_Passthrough : public State {
-    ActionPointer enter( void ) const;
+    Action enter( void ) const;
     Transition input_state_rule( wchar_t ch ) const;
-    ActionPointer exit( void ) const;
+    Action exit( void ) const;
   };
   class DCS_Ignore : public State {
     Transition input_state_rule( wchar_t ch ) const;
   };
 
   class OSC_String : public State {
-    ActionPointer enter( void ) const;
+    Action enter( void ) const;
     Transition input_state_rule( wchar_t ch ) const;
-    ActionPointer exit( void ) const;
+    Action exit( void ) const;
   };
   class SOS_PM_APC_String : public State {
     Transition input_state_rule( wchar_t ch ) const;
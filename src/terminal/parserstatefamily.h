@@ -79,6 +79,24 @@ namespace Parser {
       s_DCS_Ignore.setfamily( this );
       s_OSC_String.setfamily( this );
       s_SOS_PM_APC_String.setfamily( this );
+
+      /* Generate the flat transition tables, now that every state can
+	 see the family.  After this, the rule methods are never
+	 consulted on the per-character path. */
+      s_Ground.compute_table();
+      s_Escape.compute_table();
+      s_Escape_Intermediate.compute_table();
+      s_CSI_Entry.compute_table();
+      s_CSI_Param.compute_table();
+      s_CSI_Intermediate.compute_table();
+      s_CSI_Ignore.compute_table();
+      s_DCS_Entry.compute_table();
+      s_DCS_Param.compute_table();
+      s_DCS_Intermediate.compute_table();
+      s_DCS_Passthrough.compute_table();
+      s_DCS_Ignore.compute_table();
+      s_OSC_String.compute_table();
+      s_SOS_PM_APC_String.compute_table();
     }
   };
 }
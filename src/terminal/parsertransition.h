@@ -43,30 +43,17 @@ namespace Parser {
   class Transition
   {
   public:
-    // Transition is only a courier for an Action; it should
-    // never create/delete one on its own.
-    ActionPointer action;
+    // Transition carries its Action by value; the default is an
+    // Ignore, which costs nothing to construct.
+    Action action;
     State *next_state;
 
-    Transition( const Transition &x )
-      : action( x.action ),
-	next_state( x.next_state ) {}
-    Transition & operator=( const Transition &t )
-    {
-      action = t.action;
-      next_state = t.next_state;
-
-      return *this;
-    }
-    Transition( ActionPointer s_action=shared::make_shared< Ignore >(), State *s_next_state=NULL )
+    Transition( const Action &s_action = Action(), State *s_next_state = NULL )
       : action( s_action ), next_state( s_next_state )
     {}
 
-    // This is only ever used in the 1-argument form;
-    // we use this instead of an initializer to
-    // tell Coverity the object never owns *action.
-    Transition( State *s_next_state, ActionPointer s_action=shared::make_shared< Ignore >() )
-      : action( s_action ), next_state( s_next_state )
+    Transition( State *s_next_state )
+      : action(), next_state( s_next_state )
     {}
   };
 }
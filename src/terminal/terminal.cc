@@ -37,6 +37,7 @@
 #include <typeinfo>
 
 #include "terminal.h"
+#include "charwidth.h"
 
 using namespace Terminal;
 
@@ -51,22 +52,30 @@ std::string Emulator::read_octets_to_host( void )
   return ret;
 }
 
-void Emulator::execute( const Parser::Execute *act )
+void Emulator::paste( const std::string &s )
+{
+  dispatch.terminal_to_host.append( user.input_string( s, fb.ds.application_mode_cursor_keys ) );
+}
+
+void Emulator::execute( const Parser::Action *act )
 {
   dispatch.dispatch( CONTROL, act, &fb );
 }
 
-void Emulator::print( const Parser::Print *act )
+void Emulator::print( const Parser::Action *act )
 {
   assert( act->char_present );
 
-  const wchar_t ch = act->ch;
+  print( act->ch );
+}
 
+void Emulator::print( wchar_t ch )
+{
   /*
    * Check for printing ISO 8859-1 first, it's a cheap way to detect
    * some common narrow characters.
    */
-  const int chwidth = ch == L'\0' ? -1 : ( Cell::isprint_iso8859_1( ch ) ? 1 : wcwidth( ch ));
+  const int chwidth = ch == L'\0' ? -1 : ( Cell::isprint_iso8859_1( ch ) ? 1 : ::chwidth( ch ));
 
   Cell *this_cell = fb.get_mutable_cell();
 
@@ -142,28 +151,87 @@ void Emulator::print( const Parser::Print *act )
   case -1: /* unprintable character */
     break;
   default:
-    assert( !"unexpected character width from wcwidth()" );
+    assert( !"unexpected character width from chwidth()" );
     break;
   }
 }
 
-void Emulator::CSI_dispatch( const Parser::CSI_Dispatch *act )
+void Emulator::print_run( const char *str, size_t len )
+{
+  while ( len ) {
+    if ( ( fb.ds.auto_wrap_mode && fb.ds.next_print_will_wrap )
+	 || fb.ds.insert_mode ) {
+      /* wraps and insert mode are rare; take the per-character path */
+      print( (wchar_t)(unsigned char)( *str ) );
+      str++;
+      len--;
+      continue;
+    }
+
+    /* write as many single-width cells as fit on the current row */
+    size_t remaining = fb.ds.get_width() - fb.ds.get_cursor_col();
+    const size_t chunk = ( len < remaining ) ? len : remaining;
+    const int col = fb.ds.get_cursor_col();
+
+    /* Full-screen applications repaint by rewriting every cell each
+       frame, and most cells receive exactly what they already hold.
+       Compare before writing: cells that would come out identical are
+       skipped, so an unchanged row is never dirtied -- it stays shared
+       with the states already sent, costing neither a copy-on-write
+       of the row nor any work in the next diff. */
+    const Row *cur_row = fb.get_row( fb.ds.get_cursor_row() );
+    Cell expected( 0 );
+    fb.reset_cell( &expected );
+    fb.apply_renditions_to_cell( &expected );
+    size_t first_changed = 0;
+    while ( first_changed < chunk ) {
+      expected.clear();
+      expected.append( (wchar_t)(unsigned char)( str[ first_changed ] ) );
+      if ( !( cur_row->cells[ col + first_changed ] == expected ) ) {
+	break;
+      }
+      first_changed++;
+    }
+
+    if ( first_changed < chunk ) {
+      Row *row = fb.get_mutable_row( fb.ds.get_cursor_row() );
+      for ( size_t i = first_changed; i < chunk; i++ ) {
+	Cell *cell = &row->cells[ col + i ];
+	fb.reset_cell( cell );
+	cell->append( (wchar_t)(unsigned char)( str[ i ] ) );
+	fb.apply_renditions_to_cell( cell );
+      }
+    }
+
+    /* advance in two steps so the combining-character position lands
+       on the last printed cell, as with per-character printing */
+    if ( chunk > 1 ) {
+      fb.ds.move_col( chunk - 1, true, true );
+    }
+    fb.ds.move_col( 1, true, true );
+
+    str += chunk;
+    len -= chunk;
+  }
+}
+
+void Emulator::CSI_dispatch( const Parser::Action *act )
 {
   dispatch.dispatch( CSI, act, &fb );
 }
 
-void Emulator::OSC_end( const Parser::OSC_End *act )
+void Emulator::OSC_end( const Parser::Action *act )
 {
   dispatch.OSC_dispatch( act, &fb );
 }
 
-void Emulator::Esc_dispatch( const Parser::Esc_Dispatch *act )
+void Emulator::Esc_dispatch( const Parser::Action *act )
 {
   /* handle 7-bit ESC-encoding of C1 control characters */
   if ( (dispatch.get_dispatch_chars().size() == 0)
        && (0x40 <= act->ch)
        && (act->ch <= 0x5F) ) {
-    Parser::Esc_Dispatch act2 = *act;
+    Parser::Action act2 = *act;
     act2.ch += 0x40;
     dispatch.dispatch( CONTROL, &act2, &fb );
   } else {
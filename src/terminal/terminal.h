@@ -46,19 +46,7 @@
 
 namespace Terminal {
   class Emulator {
-    friend void Parser::Print::act_on_terminal( Emulator * ) const;
-    friend void Parser::Execute::act_on_terminal( Emulator * ) const;
-    friend void Parser::Clear::act_on_terminal( Emulator * ) const;
-    friend void Parser::Param::act_on_terminal( Emulator * ) const;
-    friend void Parser::Collect::act_on_terminal( Emulator * ) const;
-    friend void Parser::CSI_Dispatch::act_on_terminal( Emulator * ) const;
-    friend void Parser::Esc_Dispatch::act_on_terminal( Emulator * ) const;
-    friend void Parser::OSC_Start::act_on_terminal( Emulator * ) const;
-    friend void Parser::OSC_Put::act_on_terminal( Emulator * ) const;
-    friend void Parser::OSC_End::act_on_terminal( Emulator * ) const;
-
-    friend void Parser::UserByte::act_on_terminal( Emulator * ) const;
-    friend void Parser::Resize::act_on_terminal( Emulator * ) const;
+    friend class Parser::Action;
 
   private:
     Framebuffer fb;
@@ -66,11 +54,12 @@ namespace Terminal {
     UserInput user;
 
     /* action methods */
-    void print( const Parser::Print *act );
-    void execute( const Parser::Execute *act );
-    void CSI_dispatch( const Parser::CSI_Dispatch *act );
-    void Esc_dispatch( const Parser::Esc_Dispatch *act );
-    void OSC_end( const Parser::OSC_End *act );
+    void print( const Parser::Action *act );
+    void print( wchar_t ch );
+    void execute( const Parser::Action *act );
+    void CSI_dispatch( const Parser::Action *act );
+    void Esc_dispatch( const Parser::Action *act );
+    void OSC_end( const Parser::Action *act );
     void resize( size_t s_width, size_t s_height );
 
   public:
@@ -78,7 +67,14 @@ namespace Terminal {
 
     std::string read_octets_to_host( void );
 
+    /* fast path: apply a run of printable ASCII without making Actions */
+    void print_run( const char *str, size_t len );
+
+    /* bulk path: forward pasted data to the host without making Actions */
+    void paste( const std::string &s );
+
     const Framebuffer & get_fb( void ) const { return fb; }
+    Framebuffer & get_fb( void ) { return fb; } /* for binary row-delta apply */
 
     bool operator==( Emulator const &x ) const;
   };
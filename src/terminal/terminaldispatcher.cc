@@ -49,7 +49,7 @@ Dispatcher::Dispatcher()
     OSC_string(), terminal_to_host()
 {}
 
-void Dispatcher::newparamchar( const Parser::Param *act )
+void Dispatcher::newparamchar( const Parser::Action *act )
 {
   assert( act->char_present );
   assert( (act->ch == ';') || ( (act->ch >= '0') && (act->ch <= '9') ) );
@@ -60,7 +60,7 @@ void Dispatcher::newparamchar( const Parser::Param *act )
   parsed = false;
 }
 
-void Dispatcher::collect( const Parser::Collect *act )
+void Dispatcher::collect( const Parser::Action *act )
 {
   assert( act->char_present );
   if ( ( dispatch_chars.length() < 8 ) /* never should need more than 2 */
@@ -69,7 +69,7 @@ void Dispatcher::collect( const Parser::Collect *act )
   }
 }
 
-void Dispatcher::clear( const Parser::Clear *act __attribute((unused)) )
+void Dispatcher::clear( const Parser::Action *act __attribute((unused)) )
 {
   params.clear();
   dispatch_chars.clear();
@@ -196,6 +196,29 @@ Function::Function( Function_Type type, const std::string & dispatch_chars,
   register_function( type, dispatch_chars, *this );
 }
 
+void DispatchRegistry::build_tables( void )
+{
+  for ( dispatch_map_t::const_iterator i = control.begin();
+	i != control.end();
+	i++ ) {
+    control_table[ static_cast<unsigned char>( i->first[ 0 ] ) ] = i->second;
+  }
+
+  for ( dispatch_map_t::const_iterator i = escape.begin();
+	i != escape.end();
+	i++ ) {
+    escape_buckets[ static_cast<unsigned char>( i->first[ i->first.size() - 1 ] ) & 0x7F ].push_back( *i );
+  }
+
+  for ( dispatch_map_t::const_iterator i = CSI.begin();
+	i != CSI.end();
+	i++ ) {
+    CSI_buckets[ static_cast<unsigned char>( i->first[ i->first.size() - 1 ] ) & 0x7F ].push_back( *i );
+  }
+
+  tables_built = true;
+}
+
 void Dispatcher::dispatch( Function_Type type, const Parser::Action *act, Framebuffer *fb )
 {
   /* add final char to dispatch key */
@@ -204,36 +227,48 @@ void Dispatcher::dispatch( Function_Type type, const Parser::Action *act, Frameb
     Parser::Collect act2;
     act2.char_present = true;
     act2.ch = act->ch;
-    collect( &act2 ); 
+    collect( &act2 );
   }
 
-  dispatch_map_t *map = NULL;
-  switch ( type ) {
-  case ESCAPE:  map = &get_global_dispatch_registry().escape;  break;
-  case CSI:     map = &get_global_dispatch_registry().CSI;     break;
-  case CONTROL: map = &get_global_dispatch_registry().control; break;
+  DispatchRegistry &registry = get_global_dispatch_registry();
+  if ( !registry.tables_built ) {
+    registry.build_tables();
   }
 
-  std::string key = dispatch_chars;
+  const Function *f = NULL;
   if ( type == CONTROL ) {
     assert( act->ch <= 255 );
-    char ctrlstr[ 2 ] = { (char)act->ch, 0 };
-    key = std::string( ctrlstr, 1 );
+    const Function &candidate = registry.control_table[ act->ch & 0xFF ];
+    if ( candidate.function != NULL ) {
+      f = &candidate;
+    }
+  } else if ( !dispatch_chars.empty() ) {
+    const unsigned char final_char = dispatch_chars[ dispatch_chars.size() - 1 ];
+    const dispatch_bucket_t &bucket
+      = ( type == CSI ? registry.CSI_buckets : registry.escape_buckets )
+        [ final_char & 0x7F ];
+    for ( dispatch_bucket_t::const_iterator i = bucket.begin();
+	  i != bucket.end();
+	  i++ ) {
+      if ( i->first == dispatch_chars ) {
+	f = &i->second;
+	break;
+      }
+    }
   }
 
-  dispatch_map_t::const_iterator i = map->find( key );
-  if ( i == map->end() ) {
+  if ( f == NULL ) {
     /* unknown function */
     fb->ds.next_print_will_wrap = false;
     return;
   }
-  if ( i->second.clears_wrap_state ) {
+  if ( f->clears_wrap_state ) {
     fb->ds.next_print_will_wrap = false;
   }
-  i->second.function( fb, this );
+  f->function( fb, this );
 }
 
-void Dispatcher::OSC_put( const Parser::OSC_Put *act )
+void Dispatcher::OSC_put( const Parser::Action *act )
 {
   assert( act->char_present );
   if ( OSC_string.size() < MAXIMUM_CLIPBOARD_SIZE) {
@@ -241,7 +276,7 @@ void Dispatcher::OSC_put( const Parser::OSC_Put *act )
   }
 }
 
-void Dispatcher::OSC_start( const Parser::OSC_Start *act __attribute((unused)) )
+void Dispatcher::OSC_start( const Parser::Action *act __attribute((unused)) )
 {
   OSC_string.clear();
 }
@@ -67,6 +67,7 @@ namespace Terminal {
   };
 
   typedef std::map<std::string, Function> dispatch_map_t;
+  typedef std::vector< std::pair<std::string, Function> > dispatch_bucket_t;
 
   class DispatchRegistry {
   public:
@@ -74,7 +75,22 @@ namespace Terminal {
     dispatch_map_t CSI;
     dispatch_map_t control;
 
-    DispatchRegistry() : escape(), CSI(), control() {}
+    // Flat lookup tables generated from the maps once every static
+    // Function has registered: control sequences index an array by
+    // byte, and escape/CSI sequences hash on their final character,
+    // with the (rare) intermediates resolved within the bucket.
+    // This keeps the per-sequence dispatch cost away from the
+    // red-black tree and avoids key-string construction.
+    bool tables_built;
+    Function control_table[ 256 ];
+    dispatch_bucket_t escape_buckets[ 128 ];
+    dispatch_bucket_t CSI_buckets[ 128 ];
+
+    void build_tables( void );
+
+    DispatchRegistry() : escape(), CSI(), control(),
+			 tables_built( false ), control_table(),
+			 escape_buckets(), CSI_buckets() {}
   };
 
   DispatchRegistry & get_global_dispatch_registry( void );
@@ -100,9 +116,9 @@ namespace Terminal {
     int getparam( size_t N, int defaultval );
     int param_count( void );
 
-    void newparamchar( const Parser::Param *act );
-    void collect( const Parser::Collect *act );
-    void clear( const Parser::Clear *act );
+    void newparamchar( const Parser::Action *act );
+    void collect( const Parser::Action *act );
+    void clear( const Parser::Action *act );
     
     std::string str( void );
 
@@ -110,9 +126,9 @@ namespace Terminal {
     std::string get_dispatch_chars( void ) const { return dispatch_chars; }
     std::vector<wchar_t> get_OSC_string( void ) const { return OSC_string; }
 
-    void OSC_put( const Parser::OSC_Put *act );
-    void OSC_start( const Parser::OSC_Start *act );
-    void OSC_dispatch( const Parser::OSC_End *act, Framebuffer *fb );
+    void OSC_put( const Parser::Action *act );
+    void OSC_start( const Parser::Action *act );
+    void OSC_dispatch( const Parser::Action *act, Framebuffer *fb );
 
     bool operator==( const Dispatcher &x ) const;
   };
@@ -30,8 +30,14 @@
     also delete it here.
 */
 
+#include "config.h"
+
 #include <stdio.h>
 
+#if HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
 #include "terminaldisplay.h"
 #include "terminalframebuffer.h"
 
@@ -39,6 +45,22 @@ using namespace Terminal;
 
 /* Print a new "frame" to the terminal, using ANSI/ECMA-48 escape codes. */
 
+#if HAVE_PTHREAD_H
+/* A row-loop diff over at least this many cells is worth sharding
+   across threads (an ordinary 80x24 screen is 1920). */
+static const int PARALLEL_CELL_THRESHOLD = 65536;
+static const int PARALLEL_SHARDS = 4;
+#endif
+
+/* The fingerprint lets us recognize moved content even when the rows
+   are different objects of different lineage; contents are confirmed
+   before acting on a hash match. */
+static bool rows_equal( const Row *a, const Row *b )
+{
+  return ( a == b )
+    || ( ( a->fingerprint() == b->fingerprint() ) && a->contents_equal( *b ) );
+}
+
 static const Renditions & initial_rendition( void )
 {
   const static Renditions blank = Renditions( 0 );
@@ -60,7 +82,7 @@ std::string Display::close() const
 
 std::string Display::new_frame( bool initialized, const Framebuffer &last, const Framebuffer &f ) const
 {
-  FrameState frame( last );
+  FrameState frame( last, prior_frame_bytes );
 
   char tmp[ 64 ];
 
@@ -162,6 +184,7 @@ std::string Display::new_frame( bool initialized, const Framebuffer &last, const
     for ( Framebuffer::rows_type::iterator p = rows.begin(); p != rows.end(); p++ ) {
       *p = make_shared<Row>( **p );
       (*p)->cells.resize( f.ds.get_width(), Cell( f.ds.get_background_rendition() ) );
+      (*p)->touch();
     }
   }
   /* Add rows if we've gotten a resize and new is taller than old */
@@ -181,7 +204,7 @@ std::string Display::new_frame( bool initialized, const Framebuffer &last, const
     for ( int row = 0; row < f.ds.get_height(); row++ ) {
       const Row *new_row = f.get_row( 0 );
       const Row *old_row = &*rows.at( row );
-      if ( ! ( new_row == old_row || *new_row == *old_row ) ) {
+      if ( !rows_equal( new_row, old_row ) ) {
 	continue;
       }
       /* if row 0, we're looking at ourselves and probably didn't scroll */
@@ -196,8 +219,9 @@ std::string Display::new_frame( bool initialized, const Framebuffer &last, const
       for ( int region_height = 1;
 	    lines_scrolled + region_height < f.ds.get_height();
 	    region_height++ ) {
-	if ( *f.get_row( region_height )
-	     == *rows.at( lines_scrolled + region_height ) ) {
+	const Row *new_region_row = f.get_row( region_height );
+	const Row *old_region_row = &*rows.at( lines_scrolled + region_height );
+	if ( rows_equal( new_region_row, old_region_row ) ) {
 	  scroll_height = region_height + 1;
 	} else {
 	  break;
@@ -234,9 +258,11 @@ std::string Display::new_frame( bool initialized, const Framebuffer &last, const
 	  frame.cursor_x = 0;
 	} else {
 	  /* set scrolling region */
-	  snprintf( tmp, 64, "\033[%d;%dr",
-		    top_margin + 1, bottom_margin + 1);
-	  frame.append( tmp );
+	  frame.append( "\033[" );
+	  frame.append_num( top_margin + 1 );
+	  frame.append( ';' );
+	  frame.append_num( bottom_margin + 1 );
+	  frame.append( 'r' );
 
 	  /* go to bottom of scrolling region */
 	  frame.cursor_x = frame.cursor_y = -1;
@@ -263,8 +289,128 @@ std::string Display::new_frame( bool initialized, const Framebuffer &last, const
     }
   }
 
+  /* Generalized region scrolls: a block of rows that moved vertically
+     anywhere on screen (e.g. a pane scrolling inside a terminal
+     multiplexer), in either direction.  Replaying the move with a
+     scrolling region costs a couple of dozen bytes, so it has to
+     displace at least a few full row rewrites to pay off. */
+  if ( initialized ) {
+    const int height = f.ds.get_height();
+    const int MIN_MOVED_ROWS = 4;
+    int y = frame_y;
+    while ( y < height ) {
+      if ( rows_equal( f.get_row( y ), &*rows.at( y ) ) ) {
+	y++;
+	continue;
+      }
+
+      /* A changed row: did its new contents move here from another
+	 line?  Prefer the smallest shift that explains enough rows. */
+      int shift = 0;
+      int run = 0;
+      for ( int mag = 1; ( mag < height ) && !shift; mag++ ) {
+	for ( int sign = 1; sign >= -1; sign -= 2 ) {
+	  const int d = mag * sign;
+	  if ( ( y + d < 0 ) || ( y + d >= height ) ) {
+	    continue;
+	  }
+	  if ( !rows_equal( f.get_row( y ), &*rows.at( y + d ) ) ) {
+	    continue;
+	  }
+	  /* extend the run of shifted matches, counting the rows a
+	     scroll would actually save */
+	  int len = 0, moved = 0;
+	  while ( ( y + len < height )
+		  && ( y + d + len >= 0 ) && ( y + d + len < height )
+		  && rows_equal( f.get_row( y + len ), &*rows.at( y + d + len ) ) ) {
+	    if ( !rows_equal( f.get_row( y + len ), &*rows.at( y + len ) ) ) {
+	      moved++;
+	    }
+	    len++;
+	  }
+	  if ( moved >= MIN_MOVED_ROWS ) {
+	    shift = d;
+	    run = len;
+	    break;
+	  }
+	}
+      }
+
+      if ( !shift ) {
+	y++;
+	continue;
+      }
+
+      /* a proper blank row for the lines the scroll exposes */
+      if ( blank_row.get() == NULL ) {
+	const size_t w = f.ds.get_width();
+	const color_type c = 0;
+	blank_row = make_shared<Row>( w, c );
+      }
+      frame.update_rendition( initial_rendition(), true );
+
+      if ( shift > 0 ) {
+	/* contents moved up: scroll the region forward */
+	const int top = y;
+	const int bottom = y + run - 1 + shift;
+
+	frame.append( "\033[" );
+	frame.append_num( top + 1 );
+	frame.append( ';' );
+	frame.append_num( bottom + 1 );
+	frame.append( 'r' );
+
+	frame.cursor_x = frame.cursor_y = -1;
+	frame.append_silent_move( bottom, 0 );
+	frame.append( shift, '\n' );
+
+	frame.append( "\033[r" );
+	frame.cursor_x = frame.cursor_y = -1;
+
+	for ( int i = top; i <= bottom; i++ ) {
+	  rows.at( i ) = ( i + shift <= bottom ) ? rows.at( i + shift ) : blank_row;
+	}
+      } else {
+	/* contents moved down: reverse-index at the top of the region */
+	const int k = -shift;
+	const int top = y - k;
+	const int bottom = y + run - 1;
+
+	frame.append( "\033[" );
+	frame.append_num( top + 1 );
+	frame.append( ';' );
+	frame.append_num( bottom + 1 );
+	frame.append( 'r' );
+
+	frame.cursor_x = frame.cursor_y = -1;
+	frame.append_silent_move( top, 0 );
+	for ( int i = 0; i < k; i++ ) {
+	  frame.append( "\033M" );
+	}
+
+	frame.append( "\033[r" );
+	frame.cursor_x = frame.cursor_y = -1;
+
+	for ( int i = bottom; i >= top; i-- ) {
+	  rows.at( i ) = ( i - k >= top ) ? rows.at( i - k ) : blank_row;
+	}
+      }
+
+      y += run;
+    }
+  }
+
   /* Now update the display, row by row */
   bool wrap = false;
+#if HAVE_PTHREAD_H
+  /* On very large framebuffers (think 4K fullscreen), the row loop is
+     multi-millisecond work; shard it across threads.  Ordinary 80x24
+     sessions stay on the single-threaded path below. */
+  if ( ( f.ds.get_height() - frame_y ) * f.ds.get_width() >= PARALLEL_CELL_THRESHOLD ) {
+    put_rows_parallel( initialized, frame, f, rows, frame_y );
+    frame_y = f.ds.get_height();
+  }
+#endif
   for ( ; frame_y < f.ds.get_height(); frame_y++ ) {
     wrap = put_row( initialized, frame, f, frame_y, *rows.at( frame_y ), wrap );
   }
@@ -336,12 +482,13 @@ std::string Display::new_frame( bool initialized, const Framebuffer &last, const
     }
   }
 
+  prior_frame_bytes = frame.str.size();
+
   return frame.str;
 }
 
 bool Display::put_row( bool initialized, FrameState &frame, const Framebuffer &f, int frame_y, const Row &old_row, bool wrap ) const
 {
-  char tmp[ 64 ];
   int frame_x = 0;
 
   const Row &row = *f.get_row( frame_y );
@@ -357,8 +504,9 @@ bool Display::put_row( bool initialized, FrameState &frame, const Framebuffer &f
     frame.cursor_x += cell.get_width();
   }
 
-  /* If rows are the same object, we don't need to do anything at all. */
-  if (initialized && &row == &old_row ) {
+  /* If rows are the same object, or copies with no writes since they
+     diverged, we don't need to do anything at all. */
+  if (initialized && ( &row == &old_row || row.gen == old_row.gen ) ) {
     return false;
   }
 
@@ -401,8 +549,9 @@ bool Display::put_row( bool initialized, FrameState &frame, const Framebuffer &f
       frame.update_rendition( blank_renditions );
       bool can_use_erase = has_bce || ( frame.current_rendition == initial_rendition() );
       if ( can_use_erase && has_ech && clear_count > 4 ) {
-	snprintf( tmp, 64, "\033[%dX", clear_count );
-	frame.append( tmp );
+	frame.append( "\033[" );
+	frame.append_num( clear_count );
+	frame.append( 'X' );
       } else {
 	frame.append( clear_count, ' ' );
 	frame.cursor_x = frame_x;
@@ -480,13 +629,120 @@ bool Display::put_row( bool initialized, FrameState &frame, const Framebuffer &f
   return false;
 }
 
-FrameState::FrameState( const Framebuffer &s_last )
+#if HAVE_PTHREAD_H
+
+class Display::RowShard {
+public:
+  const Display *display;
+  const Framebuffer *f;
+  const Framebuffer::rows_type *rows;
+  FrameState *frame;
+  int start_y, end_y;
+  bool initialized;
+
+  RowShard()
+    : display( NULL ), f( NULL ), rows( NULL ), frame( NULL ),
+      start_y( 0 ), end_y( 0 ), initialized( false )
+  {}
+};
+
+void *Display::row_shard_thread( void *arg )
+{
+  RowShard *job = static_cast<RowShard *>( arg );
+  bool wrap = false;
+  for ( int y = job->start_y; y < job->end_y; y++ ) {
+    wrap = job->display->put_row( job->initialized, *job->frame, *job->f,
+				  y, *job->rows->at( y ), wrap );
+  }
+  return NULL;
+}
+
+void Display::put_rows_parallel( bool initialized, FrameState &frame, const Framebuffer &f,
+				 const Framebuffer::rows_type &rows, int start_y ) const
+{
+  const int height = f.ds.get_height();
+  const int rows_per_shard = ( height - start_y + PARALLEL_SHARDS - 1 ) / PARALLEL_SHARDS;
+
+  RowShard jobs[ PARALLEL_SHARDS ];
+  FrameState *shard_frames[ PARALLEL_SHARDS ] = { NULL };
+  pthread_t threads[ PARALLEL_SHARDS ];
+  bool started[ PARALLEL_SHARDS ] = { false };
+
+  int num_shards = 0;
+  for ( int y = start_y; y < height; y += rows_per_shard ) {
+    RowShard &job = jobs[ num_shards ];
+    job.display = this;
+    job.f = &f;
+    job.rows = &rows;
+    job.start_y = y;
+    job.end_y = ( y + rows_per_shard < height ) ? ( y + rows_per_shard ) : height;
+    job.initialized = initialized;
+
+    if ( num_shards == 0 ) {
+      /* the first shard continues in the caller's FrameState */
+      job.frame = &frame;
+    } else {
+      /* Later shards can't know where the cursor or renditions will
+	 be left by the shard before them, so they start from an
+	 explicit reset and position everything absolutely.  That
+	 makes each shard's output independent of the others, and the
+	 results can be stitched together in row order. */
+      FrameState *shard_frame = new FrameState( frame.last_frame );
+      shard_frame->cursor_x = shard_frame->cursor_y = -1;
+      shard_frame->current_rendition = initial_rendition();
+      shard_frame->append( "\033[0m" );
+      shard_frames[ num_shards ] = shard_frame;
+      job.frame = shard_frame;
+    }
+    num_shards++;
+  }
+
+  for ( int i = 1; i < num_shards; i++ ) {
+    started[ i ] = ( pthread_create( &threads[ i ], NULL, row_shard_thread, &jobs[ i ] ) == 0 );
+  }
+
+  row_shard_thread( &jobs[ 0 ] ); /* shard 0 runs on this thread */
+
+  for ( int i = 1; i < num_shards; i++ ) {
+    if ( started[ i ] ) {
+      pthread_join( threads[ i ], NULL );
+    } else {
+      row_shard_thread( &jobs[ i ] ); /* couldn't spawn; do it inline */
+    }
+  }
+
+  /* Stitch in order.  A shard that wrote nothing beyond its leading
+     reset is dropped entirely, so quiescent regions of the screen
+     still cost no output. */
+  static const size_t RESET_LEN = 4; /* strlen( "\033[0m" ) */
+  for ( int i = 1; i < num_shards; i++ ) {
+    FrameState *shard_frame = shard_frames[ i ];
+    if ( shard_frame->str.size() > RESET_LEN ) {
+      frame.str += shard_frame->str;
+      frame.cursor_x = shard_frame->cursor_x;
+      frame.cursor_y = shard_frame->cursor_y;
+      frame.current_rendition = shard_frame->current_rendition;
+    }
+    delete shard_frame;
+  }
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+FrameState::FrameState( const Framebuffer &s_last, size_t size_hint )
       : str(), cursor_x(0), cursor_y(0), current_rendition( 0 ),
 	cursor_visible( s_last.ds.cursor_visible ),
+	sgr_cache(),
 	last_frame( s_last )
 {
-  /* Preallocate for better performance.  Make a guess-- doesn't matter for correctness */
-  str.reserve( last_frame.ds.get_width() * last_frame.ds.get_height() * 4 );
+  /* Preallocate for better performance.  The size of the previous
+     frame predicts this one better than the screen dimensions do;
+     without a hint, make a guess.  Doesn't matter for correctness. */
+  if ( size_hint ) {
+    str.reserve( 2 * size_hint );
+  } else {
+    str.reserve( last_frame.ds.get_width() * last_frame.ds.get_height() * 4 );
+  }
 }
 
 void FrameState::append_silent_move( int y, int x )
@@ -523,15 +779,24 @@ void FrameState::append_move( int y, int x )
     }
     // More optimizations are possible.
   }
-  char tmp[ 64 ];
-  snprintf( tmp, 64, "\033[%d;%dH", y + 1, x + 1 );
-  append( tmp );
+  append( "\033[" );
+  append_num( y + 1 );
+  append( ';' );
+  append_num( x + 1 );
+  append( 'H' );
 }
 
 void FrameState::update_rendition(const Renditions &r, bool force) {
   if ( force || !(current_rendition == r) ) {
-    /* print renditions */
-    append_string( r.sgr() );
+    /* print renditions, formatted at most once per frame (see sgr_cache) */
+    if ( sgr_cache.size() >= 1024 ) {
+      sgr_cache.clear();
+    }
+    std::string &memo = sgr_cache[ r.packed() ];
+    if ( memo.empty() ) {
+      memo = r.sgr();
+    }
+    append_string( memo );
     current_rendition = r;
   }
 }
@@ -33,6 +33,8 @@
 #ifndef TERMINALDISPLAY_HPP
 #define TERMINALDISPLAY_HPP
 
+#include <map>
+
 #include "terminalframebuffer.h"
 
 namespace Terminal {
@@ -45,9 +47,18 @@ namespace Terminal {
     Renditions current_rendition;
     bool cursor_visible;
 
+    /* SGR strings formatted so far this frame, keyed by the packed
+       rendition word: a frame rarely uses more than a handful of
+       distinct renditions, so each gets formatted once.  Lives here
+       rather than in a shared cache because the row shards run
+       put_row concurrently, each on its own FrameState.  Bounded in
+       case an application cycles through truecolor renditions without
+       ever repeating. */
+    std::map<uint64_t, std::string> sgr_cache;
+
     const Framebuffer &last_frame;
 
-    FrameState( const Framebuffer &s_last );
+    FrameState( const Framebuffer &s_last, size_t size_hint = 0 );
 
     void append( char c ) { str.append( 1, c ); }
     void append( size_t s, char c ) { str.append( s, c ); }
@@ -55,6 +66,18 @@ namespace Terminal {
     void append( const char * s ) { str.append( s ); }
     void append_string( const std::string &append ) { str.append(append); }
 
+    /* decimal CSI parameter, formatted on the stack */
+    void append_num( int n )
+    {
+      char tmp[ 12 ];
+      char *p = tmp + sizeof tmp;
+      do {
+	*--p = '0' + ( n % 10 );
+	n /= 10;
+      } while ( n > 0 );
+      str.append( p, tmp + sizeof tmp - p );
+    }
+
     void append_cell(const Cell & cell) { cell.print_grapheme( str ); }
     void append_silent_move( int y, int x );
     void append_move( int y, int x );
@@ -72,8 +95,18 @@ namespace Terminal {
 
     const char *smcup, *rmcup; /* enter and exit alternate screen mode */
 
+    mutable size_t prior_frame_bytes; /* reservation hint for the next frame */
+
     bool put_row( bool initialized, FrameState &frame, const Framebuffer &f, int frame_y, const Row &old_row, bool wrap ) const;
 
+    /* Parallel variant of the row loop for very large framebuffers:
+       rows are sharded across threads and the output stitched back in
+       order.  Only defined where pthreads are available. */
+    class RowShard;
+    static void *row_shard_thread( void *arg );
+    void put_rows_parallel( bool initialized, FrameState &frame, const Framebuffer &f,
+			    const Framebuffer::rows_type &rows, int start_y ) const;
+
   public:
     std::string open() const;
     std::string close() const;
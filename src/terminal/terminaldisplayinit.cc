@@ -81,7 +81,8 @@ static const char *ti_str( const char *capname )
 }
 
 Display::Display( bool use_environment )
-  : has_ech( true ), has_bce( true ), has_title( true ), smcup( NULL ), rmcup( NULL )
+  : has_ech( true ), has_bce( true ), has_title( true ), smcup( NULL ), rmcup( NULL ),
+    prior_frame_bytes( 0 )
 {
   if ( use_environment ) {
     int errret = -2;
@@ -33,13 +33,22 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <map>
+
+#ifdef __ARM_FEATURE_CRC32
+#include <arm_acle.h>
+#endif
 
 #include "terminalframebuffer.h"
+#include "precompose.h"
 
 using namespace Terminal;
 
 Cell::Cell( color_type background_color )
   : contents(),
+    contents_size( 0 ),
     renditions( background_color ),
     wide( false ),
     fallback( false ),
@@ -48,13 +57,52 @@ Cell::Cell( color_type background_color )
 
 void Cell::reset( color_type background_color )
 {
-  contents.clear();
+  contents_size = 0;
   renditions = Renditions( background_color );
   wide = false;
   fallback = false;
   wrap = false;
 }
 
+/* Try to collapse the cell's last character and the arriving
+   combining character c into a single precomposed codepoint.  Only a
+   direct pair composition is attempted; sequences NFC would reorder
+   first are left as they arrive, which just means they stay in the
+   (correct) decomposed form. */
+bool Cell::try_precompose( const wchar_t c )
+{
+  /* find the lead octet of the last character */
+  size_t lead = contents_size - 1;
+  while ( ( lead > 0 ) && ( ( contents[ lead ] & 0xC0 ) == 0x80 ) ) {
+    lead--;
+  }
+  if ( ( contents[ lead ] & 0xC0 ) == 0x80 ) {
+    return false; /* malformed contents */
+  }
+
+  wchar_t base;
+  mbstate_t ps = mbstate_t();
+  if ( mbrtowc( &base, contents + lead, contents_size - lead, &ps )
+       != contents_size - lead ) {
+    return false;
+  }
+
+  const wchar_t composed = precompose( base, c );
+  if ( composed == 0 ) {
+    return false;
+  }
+
+  char tmp[ MB_LEN_MAX ];
+  mbstate_t ps2 = mbstate_t();
+  const size_t len = wcrtomb( tmp, composed, &ps2 );
+  if ( ( len == (size_t) -1 ) || ( lead + len > CONTENTS_CAP ) ) {
+    return false;
+  }
+  memcpy( contents + lead, tmp, len );
+  contents_size = lead + len;
+  return true;
+}
+
 void DrawState::reinitialize_tabs( unsigned int start )
 {
   assert( default_tabs );
@@ -78,7 +126,8 @@ DrawState::DrawState( int s_width, int s_height )
 }
 
 Framebuffer::Framebuffer( int s_width, int s_height )
-  : rows(), icon_name(), window_title(), clipboard(), bell_count( 0 ), title_initialized( false ), ds( s_width, s_height )
+  : rows(), icon_name(), window_title(), clipboard(), bell_count( 0 ), title_initialized( false ),
+    scrollback_rows( make_shared<rows_type>() ), scrollback_count( 0 ), ds( s_width, s_height )
 {
   assert( s_height > 0 );
   assert( s_width > 0 );
@@ -90,7 +139,9 @@ Framebuffer::Framebuffer( int s_width, int s_height )
 Framebuffer::Framebuffer( const Framebuffer &other )
   : rows( other.rows ), icon_name( other.icon_name ), window_title( other.window_title ),
     clipboard( other.clipboard ), bell_count( other.bell_count ),
-    title_initialized( other.title_initialized ), ds( other.ds )
+    title_initialized( other.title_initialized ),
+    scrollback_rows( other.scrollback_rows ), scrollback_count( other.scrollback_count ),
+    ds( other.ds )
 {
 }
 
@@ -103,6 +154,8 @@ Framebuffer & Framebuffer::operator=( const Framebuffer &other )
     clipboard = other.clipboard;
     bell_count = other.bell_count;
     title_initialized = other.title_initialized;
+    scrollback_rows = other.scrollback_rows;
+    scrollback_count = other.scrollback_count;
     ds = other.ds;
   }
   return *this;
@@ -313,6 +366,17 @@ void Framebuffer::insert_line( int before_row, int count )
     return;
   }
 
+  /* full-height region: roll the deque around instead of shifting */
+  if ( (ds.get_scrolling_region_top_row() == 0)
+       && (ds.get_scrolling_region_bottom_row() == ds.get_height() - 1)
+       && (before_row == 0) ) {
+    for ( int i = 0; i < scroll; i++ ) {
+      rows.pop_back();
+      rows.push_front( newrow() );
+    }
+    return;
+  }
+
   // delete old rows
   rows_type::iterator start = rows.begin() + ds.get_scrolling_region_bottom_row() + 1 - scroll;
   rows.erase( start, start + scroll );
@@ -337,6 +401,18 @@ void Framebuffer::delete_line( int row, int count )
     return;
   }
 
+  /* full-height region: roll the deque around instead of shifting */
+  if ( (ds.get_scrolling_region_top_row() == 0)
+       && (ds.get_scrolling_region_bottom_row() == ds.get_height() - 1)
+       && (row == 0) ) {
+    for ( int i = 0; i < scroll; i++ ) {
+      append_scrollback_row( rows.front() ); /* retain for scrollback */
+      rows.pop_front();
+      rows.push_back( newrow() );
+    }
+    return;
+  }
+
   // delete old rows
   rows_type::iterator start = rows.begin() + row;
   rows.erase( start, start + scroll );
@@ -346,7 +422,8 @@ void Framebuffer::delete_line( int row, int count )
 }
 
 Row::Row( const size_t s_width, const color_type background_color )
-  : cells( s_width, Cell( background_color ) ), gen( get_gen() )
+  : cells( s_width, Cell( background_color ) ), gen( get_gen() ),
+    fingerprint_val( 0 ), fingerprint_gen( uint64_t( -1 ) )
 {}
 
 uint64_t Row::get_gen() const
@@ -355,6 +432,115 @@ uint64_t Row::get_gen() const
   return gen_counter++;
 }
 
+/* FNV-1a */
+static uint64_t fnv_octets( uint64_t h, const void *buf, size_t len )
+{
+  const uint8_t *octets = static_cast<const uint8_t *>( buf );
+  for ( size_t i = 0; i < len; i++ ) {
+    h ^= octets[ i ];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+/* Fingerprints are compared only between rows hashed within this
+   process, so the hash function is free to differ by host.  Where
+   the CPU has a CRC32C instruction (SSE4.2, or the ARMv8 CRC
+   extension), consume eight bytes per step instead of one.  The
+   32-bit range is plenty: every caller confirms a matching
+   fingerprint cell by cell, so a collision only costs that
+   comparison. */
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define FINGERPRINT_CRC_RUNTIME 1
+
+__attribute__((target("sse4.2")))
+static uint64_t crc_octets( uint64_t h, const void *buf, size_t len )
+{
+  const uint8_t *octets = static_cast<const uint8_t *>( buf );
+  while ( len >= sizeof( uint64_t ) ) {
+    uint64_t word;
+    memcpy( &word, octets, sizeof word );
+    h = __builtin_ia32_crc32di( h, word );
+    octets += sizeof word;
+    len -= sizeof word;
+  }
+  while ( len > 0 ) {
+    h = __builtin_ia32_crc32qi( h, *octets++ );
+    len--;
+  }
+  return h;
+}
+
+static bool cpu_has_crc( void )
+{
+  static const bool present = __builtin_cpu_supports( "sse4.2" );
+  return present;
+}
+
+#elif defined(__ARM_FEATURE_CRC32)
+#define FINGERPRINT_CRC_ALWAYS 1
+
+static uint64_t crc_octets( uint64_t h, const void *buf, size_t len )
+{
+  uint32_t c = (uint32_t) h;
+  const uint8_t *octets = static_cast<const uint8_t *>( buf );
+  while ( len >= sizeof( uint64_t ) ) {
+    uint64_t word;
+    memcpy( &word, octets, sizeof word );
+    c = __crc32cd( c, word );
+    octets += sizeof word;
+    len -= sizeof word;
+  }
+  while ( len > 0 ) {
+    c = __crc32cb( c, *octets++ );
+    len--;
+  }
+  return c;
+}
+#endif
+
+static uint64_t hash_octets( uint64_t h, const void *buf, size_t len )
+{
+#if defined(FINGERPRINT_CRC_RUNTIME)
+  if ( cpu_has_crc() ) {
+    return crc_octets( h, buf, len );
+  }
+#elif defined(FINGERPRINT_CRC_ALWAYS)
+  return crc_octets( h, buf, len );
+#endif
+  return fnv_octets( h, buf, len );
+}
+
+uint64_t Cell::mix_fingerprint( uint64_t h ) const
+{
+  h = hash_octets( h, contents, contents_size );
+  const uint64_t state = ( renditions.packed() << 6 )
+    ^ ( (uint64_t) contents_size << 3 )
+    ^ ( (uint64_t) wide << 2 )
+    ^ ( (uint64_t) fallback << 1 )
+    ^ (uint64_t) wrap;
+  return hash_octets( h, &state, sizeof state );
+}
+
+uint64_t Row::fingerprint( void ) const
+{
+  if ( fingerprint_gen == gen ) {
+    return fingerprint_val;
+  }
+
+  uint64_t h = 14695981039346656037ULL; /* FNV offset basis */
+  for ( cells_type::const_iterator i = cells.begin();
+	i != cells.end();
+	i++ ) {
+    h = i->mix_fingerprint( h );
+  }
+
+  fingerprint_val = h;
+  fingerprint_gen = gen;
+  return h;
+}
+
 void Row::insert_cell( int col, color_type background_color )
 {
   cells.insert( cells.begin() + col, Cell( background_color ) );
@@ -420,6 +606,7 @@ void Framebuffer::resize( int s_width, int s_height )
     *i = make_shared<Row>( **i );
     (*i)->set_wrap( false );
     (*i)->cells.resize( s_width, Cell( ds.get_background_rendition() ) );
+    (*i)->touch();
   }
 }
 
@@ -454,8 +641,7 @@ void DrawState::resize( int s_width, int s_height )
 }
 
 Renditions::Renditions( color_type s_background )
-  : foreground_color( 0 ), background_color( s_background ),
-    attributes( 0 )
+  : word( uint64_t( s_background ) & color_mask )
 {}
 
 /* This routine cannot be used to set a color beyond the 16-color set. */
@@ -463,29 +649,30 @@ void Renditions::set_rendition( color_type num )
 {
   if ( num == 0 ) {
     clear_attributes();
-    foreground_color = background_color = 0;
+    set_fg( 0 );
+    set_bg( 0 );
     return;
   }
 
   if ( num == 39 ) {
-    foreground_color = 0;
+    set_fg( 0 );
     return;
   } else if ( num == 49 ) {
-    background_color = 0;
+    set_bg( 0 );
     return;
   }
 
   if ( (30 <= num) && (num <= 37) ) { /* foreground color in 8-color set */
-    foreground_color = num;
+    set_fg( num );
     return;
   } else if ( (40 <= num) && (num <= 47) ) { /* background color in 8-color set */
-    background_color = num;
+    set_bg( num );
     return;
   } else if ( (90 <= num) && (num <= 97) ) { /* foreground color in 16-color set */
-    foreground_color = num - 90 + 38;
+    set_fg( num - 90 + 38 );
     return;
   } else if ( (100 <= num) && (num <= 107) ) { /* background color in 16-color set */
-    background_color = num - 100 + 48;
+    set_bg( num - 100 + 48 );
     return;
   }
 
@@ -504,18 +691,18 @@ void Renditions::set_rendition( color_type num )
 void Renditions::set_foreground_color( int num )
 {
   if ( (0 <= num) && (num <= 255) ) {
-    foreground_color = 30 + num;
+    set_fg( 30 + num );
   } else if ( is_true_color( num ) ) {
-    foreground_color = num;
+    set_fg( num );
   }
 }
 
 void Renditions::set_background_color( int num )
 {
   if ( (0 <= num) && (num <= 255) ) {
-    background_color = 40 + num;
+    set_bg( 40 + num );
   } else if ( is_true_color( num ) ) {
-    background_color = num;
+    set_bg( num );
   }
 }
 
@@ -532,11 +719,10 @@ std::string Renditions::sgr( void ) const
   if ( get_attribute( inverse ) ) ret.append( ";7" );
   if ( get_attribute( invisible ) ) ret.append( ";8" );
 
+  const int foreground_color = fg();
+  const int background_color = bg();
+
   if ( foreground_color ) {
-    // Since foreground_color is a 25-bit field, it is promoted to an int when
-    // manipulated. (See [conv.prom] in various C++ standards, e.g.,
-    // https://timsong-cpp.github.io/cppwp/n4659/conv.prom#5.) The correct
-    // printf format specifier is thus %d.
     if ( is_true_color( foreground_color ) ) {
       snprintf( col, sizeof( col ), ";38;2;%d;%d;%d",
 		(foreground_color >> 16) & 0xff,
@@ -545,17 +731,11 @@ std::string Renditions::sgr( void ) const
     } else if ( foreground_color > 37 ) { /* use 256-color set */
       snprintf( col, sizeof( col ), ";38;5;%d", foreground_color - 30 );
     } else { /* ANSI foreground color */
-      // Unfortunately, some versions of GCC (notably including GCC 9.3) give
-      // -Wformat warnings when relying on [conv.prom] to promote
-      // foreground_color in calls to printf. Explicitly promote it to silence
-      // the warning.
-      int fg = foreground_color;
-      snprintf( col, sizeof( col ), ";%d", fg );
+      snprintf( col, sizeof( col ), ";%d", foreground_color );
     }
     ret.append( col );
   }
   if ( background_color ) {
-    // See comment above about bit-field promotion; it applies here as well.
     if ( is_true_color( background_color ) ) {
       snprintf( col, sizeof( col ), ";48;2;%d;%d;%d",
 		(background_color >> 16) & 0xff,
@@ -564,9 +744,7 @@ std::string Renditions::sgr( void ) const
     } else if ( background_color > 47 ) { /* use 256-color set */
       snprintf( col, sizeof( col ), ";48;5;%d", background_color - 40 );
     } else { /* ANSI background color */
-      // See comment above about explicit promotion; it applies here as well.
-      int bg = background_color;
-      snprintf( col, sizeof( col ), ";%d", bg );
+      snprintf( col, sizeof( col ), ";%d", background_color );
     }
     ret.append( col );
   }
@@ -596,7 +774,7 @@ void Framebuffer::prefix_window_title( const title_type &s )
 
 std::string Cell::debug_contents( void ) const
 {
-  if ( contents.empty() ) {
+  if ( empty() ) {
     return "'_' ()";
   }
   std::string chars( 1, '\'' );
@@ -604,11 +782,8 @@ std::string Cell::debug_contents( void ) const
   chars.append( "' [" );
   const char *lazycomma = "";
   char buf[64];
-  for ( content_type::const_iterator i = contents.begin();
-	i < contents.end();
-	i++ ) {
-
-    snprintf( buf, sizeof buf, "%s0x%02x", lazycomma, static_cast<uint8_t>(*i) );
+  for ( size_t i = 0; i < contents_size; i++ ) {
+    snprintf( buf, sizeof buf, "%s0x%02x", lazycomma, static_cast<uint8_t>( contents[ i ] ) );
     chars.append( buf );
     lazycomma = ", ";
   }
@@ -635,9 +810,9 @@ bool Cell::compare( const Cell &other ) const
     // ret = true;
     fprintf( stderr, "Contents: %s (%ld) vs. %s (%ld)\n",
 	     debug_contents().c_str(),
-	     static_cast<long int>( contents.size() ),
+	     static_cast<long int>( contents_size ),
 	     other.debug_contents().c_str(),
-	     static_cast<long int>( other.contents.size() ) );
+	     static_cast<long int>( other.contents_size ) );
   }
 
   if ( fallback != other.fallback ) {
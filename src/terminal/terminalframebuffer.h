@@ -36,6 +36,7 @@
 #include <assert.h>
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <vector>
 #include <deque>
@@ -57,15 +58,36 @@ namespace Terminal {
 
   private:
     static const uint64_t true_color_mask = 0x1000000;
-    uint64_t foreground_color : 25;
-    uint64_t background_color : 25;
-    uint64_t attributes : 8;
+
+    /* The whole rendition state lives in one word -- background in
+       bits 0-24, foreground in bits 25-49, attributes in bits 50-57 --
+       so equality, the SGR memo key, and the wire encoding are all
+       the same integer. */
+    static const uint64_t color_mask = 0x1FFFFFF;
+    static const unsigned int fg_shift = 25;
+    static const unsigned int attr_shift = 50;
+
+    uint64_t word;
+
+    unsigned int fg( void ) const { return ( word >> fg_shift ) & color_mask; }
+    unsigned int bg( void ) const { return word & color_mask; }
+    void set_fg( unsigned int color )
+    {
+      word = ( word & ~( color_mask << fg_shift ) )
+	| ( uint64_t( color & color_mask ) << fg_shift );
+    }
+    void set_bg( unsigned int color )
+    {
+      word = ( word & ~color_mask ) | ( color & color_mask );
+    }
 
   public:
     Renditions( color_type s_background );
     void set_foreground_color( int num );
     void set_background_color( int num );
     void set_rendition( color_type num );
+    /* format the SGR escape sequence for this rendition; callers that
+       care memoize the result by packed() (see FrameState::sgr_cache) */
     std::string sgr( void ) const;
 
     static unsigned int make_true_color( unsigned int r, unsigned int g, unsigned int b ) {
@@ -76,29 +98,45 @@ namespace Terminal {
       return (color & true_color_mask) != 0;
     }
 
-    // unsigned int get_foreground_rendition() const { return foreground_color; }
-    unsigned int get_background_rendition() const { return background_color; }
+    // unsigned int get_foreground_rendition() const { return fg(); }
+    unsigned int get_background_rendition() const { return bg(); }
 
     bool operator==( const Renditions &x ) const
     {
-      return ( attributes == x.attributes )
-        && ( foreground_color == x.foreground_color )
-        && ( background_color == x.background_color );
+      return word == x.word;
+    }
+    /* the whole rendition state, packed into one word */
+    uint64_t packed( void ) const { return word; }
+    /* inverse of packed(), for binary row deltas off the wire */
+    void load_packed( uint64_t p )
+    {
+      word = p & ( ( uint64_t( 1 ) << 58 ) - 1 );
     }
     void set_attribute( attribute_type attr, bool val )
     {
-      attributes = val ?
-	( attributes | (1 << attr) ) :
-	( attributes & ~(1 << attr) );
+      const uint64_t bit = uint64_t( 1 ) << ( attr_shift + attr );
+      word = val ? ( word | bit ) : ( word & ~bit );
+    }
+    bool get_attribute( attribute_type attr ) const
+    {
+      return word & ( uint64_t( 1 ) << ( attr_shift + attr ) );
     }
-    bool get_attribute( attribute_type attr ) const { return attributes & ( 1 << attr ); }
-    void clear_attributes() { attributes = 0; }
+    void clear_attributes() { word &= ( color_mask << fg_shift ) | color_mask; }
   };
 
   class Cell {
+  public:
+    /* full() stops combining-character appends once we hold 32 octets;
+       one more multibyte character may land after that check passes. */
+    static const size_t CONTENTS_CAP = 32 + MB_LEN_MAX;
+
   private:
-    typedef std::string content_type; /* can be std::string, std::vector<uint8_t>, or __gnu_cxx::__vstring */
-    content_type contents;
+    /* Grapheme octets are stored inline (UTF-8), so a Cell is a flat
+       fixed-size object: a Row is one contiguous allocation, and cell
+       comparison is an integer compare plus memcmp, with no
+       pointer-chasing into string heap storage. */
+    char contents[ CONTENTS_CAP ];
+    uint8_t contents_size;
     Renditions renditions;
     unsigned int wide : 1; /* 0 = narrow, 1 = wide */
     unsigned int fallback : 1; /* first character is combining character */
@@ -113,7 +151,8 @@ namespace Terminal {
 
     bool operator==( const Cell &x ) const
     {
-      return ( (contents == x.contents)
+      return ( (contents_size == x.contents_size)
+	       && (memcmp( contents, x.contents, contents_size ) == 0)
 	       && (fallback == x.fallback)
 	       && (wide == x.wide)
 	       && (renditions == x.renditions)
@@ -125,27 +164,31 @@ namespace Terminal {
     /* Accessors for contents field */
     std::string debug_contents( void ) const;
 
-    bool empty( void ) const { return contents.empty(); }
+    bool empty( void ) const { return contents_size == 0; }
     /* 32 seems like a reasonable limit on combining characters */
-    bool full( void ) const { return contents.size() >= 32; }
-    void clear( void ) { contents.clear(); }
+    bool full( void ) const { return contents_size >= 32; }
+    void clear( void ) { contents_size = 0; }
 
     bool is_blank( void ) const
     {
       // XXX fix.
-      return ( contents.empty()
-	       || contents == " "
-	       || contents == "\xC2\xA0" );
+      return ( ( contents_size == 0 )
+	       || ( ( contents_size == 1 ) && ( contents[ 0 ] == ' ' ) )
+	       || ( ( contents_size == 2 ) && ( contents[ 0 ] == '\xC2' )
+		    && ( contents[ 1 ] == '\xA0' ) ) );
     }
 
     bool contents_match ( const Cell &other ) const
     {
       return ( is_blank() && other.is_blank() )
-             || ( contents == other.contents );
+             || ( ( contents_size == other.contents_size )
+		  && ( memcmp( contents, other.contents, contents_size ) == 0 ) );
     }
 
     bool compare( const Cell &other ) const;
 
+    uint64_t mix_fingerprint( uint64_t h ) const;
+
     // Is this a printing ISO 8859-1 character?
     static bool isprint_iso8859_1( const wchar_t c )
     {
@@ -167,11 +210,24 @@ namespace Terminal {
       dest.append( tmp, len );
     }
 
+    /* Replace the last character with its NFC composition with c,
+       when one exists; defined in terminalframebuffer.cc. */
+    bool try_precompose( const wchar_t c );
+
     void append( const wchar_t c )
     {
       /* ASCII?  Cheat. */
       if ( static_cast<uint32_t>(c) <= 0x7f ) {
-	contents.push_back( static_cast<char>(c) );
+	if ( contents_size < CONTENTS_CAP ) {
+	  contents[ contents_size++ ] = static_cast<char>(c);
+	}
+	return;
+      }
+      /* A combining character lands here with the base character (or
+	 a partial stack) already in the cell; collapsing the pair to
+	 its precomposed form keeps accent-heavy cells short, so later
+	 comparisons memcmp fewer octets. */
+      if ( ( contents_size > 0 ) && try_precompose( c ) ) {
 	return;
       }
       static mbstate_t ps = mbstate_t();
@@ -179,12 +235,16 @@ namespace Terminal {
       size_t ignore = wcrtomb(NULL, 0, &ps);
       (void)ignore;
       size_t len = wcrtomb(tmp, c, &ps);
-      contents.insert( contents.end(), tmp, tmp+len );
+      if ( ( len != (size_t) -1 )
+	   && ( contents_size + len <= CONTENTS_CAP ) ) {
+	memcpy( contents + contents_size, tmp, len );
+	contents_size += len;
+      }
     }
 
     void print_grapheme( std::string &output ) const
     {
-      if ( contents.empty() ) {
+      if ( contents_size == 0 ) {
 	output.append( 1, ' ' );
 	return;
       }
@@ -195,7 +255,18 @@ namespace Terminal {
       if ( fallback ) {
 	output.append( "\xC2\xA0" );
       }
-      output.append( contents );
+      output.append( contents, contents_size );
+    }
+
+    /* raw contents, for binary row deltas */
+    const char *get_contents( void ) const { return contents; }
+    size_t get_contents_size( void ) const { return contents_size; }
+    void set_contents( const char *data, size_t len )
+    {
+      if ( len <= CONTENTS_CAP ) {
+	memcpy( contents, data, len );
+	contents_size = len;
+      }
     }
 
     /* Other accessors */
@@ -217,10 +288,25 @@ namespace Terminal {
     cells_type cells;
     // gen is a generation counter.  It can be used to quickly rule
     // out the possibility of two rows being identical; this is useful
-    // in scrolling.
+    // in scrolling.  Framebuffer::get_mutable_row() touch()es the row
+    // it hands out, so two rows with equal gen are copies of the same
+    // original with no writes since -- the display writer uses this
+    // to skip untouched rows without comparing their cells.
     uint64_t gen;
 
+    void touch( void ) { gen = get_gen(); }
+
+    /* 64-bit hash of the row contents, memoized against gen (so it is
+       recomputed only after a write).  Unlike operator==, it can match
+       rows of different lineage, which lets the display writer detect
+       scrolled content as moved even when sharing was broken. */
+    uint64_t fingerprint( void ) const;
+    bool contents_equal( const Row &x ) const { return cells == x.cells; }
+
   private:
+    mutable uint64_t fingerprint_val;
+    mutable uint64_t fingerprint_gen; /* gen the cached value was computed at */
+
     Row();
   public:
     Row( const size_t s_width, const color_type background_color );
@@ -353,6 +439,18 @@ namespace Terminal {
 	( reverse_video == x.reverse_video ) && ( renditions == x.renditions ) &&
   ( bracketed_paste == x.bracketed_paste ) && ( mouse_reporting_mode == x.mouse_reporting_mode ) &&
   ( mouse_focus_event == x.mouse_focus_event ) && ( mouse_alternate_scroll == x.mouse_alternate_scroll) &&
+  ( mouse_encoding_mode == x.mouse_encoding_mode );
+    }
+
+    /* Like operator==(), but ignores the cursor position; a binary
+       row delta carries the cursor separately. */
+    bool equal_except_cursor( const DrawState &x ) const
+    {
+      return ( width == x.width ) && ( height == x.height )
+	&& ( cursor_visible == x.cursor_visible ) &&
+	( reverse_video == x.reverse_video ) && ( renditions == x.renditions ) &&
+  ( bracketed_paste == x.bracketed_paste ) && ( mouse_reporting_mode == x.mouse_reporting_mode ) &&
+  ( mouse_focus_event == x.mouse_focus_event ) && ( mouse_alternate_scroll == x.mouse_alternate_scroll) &&
   ( mouse_encoding_mode == x.mouse_encoding_mode );
     }
   };
@@ -373,7 +471,15 @@ namespace Terminal {
   public:
     typedef std::vector<wchar_t> title_type;
     typedef shared_ptr<Row> row_pointer;
-    typedef std::vector<row_pointer> rows_type; /* can be either std::vector or std::deque */
+    /* A deque so that scrolling a full-height region is a base-index
+       adjustment (pop at one end, push at the other) instead of
+       shifting every row pointer; see scroll()/delete_line(). */
+    typedef std::deque<row_pointer> rows_type; /* can be either std::vector or std::deque */
+
+    /* Rows scrolled off the top of a full-screen scrolling region are
+       retained in a bounded ring.  Evicted rows stay shared until
+       someone writes to them, so retention costs one pointer per row. */
+    static const unsigned int SCROLLBACK_CAPACITY = 1000;
 
   private:
     rows_type rows;
@@ -383,6 +489,13 @@ namespace Terminal {
     unsigned int bell_count;
     bool title_initialized; /* true if the window title has been set via an OSC */
 
+    /* The ring itself is copy-on-write, like the rows: snapshots of
+       the framebuffer (sent_states keeps dozens in flight) share it
+       through the pointer, and the first eviction after a snapshot
+       pays for the clone. */
+    shared_ptr<rows_type> scrollback_rows;
+    uint64_t scrollback_count; /* total rows ever evicted */
+
     row_pointer newrow( void )
     {
       const size_t w = ds.get_width();
@@ -398,6 +511,21 @@ namespace Terminal {
 
     const rows_type &get_rows() const { return rows; }
 
+    const rows_type & get_scrollback( void ) const { return *scrollback_rows; }
+    uint64_t get_scrollback_count( void ) const { return scrollback_count; }
+    void append_scrollback_row( const row_pointer &row )
+    {
+      if ( !scrollback_rows.unique() ) {
+	scrollback_rows = make_shared<rows_type>( *scrollback_rows );
+      }
+      scrollback_rows->push_back( row );
+      if ( scrollback_rows->size() > SCROLLBACK_CAPACITY ) {
+	scrollback_rows->pop_front();
+      }
+      scrollback_count++;
+    }
+    void set_scrollback_count( uint64_t n ) { scrollback_count = n; }
+
     void scroll( int N );
     void move_rows_autoscroll( int rows );
 
@@ -424,6 +552,8 @@ namespace Terminal {
       if (!mutable_row.unique()) {
 	mutable_row = make_shared<Row>( *mutable_row );
       }
+      // Caller is going to write; mark the row as diverged from any copies.
+      mutable_row->touch();
       return mutable_row.get();
     }
 
@@ -36,7 +36,7 @@
 using namespace Terminal;
 using std::string;
 
-string UserInput::input( const Parser::UserByte *act,
+string UserInput::input( const Parser::Action *act,
 			 bool application_mode_cursor_keys )
 {
   /* The user will always be in application mode. If stm is not in
@@ -82,3 +82,19 @@ string UserInput::input( const Parser::UserByte *act,
     return string();
   }
 }
+
+string UserInput::input_string( const string &str,
+				bool application_mode_cursor_keys )
+{
+  /* fast path: nothing for the state machine to see */
+  if ( ( state == Ground ) && ( str.find( '\x1b' ) == string::npos ) ) {
+    return str;
+  }
+
+  string ret;
+  for ( size_t i = 0; i < str.size(); i++ ) {
+    const Parser::UserByte byte( str[ i ] );
+    ret += input( &byte, application_mode_cursor_keys );
+  }
+  return ret;
+}
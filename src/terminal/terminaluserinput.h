@@ -53,9 +53,14 @@ namespace Terminal {
       : state( Ground )
     {}
 
-    std::string input( const Parser::UserByte *act,
+    std::string input( const Parser::Action *act,
 		       bool application_mode_cursor_keys );
 
+    /* bulk path for pasted data; same state machine, applied to a
+       whole string at once */
+    std::string input_string( const std::string &str,
+			      bool application_mode_cursor_keys );
+
     bool operator==( const UserInput &x ) const { return state == x.state; }
   };
 }
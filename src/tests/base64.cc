@@ -129,6 +129,88 @@ static void test_base64( void ) {
   }
 }
 
+static void test_base64_bulk( void ) {
+  PRNG prng;
+
+  /* round-trip random payloads of every length 0..300 through the
+     bulk and streaming interfaces */
+  for ( size_t len = 0; len <= 300; len++ ) {
+    uint8_t source[ 300 ];
+    prng.fill( source, len );
+
+    char encoded[ 404 ];
+    base64_encode_bulk( source, len, encoded, sizeof encoded );
+    const size_t encoded_len = base64_encoded_length( len );
+
+    uint8_t decoded[ 300 ];
+    size_t raw_len = sizeof decoded;
+    fatal_assert( base64_decode_bulk( encoded, encoded_len, decoded, &raw_len ) );
+    fatal_assert( raw_len == len );
+    fatal_assert( !memcmp( source, decoded, len ) );
+
+    /* the streaming encoder, fed one byte at a time, must agree */
+    Base64Encoder encoder;
+    std::string streamed;
+    for ( size_t i = 0; i < len; i++ ) {
+      encoder.encode( source + i, 1, streamed );
+    }
+    encoder.finish( streamed );
+    fatal_assert( streamed.size() == encoded_len );
+    fatal_assert( !memcmp( streamed.data(), encoded, encoded_len ) );
+
+    /* and the streaming decoder, fed odd-sized pieces */
+    Base64Decoder decoder;
+    std::string recovered;
+    size_t offset = 0;
+    while ( offset < encoded_len ) {
+      size_t piece = 3;
+      if ( piece > encoded_len - offset ) {
+	piece = encoded_len - offset;
+      }
+      fatal_assert( decoder.decode( encoded + offset, piece, recovered ) );
+      offset += piece;
+    }
+    fatal_assert( decoder.finish() );
+    fatal_assert( recovered.size() == len );
+    fatal_assert( !memcmp( recovered.data(), source, len ) );
+  }
+  if ( verbose ) {
+    printf( "bulk round-trip PASSED\n" );
+  }
+
+  /* reject non-canonical and malformed input */
+  const char *bad_bulk[] = {
+    "A",			/* not a multiple of four */
+    "====",			/* nothing but padding */
+    "A===",			/* too much padding */
+    "AB=A",			/* data after padding */
+    "AB==AAAA",			/* padding before the end */
+    "AC==",			/* nonzero discarded bits */
+    "ABB=",			/* nonzero discarded bits */
+    "AAA~",			/* bad character */
+    NULL,
+  };
+  for ( const char **bad = bad_bulk; *bad != NULL; bad++ ) {
+    uint8_t decoded[ 16 ];
+    size_t raw_len = sizeof decoded;
+    fatal_assert( !base64_decode_bulk( *bad, strlen( *bad ), decoded, &raw_len ) );
+
+    Base64Decoder decoder;
+    std::string recovered;
+    fatal_assert( !decoder.decode( *bad, strlen( *bad ), recovered )
+		  || !decoder.finish() );
+  }
+
+  /* reject output overflow */
+  uint8_t tiny[ 2 ];
+  size_t tiny_len = sizeof tiny;
+  fatal_assert( !base64_decode_bulk( "AAAA", 4, tiny, &tiny_len ) );
+
+  if ( verbose ) {
+    printf( "bulk bad-input PASSED\n" );
+  }
+}
+
 int main( int argc, char *argv[] )
 {
   if ( argc >= 2 && strcmp( argv[ 1 ], "-v" ) == 0 ) {
@@ -137,6 +219,7 @@ int main( int argc, char *argv[] )
 
   try {
     test_base64();
+    test_base64_bulk();
   } catch ( const std::exception &e ) {
     fprintf( stderr, "Error: %s\r\n", e.what() );
     return 1;
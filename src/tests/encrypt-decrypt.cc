@@ -85,6 +85,24 @@ static void test_bad_decrypt( Session &decryption_session ) {
   fatal_assert( got_exn );
 }
 
+/* A ciphertext longer than the receive MTU must be rejected (non-fatally)
+   before it reaches the fixed-size scratch buffers. */
+static void test_oversized_decrypt( Session &decryption_session ) {
+  char buf[ Session::RECEIVE_MTU + 1024 ];
+  prng.fill( buf, sizeof buf );
+  std::string oversized_ct( buf, sizeof buf );
+
+  bool got_exn = false;
+  try {
+    decryption_session.decrypt( oversized_ct );
+  } catch ( const CryptoException &e ) {
+    got_exn = true;
+    fatal_assert( ! e.fatal );
+  }
+
+  fatal_assert( got_exn );
+}
+
 /* Generate a single key and initial nonce, then perform some encryptions. */
 static void test_one_session( void ) {
   Base64Key key;
@@ -127,6 +145,10 @@ static void test_one_session( void ) {
       test_bad_decrypt( decryption_session );
     }
 
+    if ( ! ( prng.uint8() % 64 ) ) {
+      test_oversized_decrypt( decryption_session );
+    }
+
     if ( verbose ) {
       printf( "\n" );
     }
@@ -0,0 +1,193 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#include "config.h"
+
+#include "allocstats.h"
+
+#ifdef USE_ALLOC_STATS
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace AllocStats {
+
+Counters counters[ NUM_SUBSYSTEMS ];
+Subsystem current_subsystem = SUBSYS_OTHER;
+
+static const char *subsystem_names[ NUM_SUBSYSTEMS ] = {
+  "other", "terminal", "statesync", "network", "crypto"
+};
+
+/* Every accounted block carries this prefix so the free side knows
+   its size and original tag. */
+struct BlockHeader {
+  uint64_t magic_and_tag; /* magic in the high bits, subsystem in the low byte */
+  uint64_t size;
+};
+
+static const uint64_t HEADER_MAGIC = 0x6d6f73684d454d00ULL; /* "moshMEM\0" */
+
+static void *account_alloc( size_t size )
+{
+  void *block = malloc( size + sizeof( BlockHeader ) );
+  if ( !block ) {
+    return NULL;
+  }
+
+  BlockHeader *header = (BlockHeader *)block;
+  header->magic_and_tag = HEADER_MAGIC | (uint64_t)current_subsystem;
+  header->size = size;
+
+  Counters &c = counters[ current_subsystem ];
+  c.alloc_count++;
+  c.bytes_allocated += size;
+  c.live_bytes += size;
+  if ( c.live_bytes > c.peak_live_bytes ) {
+    c.peak_live_bytes = c.live_bytes;
+  }
+
+  return (char *)block + sizeof( BlockHeader );
+}
+
+static void account_free( void *ptr )
+{
+  if ( !ptr ) {
+    return;
+  }
+
+  BlockHeader *header = (BlockHeader *)( (char *)ptr - sizeof( BlockHeader ) );
+  if ( ( header->magic_and_tag & ~(uint64_t)0xff ) != HEADER_MAGIC ) {
+    /* not one of ours; don't guess at a header */
+    free( ptr );
+    return;
+  }
+
+  unsigned int tag = (unsigned int)( header->magic_and_tag & 0xff );
+  if ( tag >= NUM_SUBSYSTEMS ) {
+    tag = SUBSYS_OTHER;
+  }
+
+  Counters &c = counters[ tag ];
+  c.free_count++;
+  c.bytes_freed += header->size;
+  c.live_bytes -= header->size;
+
+  free( header );
+}
+
+void dump( void )
+{
+  FILE *out = stderr;
+  FILE *opened = NULL;
+  const char *path = getenv( "MOSH_LATENCY_LOG" );
+  if ( path ) {
+    opened = fopen( path, "a" );
+    if ( opened ) {
+      out = opened;
+    }
+  }
+
+  fprintf( out, "mosh allocation accounts (bytes):\n" );
+  for ( int s = 0; s < NUM_SUBSYSTEMS; s++ ) {
+    const Counters &c = counters[ s ];
+    fprintf( out, "  %-10s live=%llu peak=%llu allocs=%llu frees=%llu allocated=%llu freed=%llu\n",
+	     subsystem_names[ s ],
+	     (unsigned long long) c.live_bytes,
+	     (unsigned long long) c.peak_live_bytes,
+	     (unsigned long long) c.alloc_count,
+	     (unsigned long long) c.free_count,
+	     (unsigned long long) c.bytes_allocated,
+	     (unsigned long long) c.bytes_freed );
+  }
+
+  if ( opened ) {
+    fclose( opened );
+  } else {
+    fflush( out );
+  }
+}
+
+}
+
+/* Global replacements: every new in the process lands here, so
+   operator delete always sees an accounted block. */
+void *operator new( size_t size )
+{
+  void *ptr = AllocStats::account_alloc( size );
+  if ( !ptr ) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *operator new[]( size_t size )
+{
+  void *ptr = AllocStats::account_alloc( size );
+  if ( !ptr ) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *operator new( size_t size, const std::nothrow_t & ) throw()
+{
+  return AllocStats::account_alloc( size );
+}
+
+void *operator new[]( size_t size, const std::nothrow_t & ) throw()
+{
+  return AllocStats::account_alloc( size );
+}
+
+void operator delete( void *ptr ) throw()
+{
+  AllocStats::account_free( ptr );
+}
+
+void operator delete[]( void *ptr ) throw()
+{
+  AllocStats::account_free( ptr );
+}
+
+void operator delete( void *ptr, const std::nothrow_t & ) throw()
+{
+  AllocStats::account_free( ptr );
+}
+
+void operator delete[]( void *ptr, const std::nothrow_t & ) throw()
+{
+  AllocStats::account_free( ptr );
+}
+
+#endif /* USE_ALLOC_STATS */
@@ -0,0 +1,111 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#ifndef ALLOC_STATS_HPP
+#define ALLOC_STATS_HPP
+
+#include "config.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Optional per-subsystem heap accounting (configure
+   --enable-alloc-stats).  Replacement operator new prepends a small
+   header tagging each block with the subsystem whose scope was active
+   at allocation time, so operator delete debits the right account no
+   matter where the free happens.  Dumped alongside the latency
+   histograms on SIGUSR2.  Without the configure flag, ScopeTag and
+   dump() compile to nothing. */
+
+namespace AllocStats {
+
+  enum Subsystem {
+    SUBSYS_OTHER = 0, /* anything outside a tagged scope */
+    SUBSYS_TERMINAL,  /* parser + framebuffer */
+    SUBSYS_STATESYNC, /* state copies and protobuf diffs */
+    SUBSYS_NETWORK,
+    SUBSYS_CRYPTO,
+    NUM_SUBSYSTEMS
+  };
+
+  struct Counters {
+    uint64_t alloc_count;
+    uint64_t free_count;
+    uint64_t bytes_allocated;
+    uint64_t bytes_freed;
+    uint64_t live_bytes;
+    uint64_t peak_live_bytes;
+  };
+
+#ifdef USE_ALLOC_STATS
+
+  extern Counters counters[ NUM_SUBSYSTEMS ];
+  extern Subsystem current_subsystem;
+
+  /* Scoped tag: charges allocations in the enclosing block to one
+     subsystem.  Nests; the previous tag is restored on exit. */
+  class ScopeTag {
+  private:
+    Subsystem saved;
+
+  public:
+    ScopeTag( Subsystem subsystem )
+      : saved( current_subsystem )
+    {
+      current_subsystem = subsystem;
+    }
+    ~ScopeTag()
+    {
+      current_subsystem = saved;
+    }
+
+    /* unused */
+    ScopeTag( const ScopeTag & );
+    ScopeTag & operator=( const ScopeTag & );
+  };
+
+  void dump( void );
+
+#else
+
+  class ScopeTag {
+  public:
+    ScopeTag( Subsystem ) {}
+  };
+
+  inline void dump( void ) {}
+
+#endif
+
+}
+
+#endif
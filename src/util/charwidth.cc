@@ -0,0 +1,66 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#include <stdint.h>
+
+#include "charwidth.h"
+
+int chwidth( wchar_t ch )
+{
+  const uint32_t c = ch;
+
+  /* printing ASCII?  Cheat. */
+  if ( (c >= 0x20) && (c < 0x7f) ) {
+    return 1;
+  }
+
+  if ( c < 0x20 ) { /* control character */
+    return -1;
+  }
+
+  if ( c < 0x10000 ) {
+    /* Entries hold wcwidth() + 2 so that zero means "not yet asked";
+       widths only range from -1 to 2.  The table is filled on demand
+       rather than generated ahead of time, which keeps us in exact
+       agreement with whatever Unicode version the host libc has. */
+    static int8_t widths[ 0x10000 ]; /* zero-initialized */
+
+    int8_t &entry = widths[ c ];
+    if ( entry == 0 ) {
+      entry = wcwidth( ch ) + 2;
+    }
+    return entry - 2;
+  }
+
+  /* astral planes are rare enough to ask libc every time */
+  return wcwidth( ch );
+}
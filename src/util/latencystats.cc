@@ -0,0 +1,123 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#include "config.h"
+
+#include "latencystats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if HAVE_CLOCK_GETTIME
+#include <time.h>
+#endif
+#if HAVE_GETTIMEOFDAY
+#include <sys/time.h>
+#endif
+
+namespace LatencyStats {
+
+Histogram histograms[ NUM_STAGES ];
+
+static const char *stage_names[ NUM_STAGES ] = {
+  "recv", "decrypt", "apply", "act", "diff", "encrypt", "send"
+};
+
+uint64_t now_ns( void )
+{
+#if HAVE_CLOCK_GETTIME
+  struct timespec tp;
+  if ( clock_gettime( CLOCK_MONOTONIC, &tp ) == 0 ) {
+    return uint64_t( tp.tv_sec ) * 1000000000 + tp.tv_nsec;
+  }
+#endif
+#if HAVE_GETTIMEOFDAY
+  struct timeval tv;
+  if ( gettimeofday( &tv, NULL ) == 0 ) {
+    return uint64_t( tv.tv_sec ) * 1000000000 + uint64_t( tv.tv_usec ) * 1000;
+  }
+#endif
+  return 0;
+}
+
+uint64_t Histogram::percentile_ns( double p ) const
+{
+  if ( count == 0 ) {
+    return 0;
+  }
+  const uint64_t target = uint64_t( p * count );
+  uint64_t seen = 0;
+  for ( unsigned int b = 0; b < sizeof( buckets ) / sizeof( buckets[ 0 ] ); b++ ) {
+    seen += buckets[ b ];
+    if ( seen > target ) {
+      return uint64_t( 1 ) << ( b + 1 ); /* bucket upper bound */
+    }
+  }
+  return max_ns;
+}
+
+void dump( void )
+{
+  FILE *out = stderr;
+  FILE *opened = NULL;
+  const char *path = getenv( "MOSH_LATENCY_LOG" );
+  if ( path ) {
+    opened = fopen( path, "a" );
+    if ( opened ) {
+      out = opened;
+    }
+  }
+
+  fprintf( out, "mosh latency histograms (ns):\n" );
+  for ( int s = 0; s < NUM_STAGES; s++ ) {
+    const Histogram &h = histograms[ s ];
+    if ( h.count == 0 ) {
+      fprintf( out, "  %-8s n=0\n", stage_names[ s ] );
+      continue;
+    }
+    fprintf( out, "  %-8s n=%llu mean=%llu p50<%llu p99<%llu max=%llu\n",
+	     stage_names[ s ],
+	     (unsigned long long) h.count,
+	     (unsigned long long) ( h.sum_ns / h.count ),
+	     (unsigned long long) h.percentile_ns( 0.50 ),
+	     (unsigned long long) h.percentile_ns( 0.99 ),
+	     (unsigned long long) h.max_ns );
+  }
+
+  if ( opened ) {
+    fclose( opened );
+  } else {
+    fflush( out );
+  }
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#ifndef LATENCY_STATS_HPP
+#define LATENCY_STATS_HPP
+
+#include <stdint.h>
+
+/* Always-on instrumentation of the datagram hot path.  Each stage
+   accumulates durations into a log2-bucketed histogram of nanoseconds;
+   recording is a clock read and a few increments, so it stays on in
+   production.  SIGUSR2 (handled in the main loops, not in the signal
+   handler) dumps a summary to MOSH_LATENCY_LOG, or stderr if unset. */
+
+namespace LatencyStats {
+
+  enum Stage {
+    STAGE_RECV = 0, /* Connection::recv, includes decrypt */
+    STAGE_DECRYPT,
+    STAGE_APPLY,    /* apply_string of an incoming diff */
+    STAGE_ACT,      /* Complete::act on host output */
+    STAGE_DIFF,     /* diff_from against the assumed receiver state */
+    STAGE_ENCRYPT,
+    STAGE_SEND,     /* Connection::send, includes encrypt */
+    NUM_STAGES
+  };
+
+  class Histogram {
+  public:
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint64_t buckets[ 64 ]; /* bucket b holds durations in [2^b, 2^(b+1)) ns */
+
+    Histogram()
+      : count( 0 ), sum_ns( 0 ), max_ns( 0 ), buckets()
+    {}
+
+    void record( uint64_t ns )
+    {
+      count++;
+      sum_ns += ns;
+      if ( ns > max_ns ) {
+	max_ns = ns;
+      }
+      unsigned int b = 0;
+      while ( ns >>= 1 ) {
+	b++;
+      }
+      buckets[ b ]++;
+    }
+
+    /* upper bound of the bucket holding the p-th percentile sample */
+    uint64_t percentile_ns( double p ) const;
+  };
+
+  extern Histogram histograms[ NUM_STAGES ];
+
+  uint64_t now_ns( void );
+
+  /* Scoped timer: charges the enclosing block to one stage. */
+  class StageTimer {
+  private:
+    Stage stage;
+    uint64_t start;
+
+  public:
+    StageTimer( Stage s_stage )
+      : stage( s_stage ), start( now_ns() )
+    {}
+    ~StageTimer()
+    {
+      histograms[ stage ].record( now_ns() - start );
+    }
+
+    /* unused */
+    StageTimer( const StageTimer & );
+    StageTimer & operator=( const StageTimer & );
+  };
+
+  void dump( void );
+}
+
+#endif
@@ -39,11 +39,33 @@
 #include <sys/select.h>
 #include <assert.h>
 
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_EPOLL_PWAIT) && defined(HAVE_EPOLL_CREATE1)
+#include <sys/epoll.h>
+#define SELECT_USE_EPOLL 1
+#endif
+
+#include "uringpoll.h"
+#ifdef URING_POLL_AVAILABLE
+#include <poll.h>
+#define SELECT_USE_URING 1
+#endif
+
 #include "fatal_assert.h"
 #include "timestamp.h"
 
 /* Convenience wrapper for pselect(2).
 
+   On Linux the wait itself prefers an io_uring with poll
+   registrations that persist until they fire: re-arms, the
+   signal-masked wait, and the timeout all ride in a single
+   io_uring_enter() per iteration, and completions are reaped from the
+   shared ring without any syscall.  Kernels without a usable ring use
+   epoll_pwait(2) with persistent registrations instead: the fd sets
+   rarely change between iterations, so the per-tick epoll_ctl traffic
+   is zero and the wait cost no longer scales with max_fd.  The
+   pselect() path remains for other platforms and for fds the others
+   cannot watch (e.g. regular files).
+
    Any signals blocked by calling sigprocmask() outside this code will still be
    received during Select::select().  So don't do that. */
 
@@ -62,11 +84,37 @@ private:
        here to appease -Weffc++. */
     , all_fds( dummy_fd_set )
     , read_fds( dummy_fd_set )
+    , all_write_fds( dummy_fd_set )
+    , write_fds( dummy_fd_set )
+#ifdef SELECT_USE_EPOLL
+    , registered_fds( dummy_fd_set )
+    , registered_write_fds( dummy_fd_set )
+    , epfd( epoll_create1( EPOLL_CLOEXEC ) )
+    , epoll_ok( false )
+#endif
+#ifdef SELECT_USE_URING
+    , uring()
+    , uring_fds( dummy_fd_set )
+    , uring_write_fds( dummy_fd_set )
+    , uring_ok( false )
+#endif
     , empty_sigset( dummy_sigset )
     , consecutive_polls( 0 )
   {
     FD_ZERO( &all_fds );
     FD_ZERO( &read_fds );
+    FD_ZERO( &all_write_fds );
+    FD_ZERO( &write_fds );
+#ifdef SELECT_USE_EPOLL
+    FD_ZERO( &registered_fds );
+    FD_ZERO( &registered_write_fds );
+    epoll_ok = ( epfd >= 0 );
+#endif
+#ifdef SELECT_USE_URING
+    FD_ZERO( &uring_fds );
+    FD_ZERO( &uring_write_fds );
+    uring_ok = uring.ok();
+#endif
 
     clear_got_signal();
     fatal_assert( 0 == sigemptyset( &empty_sigset ) );
@@ -94,9 +142,20 @@ public:
     FD_SET( fd, &all_fds );
   }
 
+  /* wake when fd will accept a write (e.g. a host pty whose
+     foreground process has stopped reading) */
+  void add_write_fd( int fd )
+  {
+    if ( fd > max_fd ) {
+      max_fd = fd;
+    }
+    FD_SET( fd, &all_write_fds );
+  }
+
   void clear_fds( void )
   {
     FD_ZERO( &all_fds );
+    FD_ZERO( &all_write_fds );
   }
 
   static void add_signal( int signum )
@@ -119,27 +178,11 @@ public:
     fatal_assert( 0 == sigaction( signum, &sa, NULL ) );
   }
 
-  /* timeout unit: milliseconds; negative timeout means wait forever */
-  int select( int timeout )
+private:
+  int select_pselect( int timeout )
   {
     memcpy( &read_fds,  &all_fds, sizeof( read_fds  ) );
-    clear_got_signal();
-
-    /* Rate-limit and warn about polls. */
-    if ( verbose > 1 && timeout == 0 ) {
-      fprintf( stderr, "%s: got poll (timeout 0)\n", __func__ );
-    }
-    if ( timeout == 0 && ++consecutive_polls >= MAX_POLLS ) {
-      if ( verbose > 1 && consecutive_polls == MAX_POLLS ) {
-	fprintf( stderr, "%s: got %d polls, rate limiting.\n", __func__, MAX_POLLS );
-      }
-      timeout = 1;
-    } else if ( timeout != 0 && consecutive_polls ) {
-      if ( verbose > 1 && consecutive_polls >= MAX_POLLS ) {
-	fprintf( stderr, "%s: got %d consecutive polls\n", __func__, consecutive_polls );
-      }
-      consecutive_polls = 0;
-    }
+    memcpy( &write_fds, &all_write_fds, sizeof( write_fds ) );
 
 #ifdef HAVE_PSELECT
     struct timespec ts;
@@ -151,7 +194,7 @@ public:
       tsp = &ts;
     }
 
-    int ret = ::pselect( max_fd + 1, &read_fds, NULL, NULL, tsp, &empty_sigset );
+    int ret = ::pselect( max_fd + 1, &read_fds, &write_fds, NULL, tsp, &empty_sigset );
 #else
     struct timeval tv;
     struct timeval *tvp = NULL;
@@ -165,20 +208,211 @@ public:
 
     int ret = sigprocmask( SIG_SETMASK, &empty_sigset, &old_sigset );
     if ( ret != -1 ) {
-      ret = ::select( max_fd + 1, &read_fds, NULL, NULL, tvp );
+      ret = ::select( max_fd + 1, &read_fds, &write_fds, NULL, tvp );
       sigprocmask( SIG_SETMASK, &old_sigset, NULL );
     }
 #endif
 
-    if ( ret == 0 || ( ret == -1 && errno == EINTR ) ) {
+    if ( ret == 0 ) {
       /* Look for and report Cygwin select() bug. */
-      if ( ret == 0 ) {
-	for ( int fd = 0; fd <= max_fd; fd++ ) {
-	  if ( FD_ISSET( fd, &read_fds ) ) {
-	    fprintf( stderr, "select(): nfds = 0 but read fd %d is set\n", fd );
+      for ( int fd = 0; fd <= max_fd; fd++ ) {
+	if ( FD_ISSET( fd, &read_fds ) ) {
+	  fprintf( stderr, "select(): nfds = 0 but read fd %d is set\n", fd );
+	}
+      }
+      FD_ZERO( &read_fds );
+      FD_ZERO( &write_fds );
+    }
+
+    return ret;
+  }
+
+#ifdef SELECT_USE_URING
+  int select_uring( int timeout )
+  {
+    /* Reconcile the ring's registrations with what the caller asked
+       for, as in the epoll path; normally a single memcmp.  A changed
+       interest set means cancel-and-rearm, since an armed poll keeps
+       its original mask. */
+    if ( ( memcmp( &all_fds, &uring_fds, sizeof( all_fds ) ) != 0 )
+	 || ( memcmp( &all_write_fds, &uring_write_fds, sizeof( all_write_fds ) ) != 0 ) ) {
+      for ( int fd = 0; fd <= max_fd; fd++ ) {
+	const bool want_read = FD_ISSET( fd, &all_fds );
+	const bool want_write = FD_ISSET( fd, &all_write_fds );
+	const bool reg_read = FD_ISSET( fd, &uring_fds );
+	const bool reg_write = FD_ISSET( fd, &uring_write_fds );
+	if ( ( want_read == reg_read ) && ( want_write == reg_write ) ) {
+	  continue;
+	}
+	if ( reg_read || reg_write ) {
+	  if ( !uring.disarm( fd ) ) {
+	    uring_ok = false;
+	    return 0;
 	  }
 	}
+	if ( ( want_read || want_write )
+	     && !uring.arm( fd, want_read, want_write ) ) {
+	  uring_ok = false;
+	  return 0;
+	}
+	want_read ? FD_SET( fd, &uring_fds ) : FD_CLR( fd, &uring_fds );
+	want_write ? FD_SET( fd, &uring_write_fds ) : FD_CLR( fd, &uring_write_fds );
+      }
+    }
+
+    int nev = uring.wait( timeout, &empty_sigset );
+    if ( nev < 0 ) {
+      if ( errno == EINTR ) {
+	return -1;
+      }
+      uring_ok = false; /* unusable ring: wait some other way */
+      return 0;
+    }
+
+    FD_ZERO( &read_fds );
+    FD_ZERO( &write_fds );
+    int ready = 0;
+    for ( int i = 0; i < nev; i++ ) {
+      const UringPoll::Event &ev = uring.events[ i ];
+      if ( ev.res < 0 ) {
+	/* the ring can't poll this fd: wait some other way */
+	uring_ok = false;
+	return 0;
+      }
+      /* report errors and hangups on both sets, matching select() */
+      if ( ( ev.res & ( POLLIN | POLLERR | POLLHUP ) )
+	   && FD_ISSET( ev.fd, &all_fds ) ) {
+	FD_SET( ev.fd, &read_fds );
+	ready++;
+      }
+      if ( ( ev.res & ( POLLOUT | POLLERR | POLLHUP ) )
+	   && FD_ISSET( ev.fd, &all_write_fds ) ) {
+	FD_SET( ev.fd, &write_fds );
+	ready++;
+      }
+      if ( !ev.more ) {
+	/* the oneshot registration fired; rearm next time around */
+	FD_CLR( ev.fd, &uring_fds );
+	FD_CLR( ev.fd, &uring_write_fds );
       }
+    }
+
+    return ready;
+  }
+#endif
+
+#ifdef SELECT_USE_EPOLL
+  int select_epoll( int timeout )
+  {
+    /* Lazily reconcile the registrations with what the caller asked
+       for this iteration; the sets almost never change, so this is
+       normally a single memcmp. */
+    if ( ( memcmp( &all_fds, &registered_fds, sizeof( all_fds ) ) != 0 )
+	 || ( memcmp( &all_write_fds, &registered_write_fds, sizeof( all_write_fds ) ) != 0 ) ) {
+      for ( int fd = 0; fd <= max_fd; fd++ ) {
+	const bool want_read = FD_ISSET( fd, &all_fds );
+	const bool want_write = FD_ISSET( fd, &all_write_fds );
+	const bool reg_read = FD_ISSET( fd, &registered_fds );
+	const bool reg_write = FD_ISSET( fd, &registered_write_fds );
+	if ( ( want_read == reg_read ) && ( want_write == reg_write ) ) {
+	  continue;
+	}
+	if ( !want_read && !want_write ) {
+	  /* a closed fd has already dropped out of the epoll set */
+	  if ( ( epoll_ctl( epfd, EPOLL_CTL_DEL, fd, NULL ) == 0 )
+	       || ( errno == EBADF ) || ( errno == ENOENT ) ) {
+	    FD_CLR( fd, &registered_fds );
+	    FD_CLR( fd, &registered_write_fds );
+	  }
+	  continue;
+	}
+	struct epoll_event ev;
+	memset( &ev, 0, sizeof ev );
+	ev.events = ( want_read ? EPOLLIN : 0 ) | ( want_write ? EPOLLOUT : 0 );
+	ev.data.fd = fd;
+	int op = ( reg_read || reg_write ) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+	int rc = epoll_ctl( epfd, op, fd, &ev );
+	if ( ( rc < 0 ) && ( op == EPOLL_CTL_MOD ) && ( errno == ENOENT ) ) {
+	  /* the fd was closed and reopened since it was registered */
+	  rc = epoll_ctl( epfd, EPOLL_CTL_ADD, fd, &ev );
+	}
+	if ( rc == 0 ) {
+	  want_read ? FD_SET( fd, &registered_fds ) : FD_CLR( fd, &registered_fds );
+	  want_write ? FD_SET( fd, &registered_write_fds ) : FD_CLR( fd, &registered_write_fds );
+	} else {
+	  /* e.g. a regular file: epoll can't watch it, so fall back
+	     to pselect() for the rest of the process's life */
+	  epoll_ok = false;
+	  return 0;
+	}
+      }
+    }
+
+    struct epoll_event events[ 16 ];
+    int nfds = ::epoll_pwait( epfd, events, 16,
+			      ( timeout >= 0 ) ? timeout : -1,
+			      &empty_sigset );
+
+    FD_ZERO( &read_fds );
+    FD_ZERO( &write_fds );
+    for ( int i = 0; i < nfds; i++ ) {
+      /* report errors and hangups on both sets, matching select() */
+      const int fd = events[ i ].data.fd;
+      if ( ( events[ i ].events & ( EPOLLIN | EPOLLERR | EPOLLHUP ) )
+	   && FD_ISSET( fd, &all_fds ) ) {
+	FD_SET( fd, &read_fds );
+      }
+      if ( ( events[ i ].events & ( EPOLLOUT | EPOLLERR | EPOLLHUP ) )
+	   && FD_ISSET( fd, &all_write_fds ) ) {
+	FD_SET( fd, &write_fds );
+      }
+    }
+
+    return nfds;
+  }
+#endif
+
+public:
+  /* timeout unit: milliseconds; negative timeout means wait forever */
+  int select( int timeout )
+  {
+    clear_got_signal();
+
+    /* Rate-limit and warn about polls. */
+    if ( verbose > 1 && timeout == 0 ) {
+      fprintf( stderr, "%s: got poll (timeout 0)\n", __func__ );
+    }
+    if ( timeout == 0 && ++consecutive_polls >= MAX_POLLS ) {
+      if ( verbose > 1 && consecutive_polls == MAX_POLLS ) {
+	fprintf( stderr, "%s: got %d polls, rate limiting.\n", __func__, MAX_POLLS );
+      }
+      timeout = 1;
+    } else if ( timeout != 0 && consecutive_polls ) {
+      if ( verbose > 1 && consecutive_polls >= MAX_POLLS ) {
+	fprintf( stderr, "%s: got %d consecutive polls\n", __func__, consecutive_polls );
+      }
+      consecutive_polls = 0;
+    }
+
+    int ret = -1;
+    bool waited = false;
+#ifdef SELECT_USE_URING
+    if ( uring_ok ) {
+      ret = select_uring( timeout );
+      waited = uring_ok;
+    }
+#endif
+#ifdef SELECT_USE_EPOLL
+    if ( !waited && epoll_ok ) {
+      ret = select_epoll( timeout );
+      waited = epoll_ok;
+    }
+#endif
+    if ( !waited ) { /* no backend, or a registration just failed */
+      ret = select_pselect( timeout );
+    }
+
+    if ( ret == -1 && errno == EINTR ) {
       /* The user should process events as usual. */
       FD_ZERO( &read_fds );
       ret = 0;
@@ -198,6 +432,15 @@ public:
     return FD_ISSET( fd, &read_fds );
   }
 
+  bool write( int fd )
+#if FD_ISSET_IS_CONST
+    const
+#endif
+  {
+    assert( FD_ISSET( fd, &all_write_fds ) );
+    return FD_ISSET( fd, &write_fds );
+  }
+
   /* This method consumes a signal notification. */
   bool signal( int signum )
   {
@@ -236,6 +479,21 @@ private:
   volatile sig_atomic_t got_signal[ MAX_SIGNAL_NUMBER + 1 ];
 
   fd_set all_fds, read_fds;
+  fd_set all_write_fds, write_fds;
+
+#ifdef SELECT_USE_EPOLL
+  fd_set registered_fds; /* what the epoll set currently contains */
+  fd_set registered_write_fds;
+  int epfd;
+  bool epoll_ok; /* cleared for good if epoll can't watch an fd */
+#endif
+
+#ifdef SELECT_USE_URING
+  UringPoll uring;
+  fd_set uring_fds; /* what the ring currently watches */
+  fd_set uring_write_fds;
+  bool uring_ok; /* cleared for good if the ring can't be used */
+#endif
 
   sigset_t empty_sigset;
 
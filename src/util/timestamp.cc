@@ -78,6 +78,27 @@ void freeze_timestamp( void )
   // adjusted after system sleep
   struct timespec tp;
 
+#if defined(CLOCK_MONOTONIC_COARSE)
+  // The coarse clock is a plain read of a value the kernel updates
+  // every tick-- no hardware counter access, which matters on ARM
+  // where the full clock_gettime() is comparatively expensive.  We
+  // only keep milliseconds, so use it whenever its resolution is at
+  // least that fine.
+  static int use_coarse = -1;
+  if ( use_coarse == -1 ) {
+    struct timespec res;
+    use_coarse = ( clock_getres( CLOCK_MONOTONIC_COARSE, &res ) == 0 )
+      && ( res.tv_sec == 0 ) && ( res.tv_nsec <= 1000000 );
+  }
+  if ( use_coarse && clock_gettime( CLOCK_MONOTONIC_COARSE, &tp ) == 0 ) {
+    uint64_t millis = tp.tv_nsec / 1000000;
+    millis += uint64_t( tp.tv_sec ) * 1000;
+
+    millis_cache = millis;
+    return;
+  }
+#endif
+
   if (
 #if defined(__APPLE__) && defined(__MACH__)
       // Check for presence, for OS X SDK >= 10.12 and runtime < 10.12
@@ -0,0 +1,113 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#include "config.h"
+
+#include "transportstats.h"
+
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace TransportStats {
+
+Counters counters;
+
+/* Per-path RTT aggregates.  A handful of fds at most (the hopping
+   socket plus one per local interface), so a map lookup per RTT
+   sample is cheap. */
+class PathRTT {
+public:
+  uint64_t samples;
+  double smoothed_ms;
+  double max_ms;
+  PathRTT() : samples( 0 ), smoothed_ms( 0 ), max_ms( 0 ) {}
+};
+
+static std::map< int, PathRTT > path_rtts;
+
+void record_rtt( int path_fd, double R_ms )
+{
+  PathRTT &path = path_rtts[ path_fd ];
+  if ( path.samples == 0 ) {
+    path.smoothed_ms = R_ms;
+  } else {
+    path.smoothed_ms = ( 1 - 1.0 / 8.0 ) * path.smoothed_ms + ( 1.0 / 8.0 ) * R_ms;
+  }
+  if ( R_ms > path.max_ms ) {
+    path.max_ms = R_ms;
+  }
+  path.samples++;
+}
+
+void dump( void )
+{
+  FILE *out = stderr;
+  FILE *opened = NULL;
+  const char *path = getenv( "MOSH_TRANSPORT_LOG" );
+  if ( path ) {
+    opened = fopen( path, "a" );
+    if ( opened ) {
+      out = opened;
+    }
+  }
+
+  fprintf( out, "mosh transport counters:\n" );
+  fprintf( out, "  sent=%llu sent_bytes=%llu received=%llu received_bytes=%llu\n",
+	   (unsigned long long) counters.packets_sent,
+	   (unsigned long long) counters.bytes_sent,
+	   (unsigned long long) counters.packets_received,
+	   (unsigned long long) counters.bytes_received );
+  fprintf( out, "  lost=%llu late=%llu ecn=%llu frag_recovered=%llu frag_abandoned=%llu\n",
+	   (unsigned long long) counters.packets_lost,
+	   (unsigned long long) counters.packets_late,
+	   (unsigned long long) counters.ecn_marks,
+	   (unsigned long long) counters.fragments_recovered,
+	   (unsigned long long) counters.assemblies_abandoned );
+  for ( std::map< int, PathRTT >::const_iterator i = path_rtts.begin();
+	i != path_rtts.end();
+	i++ ) {
+    fprintf( out, "  path fd=%d rtt_n=%llu rtt_srtt_ms=%.1f rtt_max_ms=%.1f\n",
+	     i->first,
+	     (unsigned long long) i->second.samples,
+	     i->second.smoothed_ms,
+	     i->second.max_ms );
+  }
+
+  if ( opened ) {
+    fclose( opened );
+  } else {
+    fflush( out );
+  }
+}
+
+}
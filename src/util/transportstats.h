@@ -0,0 +1,77 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#ifndef TRANSPORT_STATS_HPP
+#define TRANSPORT_STATS_HPP
+
+#include <stdint.h>
+
+/* Always-on link-quality counters for the datagram layer: packets and
+   bytes in each direction, losses inferred from gaps in the receive
+   sequence space, ECN marks, parity recoveries, and per-path RTT
+   samples.  Each event is a few integer increments, so the counters
+   stay on in production.  SIGUSR2 (handled in the main loops, next to
+   the latency histograms) dumps one machine-readable block to
+   MOSH_TRANSPORT_LOG, or stderr if unset. */
+
+namespace TransportStats {
+
+  class Counters {
+  public:
+    uint64_t packets_sent;
+    uint64_t bytes_sent;
+    uint64_t packets_received;
+    uint64_t bytes_received;
+    uint64_t packets_lost;          /* gaps in the incoming sequence numbers */
+    uint64_t packets_late;          /* arrived behind the replay window */
+    uint64_t ecn_marks;             /* datagrams marked congestion-experienced */
+    uint64_t fragments_recovered;   /* data fragments rebuilt from parity */
+    uint64_t assemblies_abandoned;  /* incomplete instructions displaced by a newer id */
+
+    Counters()
+      : packets_sent( 0 ), bytes_sent( 0 ),
+	packets_received( 0 ), bytes_received( 0 ),
+	packets_lost( 0 ), packets_late( 0 ), ecn_marks( 0 ),
+	fragments_recovered( 0 ), assemblies_abandoned( 0 )
+    {}
+  };
+
+  extern Counters counters;
+
+  /* One RTT observation on the path that delivered the reply,
+     keyed by receiving socket fd. */
+  void record_rtt( int path_fd, double R_ms );
+
+  void dump( void );
+}
+
+#endif
@@ -0,0 +1,320 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#include "config.h"
+
+#include "uringpoll.h"
+
+#ifdef URING_POLL_AVAILABLE
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* user_data layout: fd in the low 32 bits, generation above, and a
+   marker bit for the cancellation requests themselves */
+static const uint64_t REMOVE_MARK = uint64_t( 1 ) << 63;
+
+static uint64_t encode_user_data( int fd, unsigned char gen )
+{
+  return ( uint64_t( gen ) << 32 ) | uint32_t( fd );
+}
+
+UringPoll::UringPoll()
+  : ring_fd( -1 ),
+    ring_ok( false ),
+    sq_ptr( NULL ),
+    sq_map_len( 0 ),
+    cq_ptr( NULL ),
+    cq_map_len( 0 ),
+    sqes( NULL ),
+    sqes_map_len( 0 ),
+    sq_entry_count( 0 ),
+    sq_head( NULL ),
+    sq_tail( NULL ),
+    sq_mask( 0 ),
+    sq_array( NULL ),
+    cq_head( NULL ),
+    cq_tail( NULL ),
+    cq_mask( 0 ),
+    cqes( NULL ),
+    to_submit( 0 ),
+    nevents( 0 )
+{
+  memset( generation, 0, sizeof( generation ) );
+
+  struct io_uring_params params;
+  memset( &params, 0, sizeof( params ) );
+
+  ring_fd = syscall( __NR_io_uring_setup, 64, &params );
+  if ( ring_fd < 0 ) {
+    return; /* kernel or sandbox without io_uring */
+  }
+
+  /* EXT_ARG carries the timeout and sigmask in the wait syscall;
+     NODROP keeps completions from being lost under overflow. */
+  if ( !( params.features & IORING_FEAT_EXT_ARG )
+       || !( params.features & IORING_FEAT_NODROP ) ) {
+    close( ring_fd );
+    ring_fd = -1;
+    return;
+  }
+
+  sq_map_len = params.sq_off.array + params.sq_entries * sizeof( unsigned int );
+  cq_map_len = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe );
+
+  if ( params.features & IORING_FEAT_SINGLE_MMAP ) {
+    if ( cq_map_len > sq_map_len ) {
+      sq_map_len = cq_map_len;
+    }
+    cq_map_len = sq_map_len;
+  }
+
+  sq_ptr = mmap( NULL, sq_map_len, PROT_READ | PROT_WRITE,
+		 MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING );
+  if ( sq_ptr == MAP_FAILED ) {
+    sq_ptr = NULL;
+    close( ring_fd );
+    ring_fd = -1;
+    return;
+  }
+
+  if ( params.features & IORING_FEAT_SINGLE_MMAP ) {
+    cq_ptr = sq_ptr;
+  } else {
+    cq_ptr = mmap( NULL, cq_map_len, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING );
+    if ( cq_ptr == MAP_FAILED ) {
+      cq_ptr = NULL;
+      unmap();
+      close( ring_fd );
+      ring_fd = -1;
+      return;
+    }
+  }
+
+  sqes_map_len = params.sq_entries * sizeof( struct io_uring_sqe );
+  sqes = (struct io_uring_sqe *)mmap( NULL, sqes_map_len,
+				      PROT_READ | PROT_WRITE,
+				      MAP_SHARED | MAP_POPULATE,
+				      ring_fd, IORING_OFF_SQES );
+  if ( sqes == MAP_FAILED ) {
+    sqes = NULL;
+    unmap();
+    close( ring_fd );
+    ring_fd = -1;
+    return;
+  }
+
+  char *sq_base = (char *)sq_ptr;
+  char *cq_base = (char *)cq_ptr;
+
+  sq_entry_count = params.sq_entries;
+  sq_head = (volatile unsigned int *)( sq_base + params.sq_off.head );
+  sq_tail = (volatile unsigned int *)( sq_base + params.sq_off.tail );
+  sq_mask = *(unsigned int *)( sq_base + params.sq_off.ring_mask );
+  sq_array = (unsigned int *)( sq_base + params.sq_off.array );
+  cq_head = (volatile unsigned int *)( cq_base + params.cq_off.head );
+  cq_tail = (volatile unsigned int *)( cq_base + params.cq_off.tail );
+  cq_mask = *(unsigned int *)( cq_base + params.cq_off.ring_mask );
+  cqes = (struct io_uring_cqe *)( cq_base + params.cq_off.cqes );
+
+  ring_ok = true;
+}
+
+void UringPoll::unmap( void )
+{
+  if ( sqes != NULL ) {
+    munmap( sqes, sqes_map_len );
+    sqes = NULL;
+  }
+  if ( ( cq_ptr != NULL ) && ( cq_ptr != sq_ptr ) ) {
+    munmap( cq_ptr, cq_map_len );
+  }
+  cq_ptr = NULL;
+  if ( sq_ptr != NULL ) {
+    munmap( sq_ptr, sq_map_len );
+    sq_ptr = NULL;
+  }
+}
+
+UringPoll::~UringPoll()
+{
+  unmap();
+  if ( ring_fd >= 0 ) {
+    close( ring_fd );
+  }
+}
+
+int UringPoll::enter( unsigned int submit, unsigned int min_complete,
+		      unsigned int flags, void *arg, size_t argsz )
+{
+  return syscall( __NR_io_uring_enter, ring_fd, submit, min_complete,
+		  flags, arg, argsz );
+}
+
+/* Claim the next submission slot, flushing the queue to the kernel if
+   it is full.  Returns NULL only if that flush fails. */
+struct io_uring_sqe *UringPoll::next_sqe( void )
+{
+  if ( to_submit == sq_entry_count ) {
+    int rc = enter( to_submit, 0, 0, NULL, 0 );
+    if ( rc < 0 ) {
+      ring_ok = false;
+      return NULL;
+    }
+    to_submit -= rc;
+    if ( to_submit == sq_entry_count ) {
+      ring_ok = false;
+      return NULL;
+    }
+  }
+
+  unsigned int tail = *sq_tail;
+  unsigned int index = tail & sq_mask;
+  struct io_uring_sqe *sqe = &sqes[ index ];
+  memset( sqe, 0, sizeof( *sqe ) );
+  sq_array[ index ] = index;
+
+  __sync_synchronize(); /* publish the entry before moving the tail */
+  *sq_tail = tail + 1;
+
+  to_submit++;
+  return sqe;
+}
+
+bool UringPoll::arm( int fd, bool want_read, bool want_write )
+{
+  if ( ( fd < 0 ) || ( fd >= FD_SETSIZE ) ) {
+    return false;
+  }
+
+  struct io_uring_sqe *sqe = next_sqe();
+  if ( sqe == NULL ) {
+    return false;
+  }
+
+  generation[ fd ]++;
+
+  /* Oneshot, not multishot: a multishot poll only completes again on
+     a fresh wakeup, so data already buffered when the caller returns
+     to select() would never re-report.  A oneshot re-arm polls the
+     fd's current state, preserving pselect()'s level-triggered
+     semantics. */
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll32_events = ( want_read ? POLLIN : 0 ) | ( want_write ? POLLOUT : 0 );
+  sqe->user_data = encode_user_data( fd, generation[ fd ] );
+
+  return true;
+}
+
+bool UringPoll::disarm( int fd )
+{
+  if ( ( fd < 0 ) || ( fd >= FD_SETSIZE ) ) {
+    return false;
+  }
+
+  struct io_uring_sqe *sqe = next_sqe();
+  if ( sqe == NULL ) {
+    return false;
+  }
+
+  sqe->opcode = IORING_OP_POLL_REMOVE;
+  sqe->fd = -1;
+  sqe->addr = encode_user_data( fd, generation[ fd ] );
+  sqe->user_data = REMOVE_MARK | uint32_t( fd );
+
+  /* anything still in flight from this registration is now stale */
+  generation[ fd ]++;
+
+  return true;
+}
+
+int UringPoll::wait( int timeout_ms, const sigset_t *sigmask )
+{
+  struct io_uring_getevents_arg arg;
+  struct __kernel_timespec ts;
+  memset( &arg, 0, sizeof( arg ) );
+  arg.sigmask = (uint64_t)(uintptr_t)sigmask;
+  arg.sigmask_sz = _NSIG / 8;
+  if ( timeout_ms >= 0 ) {
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = 1000000 * ( long( timeout_ms ) % 1000 );
+    arg.ts = (uint64_t)(uintptr_t)&ts;
+  }
+
+  int rc = enter( to_submit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+		  &arg, sizeof( arg ) );
+  if ( rc >= 0 ) {
+    to_submit -= ( (unsigned int)rc < to_submit ) ? rc : to_submit;
+  } else if ( errno != ETIME ) {
+    return -1; /* including EINTR, handled like pselect's */
+  }
+
+  /* reap completions straight from the shared ring */
+  nevents = 0;
+  unsigned int head = *cq_head;
+  __sync_synchronize();
+  while ( ( head != *cq_tail ) && ( nevents < MAX_EVENTS ) ) {
+    const struct io_uring_cqe *cqe = &cqes[ head & cq_mask ];
+    head++;
+
+    const uint64_t user_data = cqe->user_data;
+    if ( user_data & REMOVE_MARK ) {
+      continue; /* completion of a cancellation request */
+    }
+    const int fd = (int)( user_data & 0xffffffffu );
+    const unsigned char gen = ( user_data >> 32 ) & 0xff;
+    if ( ( fd < 0 ) || ( fd >= FD_SETSIZE )
+	 || ( gen != generation[ fd ] ) ) {
+      continue; /* stale poll on a recycled fd number */
+    }
+    if ( cqe->res == -ECANCELED ) {
+      continue; /* removed at our own request */
+    }
+
+    events[ nevents ].fd = fd;
+    events[ nevents ].res = cqe->res;
+    events[ nevents ].more = ( cqe->flags & IORING_CQE_F_MORE ) != 0;
+    nevents++;
+  }
+  __sync_synchronize();
+  *cq_head = head;
+
+  return nevents;
+}
+
+#endif /* URING_POLL_AVAILABLE */
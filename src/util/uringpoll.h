@@ -0,0 +1,137 @@
+/*
+    Mosh: the mobile shell
+    Copyright 2012 Keith Winstein
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of portions of this program with the
+    OpenSSL library under certain conditions as described in each
+    individual source file, and distribute linked combinations including
+    the two.
+
+    You must obey the GNU General Public License in all respects for all
+    of the code used other than OpenSSL. If you modify file(s) with this
+    exception, you may extend this exception to your version of the
+    file(s), but you are not obligated to do so. If you do not wish to do
+    so, delete this exception statement from your version. If you delete
+    this exception statement from all source files in the program, then
+    also delete it here.
+*/
+
+#ifndef URING_POLL_HPP
+#define URING_POLL_HPP
+
+/* Expects config.h to have been included already. */
+
+#if defined(__linux__) && defined(HAVE_LINUX_IO_URING_H) \
+  && defined(HAVE_STRUCT_IO_URING_SQE_POLL32_EVENTS) \
+  && defined(HAVE_STRUCT_IO_URING_GETEVENTS_ARG)
+#define URING_POLL_AVAILABLE 1
+#endif
+
+#ifdef URING_POLL_AVAILABLE
+
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/select.h>
+
+/* Thin wrapper over a raw io_uring (no liburing dependency) used as a
+   readiness backend by Select.  Each watched fd gets a oneshot
+   POLL_ADD that stays armed until it fires, so the steady state is a
+   single io_uring_enter() per loop iteration: re-arms, the
+   signal-masked wait, and the timeout all ride in that one syscall,
+   and completions are reaped from the shared ring with no syscall at
+   all.
+
+   Kernel support is probed at runtime; when the ring can't be set up
+   (old kernel, seccomp) or misbehaves, the caller falls back to
+   epoll/pselect for the life of the process. */
+
+class UringPoll {
+public:
+  static const int MAX_EVENTS = 64;
+
+  class Event {
+  public:
+    int fd;
+    int res;    /* poll revents, or negative errno */
+    bool more;  /* registration still armed after this completion */
+    Event() : fd( -1 ), res( 0 ), more( false ) {}
+  };
+
+private:
+  int ring_fd;
+  bool ring_ok;
+
+  /* ring mappings */
+  void *sq_ptr;
+  size_t sq_map_len;
+  void *cq_ptr;
+  size_t cq_map_len;
+  struct io_uring_sqe *sqes;
+  size_t sqes_map_len;
+
+  /* ring geometry and shared indices */
+  unsigned int sq_entry_count;
+  volatile unsigned int *sq_head;
+  volatile unsigned int *sq_tail;
+  unsigned int sq_mask;
+  unsigned int *sq_array;
+  volatile unsigned int *cq_head;
+  volatile unsigned int *cq_tail;
+  unsigned int cq_mask;
+  struct io_uring_cqe *cqes;
+
+  unsigned int to_submit; /* queued but not yet passed to the kernel */
+
+  /* Completions are matched to the registration that produced them by
+     a per-fd generation counter in the user_data, so a stale poll on
+     a recycled fd number is ignored rather than misreported. */
+  unsigned char generation[ FD_SETSIZE ];
+
+  struct io_uring_sqe *next_sqe( void );
+  int enter( unsigned int submit, unsigned int min_complete,
+	     unsigned int flags, void *arg, size_t argsz );
+  void unmap( void );
+
+public:
+  int nevents;
+  Event events[ MAX_EVENTS ];
+
+  UringPoll();
+  ~UringPoll();
+
+  bool ok( void ) const { return ring_ok; }
+
+  /* queue a poll registration / cancellation; a failure to queue
+     means the ring is unusable and the caller should fall back */
+  bool arm( int fd, bool want_read, bool want_write );
+  bool disarm( int fd );
+
+  /* submit queued registrations and wait; fills events[0..nevents).
+     Returns the event count, 0 on timeout, or -1 with errno set
+     (EINTR behaves as with pselect). */
+  int wait( int timeout_ms, const sigset_t *sigmask );
+
+  /* not implemented */
+  UringPoll( const UringPoll & );
+  UringPoll &operator=( const UringPoll & );
+};
+
+#endif /* URING_POLL_AVAILABLE */
+
+#endif